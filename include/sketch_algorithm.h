@@ -0,0 +1,1140 @@
+#ifndef SKETCH_STL_ALGORITHM_H
+#define SKETCH_STL_ALGORITHM_H
+
+#include "sketch_bit.h"
+#include "sketch_parallel.h"
+#include "sketch_span.h"
+#include "sketch_string.h"
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/////////////////////////////////////////////////////////////////////////
+// HEAPS
+//
+// The heaps are d-ary: every node has Arity children, stored at positions Arity * i + 1 to Arity * i + Arity.
+// Arity 2 gives the classic binary heap; a wider node makes the tree shallower, and its children share a cache
+// line, so 4-ary heaps usually sift faster. Like in the standard library, the largest element according to
+// comp is at the front. Elements are moved into a hole instead of being swapped
+
+/**
+ * Move a value down from a hole until none of its children is larger
+ * @param first The beginning of the heap
+ * @param len The number of elements in the heap
+ * @param hole The position of the hole
+ * @param value The value to place
+ * @param comp The comparison function
+ */
+template <size_t Arity, typename RandomIt, typename T, typename Compare>
+void heap_sift_down(RandomIt first, ptrdiff_t len, ptrdiff_t hole, T&& value, Compare& comp) {
+    for (;;) {
+        ptrdiff_t child = hole * (ptrdiff_t)Arity + 1;
+        if (child >= len) {
+            break;
+        }
+
+        ptrdiff_t lastChild = child + (ptrdiff_t)Arity < len ? child + (ptrdiff_t)Arity : len;
+        ptrdiff_t largest = child;
+        for (ptrdiff_t i = child + 1; i < lastChild; i++) {
+            if (comp(first[largest], first[i])) {
+                largest = i;
+            }
+        }
+
+        if (!comp(value, first[largest])) {
+            break;
+        }
+
+        first[hole] = std::move(first[largest]);
+        hole = largest;
+    }
+
+    first[hole] = std::move(value);
+}
+
+/**
+ * Move a value up from a hole until its parent is not smaller
+ * @param first The beginning of the heap
+ * @param hole The position of the hole
+ * @param value The value to place
+ * @param comp The comparison function
+ */
+template <size_t Arity, typename RandomIt, typename T, typename Compare>
+void heap_sift_up(RandomIt first, ptrdiff_t hole, T&& value, Compare& comp) {
+    while (hole > 0) {
+        ptrdiff_t parent = (hole - 1) / (ptrdiff_t)Arity;
+        if (!comp(first[parent], value)) {
+            break;
+        }
+
+        first[hole] = std::move(first[parent]);
+        hole = parent;
+    }
+
+    first[hole] = std::move(value);
+}
+
+/**
+ * Arrange a range into a heap, in linear time
+ * @param first The beginning of the range
+ * @param last The end of the range
+ * @param comp The comparison function
+ */
+template <size_t Arity=2, typename RandomIt, typename Compare>
+void make_heap(RandomIt first, RandomIt last, Compare comp) {
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+    typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+
+    ptrdiff_t len = last - first;
+    if (len < 2) {
+        return;
+    }
+
+    for (ptrdiff_t i = (len - 2) / (ptrdiff_t)Arity; i >= 0; i--) {
+        value_type value = std::move(first[i]);
+        SketchStl::heap_sift_down<Arity>(first, len, i, std::move(value), comp);
+    }
+}
+
+template <size_t Arity=2, typename RandomIt>
+void make_heap(RandomIt first, RandomIt last) {
+    SketchStl::make_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Add the last element of a range to the heap made of the elements before it
+ * @param first The beginning of the range
+ * @param last The end of the range, one past the new element
+ * @param comp The comparison function
+ */
+template <size_t Arity=2, typename RandomIt, typename Compare>
+void push_heap(RandomIt first, RandomIt last, Compare comp) {
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+    typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+
+    ptrdiff_t len = last - first;
+    if (len < 2) {
+        return;
+    }
+
+    value_type value = std::move(first[len - 1]);
+    SketchStl::heap_sift_up<Arity>(first, len - 1, std::move(value), comp);
+}
+
+template <size_t Arity=2, typename RandomIt>
+void push_heap(RandomIt first, RandomIt last) {
+    SketchStl::push_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Move the largest element of a heap to the end of its range, and make the other elements a heap again
+ * @param first The beginning of the heap
+ * @param last The end of the heap
+ * @param comp The comparison function
+ */
+template <size_t Arity=2, typename RandomIt, typename Compare>
+void pop_heap(RandomIt first, RandomIt last, Compare comp) {
+    static_assert(Arity >= 2, "A heap node needs at least two children");
+    typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+
+    ptrdiff_t len = last - first;
+    if (len < 2) {
+        return;
+    }
+
+    value_type value = std::move(first[len - 1]);
+    first[len - 1] = std::move(first[0]);
+    SketchStl::heap_sift_down<Arity>(first, len - 1, 0, std::move(value), comp);
+}
+
+template <size_t Arity=2, typename RandomIt>
+void pop_heap(RandomIt first, RandomIt last) {
+    SketchStl::pop_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Tell whether a range is a heap
+ * @param first The beginning of the range
+ * @param last The end of the range
+ * @param comp The comparison function
+ */
+template <size_t Arity=2, typename RandomIt, typename Compare>
+bool is_heap(RandomIt first, RandomIt last, Compare comp) {
+    ptrdiff_t len = last - first;
+    for (ptrdiff_t i = 1; i < len; i++) {
+        if (comp(first[(i - 1) / (ptrdiff_t)Arity], first[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+template <size_t Arity=2, typename RandomIt>
+bool is_heap(RandomIt first, RandomIt last) {
+    return SketchStl::is_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Sort a heap, smallest element first, by popping its elements one after the other
+ * @param first The beginning of the heap
+ * @param last The end of the heap
+ * @param comp The comparison function
+ */
+template <size_t Arity=2, typename RandomIt, typename Compare>
+void sort_heap(RandomIt first, RandomIt last, Compare comp) {
+    for (ptrdiff_t len = last - first; len > 1; len--) {
+        SketchStl::pop_heap<Arity>(first, first + len, comp);
+    }
+}
+
+template <size_t Arity=2, typename RandomIt>
+void sort_heap(RandomIt first, RandomIt last) {
+    SketchStl::sort_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * @class reverse_compare
+ * This class represents a comparison function that orders the elements the other way around, which turns a heap
+ * that keeps its largest element at the front into one that keeps its smallest
+ */
+template <typename Compare>
+struct reverse_compare {
+    explicit reverse_compare(const Compare& comp=Compare()) : comp(comp) {}
+
+    template <typename T, typename U>
+    bool operator()(const T& a, const U& b) const { return comp(b, a); }
+
+    Compare comp;   /**< The comparison function to reverse */
+};
+
+/////////////////////////////////////////////////////////////////////////
+// BINARY SEARCH
+//
+// The searches are branchless: every step halves the range and moves its base with a conditional move instead of
+// a jump, so the loop runs log2(n) times whatever the data and never mispredicts. Only the number of steps
+// depends on the length of the range
+
+/**
+ * Find the first element that is not less than a value
+ * @param first The beginning of the sorted range
+ * @param last The end of the sorted range
+ * @param value The value to look for
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename T, typename Compare>
+RandomIt lower_bound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    ptrdiff_t len = last - first;
+    if (len == 0) {
+        return first;
+    }
+
+    ptrdiff_t base = 0;
+    while (len > 1) {
+        ptrdiff_t half = len / 2;
+        base += comp(first[base + half - 1], value) ? half : 0;
+        len -= half;
+    }
+
+    return first + (base + (comp(first[base], value) ? 1 : 0));
+}
+
+template <typename RandomIt, typename T>
+RandomIt lower_bound(RandomIt first, RandomIt last, const T& value) {
+    return SketchStl::lower_bound(first, last, value, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Find the first element that is greater than a value
+ * @param first The beginning of the sorted range
+ * @param last The end of the sorted range
+ * @param value The value to look for
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename T, typename Compare>
+RandomIt upper_bound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    ptrdiff_t len = last - first;
+    if (len == 0) {
+        return first;
+    }
+
+    ptrdiff_t base = 0;
+    while (len > 1) {
+        ptrdiff_t half = len / 2;
+        base += comp(value, first[base + half - 1]) ? 0 : half;
+        len -= half;
+    }
+
+    return first + (base + (comp(value, first[base]) ? 0 : 1));
+}
+
+template <typename RandomIt, typename T>
+RandomIt upper_bound(RandomIt first, RandomIt last, const T& value) {
+    return SketchStl::upper_bound(first, last, value, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Find the range of the elements equal to a value
+ * @param first The beginning of the sorted range
+ * @param last The end of the sorted range
+ * @param value The value to look for
+ * @param comp The comparison function
+ * @return The lower and the upper bound of the value
+ */
+template <typename RandomIt, typename T, typename Compare>
+std::pair<RandomIt, RandomIt> equal_range(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    RandomIt lower = SketchStl::lower_bound(first, last, value, comp);
+    return std::pair<RandomIt, RandomIt>(lower, SketchStl::upper_bound(lower, last, value, comp));
+}
+
+template <typename RandomIt, typename T>
+std::pair<RandomIt, RandomIt> equal_range(RandomIt first, RandomIt last, const T& value) {
+    return SketchStl::equal_range(first, last, value, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Tell whether a sorted range holds a value
+ * @param first The beginning of the sorted range
+ * @param last The end of the sorted range
+ * @param value The value to look for
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename T, typename Compare>
+bool binary_search(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    RandomIt it = SketchStl::lower_bound(first, last, value, comp);
+    return it != last && !comp(value, *it);
+}
+
+template <typename RandomIt, typename T>
+bool binary_search(RandomIt first, RandomIt last, const T& value) {
+    return SketchStl::binary_search(first, last, value, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/////////////////////////////////////////////////////////////////////////
+// SET OPERATIONS
+//
+// The set operations combine two sorted ranges like the ones of the standard library, duplicates included. When
+// one range is more than set_gallop_ratio times longer than the other, they walk the short one and gallop through
+// the long one: an exponential search from the current position followed by a binary search, which only looks at
+// O(m log(n / m)) elements. Otherwise they merge. The overloads on arrays of uint32_t, meant for sorted lists of
+// IDs, also compare blocks of eight elements against each other with AVX2
+
+static const size_t set_gallop_ratio = 32;
+
+/**
+ * Find the first element that is not less than a value by looking at positions 1, 2, 4, 8... from the beginning
+ * of the range, then searching between the last two. Cheap when the element is near the beginning
+ * @param first The beginning of the sorted range
+ * @param last The end of the sorted range
+ * @param value The value to look for
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename T, typename Compare>
+RandomIt gallop_lower_bound(RandomIt first, RandomIt last, const T& value, Compare comp) {
+    ptrdiff_t len = last - first;
+    ptrdiff_t bound = 1;
+    while (bound < len && comp(first[bound], value)) {
+        bound *= 2;
+    }
+
+    return SketchStl::lower_bound(first + bound / 2, first + (bound + 1 < len ? bound + 1 : len), value, comp);
+}
+
+/**
+ * @class count_iterator
+ * This class represents an output iterator that counts what is written through it instead of storing it
+ */
+class count_iterator {
+    public:
+        /**
+         * Constructor
+         * @param count The counter to increment for every element written
+         */
+        explicit count_iterator(size_t* count) : count_(count) {}
+
+        count_iterator& operator*() { return *this; }
+        count_iterator& operator++() { return *this; }
+        count_iterator operator++(int) { return *this; }
+
+        template <typename T>
+        count_iterator& operator=(const T&) { *count_ += 1; return *this; }
+
+    private:
+        size_t* count_; /**< The counter */
+};
+
+/**
+ * Copy the elements of the first range that are also in the second one
+ * @param first1 The beginning of the first sorted range
+ * @param last1 The end of the first sorted range
+ * @param first2 The beginning of the second sorted range
+ * @param last2 The end of the second sorted range
+ * @param out The beginning of the destination
+ * @param comp The comparison function
+ * @return The end of the destination
+ */
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+OutputIt set_intersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt out, Compare comp) {
+    ptrdiff_t len1 = last1 - first1;
+    ptrdiff_t len2 = last2 - first2;
+
+    if (len2 / (ptrdiff_t)set_gallop_ratio > len1) {
+        for (; first1 != last1; ++first1) {
+            first2 = SketchStl::gallop_lower_bound(first2, last2, *first1, comp);
+            if (first2 == last2) {
+                break;
+            }
+
+            if (!comp(*first1, *first2)) {
+                *out++ = *first1;
+                ++first2;
+            }
+        }
+    } else if (len1 / (ptrdiff_t)set_gallop_ratio > len2) {
+        for (; first2 != last2; ++first2) {
+            first1 = SketchStl::gallop_lower_bound(first1, last1, *first2, comp);
+            if (first1 == last1) {
+                break;
+            }
+
+            if (!comp(*first2, *first1)) {
+                *out++ = *first1;
+                ++first1;
+            }
+        }
+    } else {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                ++first1;
+            } else if (comp(*first2, *first1)) {
+                ++first2;
+            } else {
+                *out++ = *first1;
+                ++first1;
+                ++first2;
+            }
+        }
+    }
+
+    return out;
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt>
+OutputIt set_intersection(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt out) {
+    return SketchStl::set_intersection(first1, last1, first2, last2, out, std::less<typename std::iterator_traits<RandomIt1>::value_type>());
+}
+
+/**
+ * Count the elements of the first range that are also in the second one, without writing them anywhere. The size
+ * of the union is then len1 + len2 minus that count, and the size of the difference len1 minus that count
+ * @param first1 The beginning of the first sorted range
+ * @param last1 The end of the first sorted range
+ * @param first2 The beginning of the second sorted range
+ * @param last2 The end of the second sorted range
+ * @param comp The comparison function
+ */
+template <typename RandomIt1, typename RandomIt2, typename Compare>
+size_t set_intersection_size(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, Compare comp) {
+    size_t count = 0;
+    SketchStl::set_intersection(first1, last1, first2, last2, count_iterator(&count), comp);
+    return count;
+}
+
+template <typename RandomIt1, typename RandomIt2>
+size_t set_intersection_size(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2) {
+    return SketchStl::set_intersection_size(first1, last1, first2, last2, std::less<typename std::iterator_traits<RandomIt1>::value_type>());
+}
+
+/**
+ * Copy the elements that are in either range, in order. An element found in both ranges is copied from the first
+ * @param first1 The beginning of the first sorted range
+ * @param last1 The end of the first sorted range
+ * @param first2 The beginning of the second sorted range
+ * @param last2 The end of the second sorted range
+ * @param out The beginning of the destination
+ * @param comp The comparison function
+ * @return The end of the destination
+ */
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+OutputIt set_union(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt out, Compare comp) {
+    while (first1 != last1 && first2 != last2) {
+        if (comp(*first2, *first1)) {
+            *out++ = *first2;
+            ++first2;
+        } else {
+            if (!comp(*first1, *first2)) {
+                ++first2;
+            }
+            *out++ = *first1;
+            ++first1;
+        }
+    }
+
+    for (; first1 != last1; ++first1) {
+        *out++ = *first1;
+    }
+    for (; first2 != last2; ++first2) {
+        *out++ = *first2;
+    }
+
+    return out;
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt>
+OutputIt set_union(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt out) {
+    return SketchStl::set_union(first1, last1, first2, last2, out, std::less<typename std::iterator_traits<RandomIt1>::value_type>());
+}
+
+/**
+ * Copy the elements of the first range that are not in the second one
+ * @param first1 The beginning of the first sorted range
+ * @param last1 The end of the first sorted range
+ * @param first2 The beginning of the second sorted range
+ * @param last2 The end of the second sorted range
+ * @param out The beginning of the destination
+ * @param comp The comparison function
+ * @return The end of the destination
+ */
+template <typename RandomIt1, typename RandomIt2, typename OutputIt, typename Compare>
+OutputIt set_difference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt out, Compare comp) {
+    ptrdiff_t len1 = last1 - first1;
+    ptrdiff_t len2 = last2 - first2;
+
+    if (len2 / (ptrdiff_t)set_gallop_ratio > len1) {
+        for (; first1 != last1; ++first1) {
+            first2 = SketchStl::gallop_lower_bound(first2, last2, *first1, comp);
+            if (first2 != last2 && !comp(*first1, *first2)) {
+                ++first2;
+            } else {
+                *out++ = *first1;
+            }
+        }
+
+        return out;
+    }
+
+    if (len1 / (ptrdiff_t)set_gallop_ratio > len2) {
+        // Copy the runs of the first range between the elements of the second one
+        for (; first2 != last2; ++first2) {
+            RandomIt1 found = SketchStl::gallop_lower_bound(first1, last1, *first2, comp);
+            for (; first1 != found; ++first1) {
+                *out++ = *first1;
+            }
+
+            if (first1 != last1 && !comp(*first2, *first1)) {
+                ++first1;
+            }
+        }
+    } else {
+        while (first1 != last1 && first2 != last2) {
+            if (comp(*first1, *first2)) {
+                *out++ = *first1;
+                ++first1;
+            } else {
+                if (!comp(*first2, *first1)) {
+                    ++first1;
+                }
+                ++first2;
+            }
+        }
+    }
+
+    for (; first1 != last1; ++first1) {
+        *out++ = *first1;
+    }
+
+    return out;
+}
+
+template <typename RandomIt1, typename RandomIt2, typename OutputIt>
+OutputIt set_difference(RandomIt1 first1, RandomIt1 last1, RandomIt2 first2, RandomIt2 last2, OutputIt out) {
+    return SketchStl::set_difference(first1, last1, first2, last2, out, std::less<typename std::iterator_traits<RandomIt1>::value_type>());
+}
+
+/**
+ * Set operations on sorted lists of IDs. The lists must be strictly increasing
+ * @param a The first list
+ * @param na The length of the first list
+ * @param b The second list
+ * @param nb The length of the second list
+ * @param out Receives the result: up to min(na, nb) values for the intersection, na + nb for the union and na for
+ * the difference. Must not overlap the lists
+ * @return The number of values of the result
+ */
+size_t set_intersection(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+size_t set_intersection_size(const uint32_t* a, size_t na, const uint32_t* b, size_t nb);
+size_t set_union(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+size_t set_difference(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out);
+
+/**
+ * Set operations on sorted vectors of IDs. The vectors must be strictly increasing
+ * @param a The first vector
+ * @param b The second vector
+ * @param out Receives the result, in place of its elements. It is only reallocated when its capacity is too small
+ * for the largest possible result, so a vector reserved once can be reused from one query to the next
+ */
+template <typename Allocator, typename SizeType>
+void set_intersection(const vector<uint32_t, Allocator, SizeType>& a, const vector<uint32_t, Allocator, SizeType>& b, vector<uint32_t, Allocator, SizeType>& out) {
+    out.resize(a.size() < b.size() ? a.size() : b.size());
+    out.resize(SketchStl::set_intersection(a.data(), a.size(), b.data(), b.size(), out.data()));
+}
+
+template <typename Allocator, typename SizeType>
+size_t set_intersection_size(const vector<uint32_t, Allocator, SizeType>& a, const vector<uint32_t, Allocator, SizeType>& b) {
+    return SketchStl::set_intersection_size(a.data(), a.size(), b.data(), b.size());
+}
+
+template <typename Allocator, typename SizeType>
+void set_union(const vector<uint32_t, Allocator, SizeType>& a, const vector<uint32_t, Allocator, SizeType>& b, vector<uint32_t, Allocator, SizeType>& out) {
+    out.resize(a.size() + b.size());
+    out.resize(SketchStl::set_union(a.data(), a.size(), b.data(), b.size(), out.data()));
+}
+
+template <typename Allocator, typename SizeType>
+void set_difference(const vector<uint32_t, Allocator, SizeType>& a, const vector<uint32_t, Allocator, SizeType>& b, vector<uint32_t, Allocator, SizeType>& out) {
+    out.resize(a.size());
+    out.resize(SketchStl::set_difference(a.data(), a.size(), b.data(), b.size(), out.data()));
+}
+
+/////////////////////////////////////////////////////////////////////////
+// SELECTION
+//
+// nth_element is an introselect: quickselect with a median of three pivot, which falls back to a heap once it has
+// partitioned more than 2 log2(n) times so that it stays O(n log n) on adversarial inputs. partial_sort keeps the
+// k smallest elements in a heap while it scans the range, which is fast while k is small since most elements are
+// rejected by a single comparison with the root. When k is a large part of the range, selecting the k smallest
+// elements first and only sorting them is cheaper
+
+static const ptrdiff_t selection_insertion_threshold = 16;
+static const ptrdiff_t partial_sort_select_ratio = 8;
+
+/**
+ * Sort a short range by insertion
+ * @param first The beginning of the range
+ * @param last The end of the range
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename Compare>
+void insertion_sort(RandomIt first, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+
+    ptrdiff_t len = last - first;
+    for (ptrdiff_t i = 1; i < len; i++) {
+        value_type value = std::move(first[i]);
+
+        ptrdiff_t j = i;
+        for (; j > 0 && comp(value, first[j - 1]); j--) {
+            first[j] = std::move(first[j - 1]);
+        }
+        first[j] = std::move(value);
+    }
+}
+
+/**
+ * Partition a range around the median of its first, middle and last elements. The range must hold at least three
+ * elements
+ * @param first The beginning of the range
+ * @param last The end of the range
+ * @param comp The comparison function
+ * @return The position that splits the range: the elements before it are not greater than the pivot, the
+ * elements from it are not less. Both parts are non-empty
+ */
+template <typename RandomIt, typename Compare>
+ptrdiff_t partition_median_of_three(RandomIt first, RandomIt last, Compare& comp) {
+    using std::swap;
+
+    ptrdiff_t len = last - first;
+    ptrdiff_t a = 1;
+    ptrdiff_t b = len / 2;
+    ptrdiff_t c = len - 1;
+
+    // Move the median to the front. The other two samples stop the scans below, so they need no bound checks
+    ptrdiff_t median;
+    if (comp(first[a], first[b])) {
+        median = comp(first[b], first[c]) ? b : (comp(first[a], first[c]) ? c : a);
+    } else {
+        median = comp(first[a], first[c]) ? a : (comp(first[b], first[c]) ? c : b);
+    }
+    swap(first[0], first[median]);
+
+    ptrdiff_t lo = 1;
+    ptrdiff_t hi = len;
+    for (;;) {
+        while (comp(first[lo], first[0])) {
+            lo++;
+        }
+
+        hi--;
+        while (comp(first[0], first[hi])) {
+            hi--;
+        }
+
+        if (lo >= hi) {
+            return lo;
+        }
+
+        swap(first[lo], first[hi]);
+        lo++;
+    }
+}
+
+/**
+ * Move the smallest elements of a range, sorted, to its beginning by keeping them in a heap while scanning it
+ * @param first The beginning of the range
+ * @param middle The end of the elements to sort
+ * @param last The end of the range
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename Compare>
+void heap_select_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    typedef typename std::iterator_traits<RandomIt>::value_type value_type;
+
+    ptrdiff_t k = middle - first;
+    ptrdiff_t len = last - first;
+    if (k == 0) {
+        return;
+    }
+
+    SketchStl::make_heap<4>(first, middle, comp);
+    for (ptrdiff_t i = k; i < len; i++) {
+        if (comp(first[i], first[0])) {
+            value_type value = std::move(first[i]);
+            first[i] = std::move(first[0]);
+            SketchStl::heap_sift_down<4>(first, k, 0, std::move(value), comp);
+        }
+    }
+
+    SketchStl::sort_heap<4>(first, middle, comp);
+}
+
+/**
+ * Rearrange a range so that the element at nth is the one that would be there if the range was sorted, with no
+ * greater element before it and no smaller element after it. Runs in linear time on average
+ * @param first The beginning of the range
+ * @param nth The position to fix
+ * @param last The end of the range
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename Compare>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last, Compare comp) {
+    ptrdiff_t pos = nth - first;
+    ptrdiff_t len = last - first;
+    if (pos >= len) {
+        return;
+    }
+
+    unsigned depth = 2 * floor_log2((uint64_t)len);
+    while (len > selection_insertion_threshold) {
+        if (depth == 0) {
+            SketchStl::heap_select_sort(first, first + (pos + 1), first + len, comp);
+            return;
+        }
+        depth--;
+
+        ptrdiff_t cut = SketchStl::partition_median_of_three(first, first + len, comp);
+        if (cut <= pos) {
+            first = first + cut;
+            pos -= cut;
+            len -= cut;
+        } else {
+            len = cut;
+        }
+    }
+
+    SketchStl::insertion_sort(first, first + len, comp);
+}
+
+template <typename RandomIt>
+void nth_element(RandomIt first, RandomIt nth, RandomIt last) {
+    SketchStl::nth_element(first, nth, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/**
+ * Move the smallest elements of a range to its beginning, sorted. The order of the other elements is unspecified
+ * @param first The beginning of the range
+ * @param middle The end of the elements to sort
+ * @param last The end of the range
+ * @param comp The comparison function
+ */
+template <typename RandomIt, typename Compare>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+    ptrdiff_t k = middle - first;
+    ptrdiff_t len = last - first;
+
+    if (k > selection_insertion_threshold && k > len / partial_sort_select_ratio) {
+        if (k < len) {
+            SketchStl::nth_element(first, middle, last, comp);
+        }
+        SketchStl::make_heap<4>(first, middle, comp);
+        SketchStl::sort_heap<4>(first, middle, comp);
+        return;
+    }
+
+    SketchStl::heap_select_sort(first, middle, last, comp);
+}
+
+template <typename RandomIt>
+void partial_sort(RandomIt first, RandomIt middle, RandomIt last) {
+    SketchStl::partial_sort(first, middle, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/////////////////////////////////////////////////////////////////////////
+// K-WAY MERGE
+
+/**
+ * @class loser_tree
+ * This class represents a tournament between the heads of k sorted runs, which hands out their elements in order.
+ * Every internal node of the tree remembers the run that lost the match played there, and the winner of the whole
+ * tournament is kept aside. Once the winner has been taken, only the matches on the path from its leaf to the
+ * root are replayed against the new head of its run: log2(k) comparisons per element, against about twice as
+ * many for a heap of iterators. Equal elements come out in the order of their runs, so the merge is stable
+ */
+template <typename T, typename Compare=std::less<typename std::remove_const<T>::type> >
+class loser_tree {
+    public:
+        /**
+         * Constructor
+         * @param runs The sorted runs. The elements are handed out by reference, so they can be moved from
+         * @param k The number of runs
+         * @param comp The comparison function
+         */
+        loser_tree(const span<T>* runs, size_t k, const Compare& comp=Compare());
+
+        /**
+         * Tell whether every run is exhausted
+         */
+        bool empty() const { return heads_.data()[winner_] == ends_.data()[winner_]; }
+
+        /**
+         * Return the smallest head
+         */
+        T& top() const;
+
+        /**
+         * Return the run the smallest head comes from
+         */
+        size_t top_run() const { return winner_; }
+
+        /**
+         * Move past the smallest head, and find the next one
+         */
+        void pop();
+
+    private:
+        /**
+         * Tell whether the head of a run comes before the head of another one. Exhausted runs come last, and ties
+         * go to the run with the lower index
+         */
+        bool beats(size_t a, size_t b) const;
+
+        /**
+         * Play the matches of a subtree
+         * @param node The root of the subtree
+         * @return The run that won them
+         */
+        size_t play(size_t node);
+
+        vector<T*>      heads_;     /**< The next element of every run, and of the padding runs */
+        vector<T*>      ends_;      /**< The end of every run */
+        vector<size_t>  losers_;    /**< The loser of the match played at every internal node, from index 1 */
+        size_t          leaves_;    /**< The number of leaves, the number of runs rounded up to a power of two */
+        size_t          winner_;    /**< The run of the smallest head */
+        Compare         comp_;      /**< The comparison function */
+};
+
+/**
+ * Merge sorted runs, handing every element to a callback in order
+ * @param runs The sorted runs
+ * @param k The number of runs
+ * @param emit Called with a reference to every element, which it can move from
+ * @param comp The comparison function
+ */
+template <typename T, typename Callback, typename Compare>
+void k_way_merge(const span<T>* runs, size_t k, Callback emit, Compare comp) {
+    for (loser_tree<T, Compare> tree(runs, k, comp); !tree.empty(); tree.pop()) {
+        emit(tree.top());
+    }
+}
+
+template <typename T, typename Callback>
+void k_way_merge(const span<T>* runs, size_t k, Callback emit) {
+    SketchStl::k_way_merge(runs, k, emit, std::less<typename std::remove_const<T>::type>());
+}
+
+/**
+ * Merge sorted vectors at the end of another vector, moving their elements. The runs are left with moved-from
+ * elements
+ * @param runs The sorted vectors
+ * @param out Receives the elements, after its own
+ * @param comp The comparison function
+ */
+template <typename T, typename Allocator, typename SizeType, typename RunAllocator, typename RunSizeType, typename Compare>
+void k_way_merge(vector<vector<T, Allocator, SizeType>, RunAllocator, RunSizeType>& runs, vector<T, Allocator, SizeType>& out, Compare comp) {
+    vector<span<T> > spans;
+    spans.reserve(runs.size());
+
+    size_t total = out.size();
+    for (size_t i = 0; i < runs.size(); i++) {
+        spans.push_back(span<T>(runs[i].data(), runs[i].size()));
+        total += runs[i].size();
+    }
+
+    out.reserve(total);
+    SketchStl::k_way_merge(spans.data(), spans.size(), [&out](T& value) { out.push_back(std::move(value)); }, comp);
+}
+
+template <typename T, typename Allocator, typename SizeType, typename RunAllocator, typename RunSizeType>
+void k_way_merge(vector<vector<T, Allocator, SizeType>, RunAllocator, RunSizeType>& runs, vector<T, Allocator, SizeType>& out) {
+    SketchStl::k_way_merge(runs, out, std::less<T>());
+}
+
+/////////////////////////////////////////////////////////////////////////
+// GATHER AND SCATTER
+//
+// gather reads an array through a list of indices and scatter writes one through them. The positions of a loop
+// step do not depend on the elements of the previous ones, so the processor overlaps the cache misses of many
+// steps on its own: neither software prefetching nor the AVX2 gather instruction made these loops faster than the
+// plain ones. What helps with large arrays is spreading the steps over several threads. apply_permutation reorders
+// an array in place by following the cycles of the permutation, which moves every element once. It marks the
+// positions it has filled in a bitmap rather than in the permutation, so that one permutation can reorder every
+// column of a table
+
+static const size_t parallel_gather_min_block = 1 << 15;
+
+/**
+ * Read the elements of an array at a list of positions: out[i] = in[indices[i]]
+ * @param in The array to read
+ * @param indices The positions to read
+ * @param n The number of positions
+ * @param out Receives the elements. Must not overlap in
+ */
+template <typename T>
+void gather(const T* in, const uint32_t* indices, size_t n, T* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = in[indices[i]];
+    }
+}
+
+/**
+ * Write the elements of an array at a list of positions: out[indices[i]] = in[i]
+ * @param in The elements to write
+ * @param indices The positions to write them at
+ * @param n The number of elements
+ * @param out The array to write. Must not overlap in
+ */
+template <typename T>
+void scatter(const T* in, const uint32_t* indices, size_t n, T* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[indices[i]] = in[i];
+    }
+}
+
+/**
+ * The same operations, run by several threads on blocks of consecutive positions. The positions of a scatter must
+ * be distinct
+ * @param threads The number of threads, including the calling one. 0 uses one per hardware thread. Fewer are used
+ * when the blocks would be too small to be worth a thread
+ */
+template <typename T>
+void parallel_gather(const T* in, const uint32_t* indices, size_t n, T* out, unsigned threads=0) {
+    size_t blocks = parallel_block_count(n, parallel_gather_min_block, threads);
+    parallel_for_blocks(n, blocks, [in, indices, out](size_t, size_t first, size_t last) {
+        SketchStl::gather(in, indices + first, last - first, out + first);
+    });
+}
+
+template <typename T>
+void parallel_scatter(const T* in, const uint32_t* indices, size_t n, T* out, unsigned threads=0) {
+    size_t blocks = parallel_block_count(n, parallel_gather_min_block, threads);
+    parallel_for_blocks(n, blocks, [in, indices, out](size_t, size_t first, size_t last) {
+        SketchStl::scatter(in + first, indices + first, last - first, out);
+    });
+}
+
+/**
+ * Reorder an array in place so that values[i] becomes the element that was at perm[i], as gather would
+ * @param values The array
+ * @param perm The permutation: every position from 0 to n - 1, once
+ * @param n The number of elements
+ */
+template <typename T>
+void apply_permutation(T* values, const uint32_t* perm, size_t n) {
+    vector<uint64_t> done((n + 63) / 64, 0);
+    uint64_t* bits = done.data();
+
+    for (size_t start = 0; start < n; start++) {
+        if (bits[start / 64] == ~(uint64_t)0) {
+            start |= 63;
+            continue;
+        }
+        if ((bits[start / 64] >> (start % 64)) & 1) {
+            continue;
+        }
+
+        // Every position of the cycle takes the element at its target, and the last one the element of the first
+        T first = std::move(values[start]);
+        size_t pos = start;
+        for (;;) {
+            assert(perm[pos] < n);
+            bits[pos / 64] |= (uint64_t)1 << (pos % 64);
+
+            size_t from = perm[pos];
+            if (from == start) {
+                values[pos] = std::move(first);
+                break;
+            }
+
+            values[pos] = std::move(values[from]);
+            pos = from;
+        }
+    }
+}
+
+/**
+ * The same operations on vectors. gather resizes out to the number of positions, and scatter writes into out as
+ * it is, which must hold every position
+ */
+template <typename T, typename Allocator, typename SizeType, typename IndexAllocator, typename IndexSizeType>
+void gather(const vector<T, Allocator, SizeType>& in, const vector<uint32_t, IndexAllocator, IndexSizeType>& indices, vector<T, Allocator, SizeType>& out) {
+    out.resize(indices.size());
+    SketchStl::gather(in.data(), indices.data(), indices.size(), out.data());
+}
+
+template <typename T, typename Allocator, typename SizeType, typename IndexAllocator, typename IndexSizeType>
+void scatter(const vector<T, Allocator, SizeType>& in, const vector<uint32_t, IndexAllocator, IndexSizeType>& indices, vector<T, Allocator, SizeType>& out) {
+    assert(indices.size() == in.size());
+    SketchStl::scatter(in.data(), indices.data(), in.size(), out.data());
+}
+
+template <typename T, typename Allocator, typename SizeType, typename IndexAllocator, typename IndexSizeType>
+void apply_permutation(vector<T, Allocator, SizeType>& values, const vector<uint32_t, IndexAllocator, IndexSizeType>& perm) {
+    assert(perm.size() == values.size());
+    SketchStl::apply_permutation(values.data(), perm.data(), values.size());
+}
+
+/////////////////////////////////////////////////////////////////////////
+// STRING SORT
+//
+// A comparison sort of strings calls compare O(n log n) times, and every call walks the prefix the two strings
+// share in two heap buffers. string_sort is a multikey quicksort on cached keys instead: it sorts small records
+// holding the next seven bytes of each string, packed in an integer with the number of bytes left, so that most
+// steps compare two integers in a contiguous array. Strings only get touched when a group of them shares the seven
+// bytes of its keys, to load the next seven, and a common prefix costs one load per string per seven bytes
+// however many times the strings are compared. The order is the lexicographic order of the bytes, taken as
+// unsigned, like the one of memcmp. It is not the order of string::compare, which puts shorter strings first
+
+/**
+ * Sort the positions of an array of strings, so that strings[order[0]], strings[order[1]], ... is sorted. Equal
+ * strings may come in any order
+ * @param strings The strings. Each must be shorter than 4 GB
+ * @param n The number of strings, which must fit in 32 bits
+ * @param order Receives the positions
+ */
+void string_sort_indices(const string* strings, size_t n, uint32_t* order);
+
+/**
+ * The same operation on vectors. order is resized to the number of strings
+ */
+template <typename Allocator, typename SizeType, typename IndexAllocator, typename IndexSizeType>
+void string_sort_indices(const vector<string, Allocator, SizeType>& strings, vector<uint32_t, IndexAllocator, IndexSizeType>& order) {
+    order.resize(strings.size());
+    SketchStl::string_sort_indices(strings.data(), strings.size(), order.data());
+}
+
+/**
+ * Sort a vector of strings. The strings are moved once each, following the sorted positions, and never copied
+ * @param strings The strings
+ */
+template <typename Allocator, typename SizeType>
+void string_sort(vector<string, Allocator, SizeType>& strings) {
+    vector<uint32_t> order;
+    SketchStl::string_sort_indices(strings, order);
+    SketchStl::apply_permutation(strings, order);
+}
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T, typename Compare>
+loser_tree<T, Compare>::loser_tree(const span<T>* runs, size_t k, const Compare& comp) :
+    heads_(), ends_(), losers_(), leaves_(1), winner_(0), comp_(comp) {
+    while (leaves_ < k) {
+        leaves_ *= 2;
+    }
+
+    // The padding runs are empty, so they lose every match
+    heads_.resize(leaves_, nullptr);
+    ends_.resize(leaves_, nullptr);
+    for (size_t i = 0; i < k; i++) {
+        heads_[i] = runs[i].begin();
+        ends_[i] = runs[i].end();
+    }
+
+    losers_.resize(leaves_, 0);
+    winner_ = play(1);
+}
+
+template <typename T, typename Compare>
+T& loser_tree<T, Compare>::top() const {
+    assert(!empty());
+    return *heads_[winner_];
+}
+
+template <typename T, typename Compare>
+void loser_tree<T, Compare>::pop() {
+    assert(!empty());
+    heads_[winner_] += 1;
+
+    size_t winner = winner_;
+    size_t* losers = losers_.data();
+    for (size_t node = (winner + leaves_) / 2; node > 0; node /= 2) {
+        if (beats(losers[node], winner)) {
+            std::swap(losers[node], winner);
+        }
+    }
+
+    winner_ = winner;
+}
+
+template <typename T, typename Compare>
+bool loser_tree<T, Compare>::beats(size_t a, size_t b) const {
+    T* const* heads = heads_.data();
+    T* const* ends = ends_.data();
+
+    if (heads[b] == ends[b]) {
+        return true;
+    }
+    if (heads[a] == ends[a]) {
+        return false;
+    }
+
+    return a < b ? !comp_(*heads[b], *heads[a]) : comp_(*heads[a], *heads[b]);
+}
+
+template <typename T, typename Compare>
+size_t loser_tree<T, Compare>::play(size_t node) {
+    if (node >= leaves_) {
+        return node - leaves_;
+    }
+
+    size_t left = play(2 * node);
+    size_t right = play(2 * node + 1);
+    if (beats(left, right)) {
+        losers_[node] = right;
+        return left;
+    }
+
+    losers_[node] = left;
+    return right;
+}
+
+}
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef SKETCH_STL_BIT_H
+#define SKETCH_STL_BIT_H
+
+#include <assert.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace SketchStl {
+
+/**
+ * Return the index of the most significant set bit of a word, that is floor(log2(x))
+ * @param x The word. Must not be 0
+ */
+inline unsigned floor_log2(uint64_t x) {
+    assert(x != 0);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, x);
+    return (unsigned)index;
+#else
+    return 63 - (unsigned)__builtin_clzll(x);
+#endif
+}
+
+/**
+ * Return the index of the least significant set bit of a word
+ * @param x The word. Must not be 0
+ */
+inline unsigned count_trailing_zeros(uint64_t x) {
+    assert(x != 0);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctzll(x);
+#endif
+}
+
+/**
+ * Return the number of set bits of a word. This is the portable version: it only becomes a single instruction
+ * when the translation unit is compiled for a processor that has one
+ * @param x The word
+ */
+inline unsigned popcount(uint64_t x) {
+#if defined(_MSC_VER)
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+#else
+    return (unsigned)__builtin_popcountll(x);
+#endif
+}
+
+/**
+ * Return the index of the k-th set bit of a word, counting from the least significant bit and from 0
+ * @param x The word
+ * @param k The rank of the bit. Must be lower than popcount(x)
+ */
+inline unsigned select_in_word(uint64_t x, unsigned k) {
+    assert(k < popcount(x));
+    for (unsigned i = 0; i < k; i++) {
+        x &= x - 1;
+    }
+
+    return count_trailing_zeros(x);
+}
+
+}
+
+#endif
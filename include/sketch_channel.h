@@ -0,0 +1,241 @@
+#ifndef SKETCH_STL_CHANNEL_H
+#define SKETCH_STL_CHANNEL_H
+
+#include "sketch_memory.h"
+#include "sketch_queue.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <iterator>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class channel
+ * This class represents a bounded queue between stages of a pipeline running on different threads. Producers push
+ * elements as they make them and consumers pop them as they come, so a stage starts working on the first elements
+ * while the previous one is still making the others, and no more than the capacity of the channel is held in
+ * between. It is a mpmc_queue whose operations wait instead of failing: a full channel blocks the producers and an
+ * empty one the consumers, until the other side makes progress or the channel is closed.
+ * Waiting threads sleep on two counters, bumped after every push and every pop, which are only notified when a
+ * thread is waiting on them. Closing a channel is how producers tell consumers that no more elements will come:
+ * the consumers get the elements left, then pop fails
+ */
+template <typename T, typename Allocator=allocator>
+class channel {
+    public:
+        /**
+         * @class iterator
+         * Input iterator popping the elements of a channel until it is closed and empty
+         */
+        class iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef T value_type;
+                typedef T& reference;
+                typedef ptrdiff_t difference_type;
+                typedef T* pointer;
+
+                iterator() : channel_(nullptr), value_() {}
+
+                /**
+                 * Constructor. Pops the first element
+                 * @param chan The channel
+                 */
+                explicit iterator(channel* chan) : channel_(chan), value_() { ++*this; }
+
+                T& operator*() const { return value_; }
+                T* operator->() const { return &value_; }
+
+                iterator& operator++();
+                void operator++(int) { ++*this; }
+
+                bool operator==(const iterator& rhs) const { return channel_ == rhs.channel_; }
+                bool operator!=(const iterator& rhs) const { return channel_ != rhs.channel_; }
+
+            private:
+                channel*    channel_;   /**< The channel, null once it is closed and empty */
+                mutable T   value_;     /**< The last element popped */
+        };
+
+        /**
+         * Constructor
+         * @param capacity The minimum number of elements the channel can hold
+         */
+        explicit channel(size_t capacity) : queue_(capacity), pushes_(0), pops_(0), waitingConsumers_(0), waitingProducers_(0), closed_(false) {}
+
+        channel(const channel&) = delete;
+        channel& operator=(const channel&) = delete;
+
+        /**
+         * Add an element, waiting while the channel is full
+         * @param val The element
+         * @return false if the channel is closed, in which case the element is left alone
+         */
+        bool push(const T& val) { return push(T(val)); }
+        bool push(T&& val);
+
+        /**
+         * Remove an element, waiting while the channel is empty
+         * @param val Receives the element
+         * @return false if the channel is closed and empty
+         */
+        bool pop(T& val);
+
+        /**
+         * Add or remove an element without waiting
+         * @return false if the channel is full, or empty
+         */
+        bool try_push(T&& val);
+        bool try_pop(T& val);
+
+        /**
+         * Refuse any further element and wake every waiting thread. The elements in the channel can still be
+         * popped. Elements pushed at the same time as the channel is closed may not be seen by the consumers
+         */
+        void close();
+
+        bool closed() const { return closed_.load(std::memory_order_acquire); }
+
+        /**
+         * Return the number of elements in the channel. Only a snapshot when other threads are running
+         */
+        size_t size() const { return queue_.size(); }
+        size_t capacity() const { return queue_.capacity(); }
+
+        /**
+         * Pop the elements until the channel is closed and empty
+         */
+        iterator begin() { return iterator(this); }
+        iterator end() { return iterator(); }
+
+    private:
+        /**
+         * Wake one thread waiting on a counter, after bumping it
+         * @param counter The counter
+         * @param waiting The number of threads waiting on it
+         */
+        static void signal(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& waiting);
+
+        /**
+         * Sleep until a counter differs from the value it had before the operation that failed
+         * @param counter The counter
+         * @param seen Its value before the operation
+         * @param waiting The number of threads waiting on it
+         */
+        static void wait(std::atomic<uint32_t>& counter, uint32_t seen, std::atomic<uint32_t>& waiting);
+
+        mpmc_queue<T, Allocator>    queue_;             /**< The elements */
+        std::atomic<uint32_t>       pushes_;            /**< Bumped after every push, waited on by consumers */
+        std::atomic<uint32_t>       pops_;              /**< Bumped after every pop, waited on by producers */
+        std::atomic<uint32_t>       waitingConsumers_;  /**< The number of consumers sleeping on pushes_ */
+        std::atomic<uint32_t>       waitingProducers_;  /**< The number of producers sleeping on pops_ */
+        std::atomic<bool>           closed_;            /**< Whether the channel refuses elements */
+};
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T, typename Allocator>
+typename channel<T, Allocator>::iterator& channel<T, Allocator>::iterator::operator++() {
+    assert(channel_ != nullptr);
+    if (!channel_->pop(value_)) {
+        channel_ = nullptr;
+    }
+
+    return *this;
+}
+
+template <typename T, typename Allocator>
+bool channel<T, Allocator>::push(T&& val) {
+    for (;;) {
+        if (closed()) {
+            return false;
+        }
+
+        // The counter is read before trying, so that a pop between the try and the wait is not missed
+        uint32_t seen = pops_.load(std::memory_order_seq_cst);
+        if (queue_.try_push(std::move(val))) {
+            signal(pushes_, waitingConsumers_);
+            return true;
+        }
+
+        wait(pops_, seen, waitingProducers_);
+    }
+}
+
+template <typename T, typename Allocator>
+bool channel<T, Allocator>::pop(T& val) {
+    for (;;) {
+        uint32_t seen = pushes_.load(std::memory_order_seq_cst);
+        if (queue_.try_pop(val)) {
+            signal(pops_, waitingProducers_);
+            return true;
+        }
+
+        if (closed()) {
+            // Pushes finished before the channel was closed are visible now
+            if (queue_.try_pop(val)) {
+                signal(pops_, waitingProducers_);
+                return true;
+            }
+
+            return false;
+        }
+
+        wait(pushes_, seen, waitingConsumers_);
+    }
+}
+
+template <typename T, typename Allocator>
+bool channel<T, Allocator>::try_push(T&& val) {
+    if (closed() || !queue_.try_push(std::move(val))) {
+        return false;
+    }
+
+    signal(pushes_, waitingConsumers_);
+    return true;
+}
+
+template <typename T, typename Allocator>
+bool channel<T, Allocator>::try_pop(T& val) {
+    if (!queue_.try_pop(val)) {
+        return false;
+    }
+
+    signal(pops_, waitingProducers_);
+    return true;
+}
+
+template <typename T, typename Allocator>
+void channel<T, Allocator>::close() {
+    closed_.store(true, std::memory_order_seq_cst);
+
+    pushes_.fetch_add(1, std::memory_order_seq_cst);
+    pushes_.notify_all();
+    pops_.fetch_add(1, std::memory_order_seq_cst);
+    pops_.notify_all();
+}
+
+template <typename T, typename Allocator>
+void channel<T, Allocator>::signal(std::atomic<uint32_t>& counter, std::atomic<uint32_t>& waiting) {
+    // Sequentially consistent on both sides: either the waiter is counted here, or it sees the new value before
+    // going to sleep
+    counter.fetch_add(1, std::memory_order_seq_cst);
+    if (waiting.load(std::memory_order_seq_cst) > 0) {
+        counter.notify_one();
+    }
+}
+
+template <typename T, typename Allocator>
+void channel<T, Allocator>::wait(std::atomic<uint32_t>& counter, uint32_t seen, std::atomic<uint32_t>& waiting) {
+    waiting.fetch_add(1, std::memory_order_seq_cst);
+    counter.wait(seen, std::memory_order_seq_cst);
+    waiting.fetch_sub(1, std::memory_order_seq_cst);
+}
+
+}
+
+#endif
@@ -0,0 +1,285 @@
+#ifndef SKETCH_STL_CONCURRENT_VECTOR_H
+#define SKETCH_STL_CONCURRENT_VECTOR_H
+
+#include "sketch_bit.h"
+#include "sketch_memory.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class concurrent_vector
+ * This class represents an append-only array that many threads can grow at the same time. Slots are claimed with
+ * an atomic fetch-add on the length, and the elements live in segments that are allocated on demand and never
+ * move: segment 0 holds SegmentBase elements and every following segment doubles the capacity.
+ *
+ * size() only counts published elements: the longest prefix of elements whose construction has completed.
+ * Any thread can therefore read the elements below size() while other threads keep appending. Every segment
+ * keeps one ready flag per element, and the producer that completes a prefix advances the published length,
+ * so no producer ever waits for a slower one.
+ * clear() and the destructor must not run concurrently with any other member function
+ */
+template <typename T, size_t SegmentBase=64, typename Allocator=allocator>
+class concurrent_vector {
+    static_assert(SegmentBase > 0 && (SegmentBase & (SegmentBase - 1)) == 0, "The segment base must be a power of two");
+
+    public:
+        /**
+         * Default constructor
+         * Constructs an empty container without allocating any segment
+         */
+        concurrent_vector();
+
+        /**
+         * Destructor
+         * Destroys the elements and frees the segments
+         */
+        ~concurrent_vector();
+
+        concurrent_vector(const concurrent_vector&) = delete;
+        concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+        /**
+         * Add an element at the end of the container. Can be called from several threads at once
+         * @param val The value to add at the end
+         * @return The index of the element
+         */
+        size_t push_back(const T& val);
+        size_t push_back(T&& val);
+
+        /**
+         * Add n copies of a value at the end of the container, at contiguous indices. Can be called from several
+         * threads at once
+         * @param n The number of elements to add
+         * @param val The value of the new elements
+         * @return The index of the first added element
+         */
+        size_t grow_by(size_t n, const T& val=T());
+
+        /**
+         * Access element. The element must be published, that is n < size()
+         * @param n The position at which we want to access the element
+         */
+        T& operator[](size_t n);
+        const T& operator[](size_t n) const;
+
+        /**
+         * Return the number of published elements
+         */
+        size_t size() const { return published_.load(std::memory_order_acquire); }
+        bool empty() const { return size() == 0; }
+
+        /**
+         * Destroy every element and free every segment. Not thread-safe
+         */
+        void clear();
+
+    private:
+        static const size_t max_segments = 64;
+
+        /**
+         * Return the segment that holds an index
+         * @param n The index of the element
+         */
+        static size_t segment_of(size_t n);
+
+        /**
+         * Return the index of the first element of a segment
+         * @param segment The segment
+         */
+        static size_t segment_begin(size_t segment);
+
+        /**
+         * Return the number of elements in a segment
+         * @param segment The segment
+         */
+        static size_t segment_size(size_t segment);
+
+        /**
+         * Return the ready flags of a segment, which follow its elements in the same block
+         * @param data The elements of the segment
+         * @param segment The segment
+         */
+        static std::atomic<unsigned char>* ready_flags(T* data, size_t segment);
+
+        /**
+         * Return the address of a claimed slot, allocating its segment if no thread did it yet
+         * @param n The index of the slot
+         */
+        T* slot(size_t n);
+
+        /**
+         * Mark the elements [first, last) as constructed, then advance the published length over every
+         * constructed element that follows it
+         * @param first The first element to publish
+         * @param last The last, non-inclusive element to publish
+         */
+        void publish(size_t first, size_t last);
+
+        std::atomic<T*>     segments_[max_segments];    /**< The segments, allocated on demand */
+        std::atomic<size_t> claimed_;                   /**< The number of slots handed out to producers */
+        std::atomic<size_t> published_;                 /**< The number of constructed elements, in index order */
+};
+
+template <typename T, size_t SegmentBase, typename Allocator>
+concurrent_vector<T, SegmentBase, Allocator>::concurrent_vector() : claimed_(0), published_(0) {
+    for (size_t i = 0; i < max_segments; i++) {
+        segments_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+concurrent_vector<T, SegmentBase, Allocator>::~concurrent_vector() {
+    clear();
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+size_t concurrent_vector<T, SegmentBase, Allocator>::push_back(const T& val) {
+    size_t n = claimed_.fetch_add(1, std::memory_order_relaxed);
+    new (slot(n)) T(val);
+    publish(n, n + 1);
+
+    return n;
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+size_t concurrent_vector<T, SegmentBase, Allocator>::push_back(T&& val) {
+    size_t n = claimed_.fetch_add(1, std::memory_order_relaxed);
+    new (slot(n)) T(std::move(val));
+    publish(n, n + 1);
+
+    return n;
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+size_t concurrent_vector<T, SegmentBase, Allocator>::grow_by(size_t n, const T& val) {
+    size_t first = claimed_.fetch_add(n, std::memory_order_relaxed);
+    for (size_t i = first; i < first + n; i++) {
+        new (slot(i)) T(val);
+    }
+    publish(first, first + n);
+
+    return first;
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+T& concurrent_vector<T, SegmentBase, Allocator>::operator[](size_t n) {
+    assert(n < size());
+    size_t segment = segment_of(n);
+    return segments_[segment].load(std::memory_order_acquire)[n - segment_begin(segment)];
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+const T& concurrent_vector<T, SegmentBase, Allocator>::operator[](size_t n) const {
+    assert(n < size());
+    size_t segment = segment_of(n);
+    return segments_[segment].load(std::memory_order_acquire)[n - segment_begin(segment)];
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+void concurrent_vector<T, SegmentBase, Allocator>::clear() {
+    size_t length = published_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < length; i++) {
+        (*this)[i].~T();
+    }
+
+    for (size_t i = 0; i < max_segments; i++) {
+        Allocator::deallocate(segments_[i].load(std::memory_order_relaxed));
+        segments_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    claimed_.store(0, std::memory_order_relaxed);
+    published_.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+size_t concurrent_vector<T, SegmentBase, Allocator>::segment_of(size_t n) {
+    if (n < SegmentBase) {
+        return 0;
+    }
+
+    return floor_log2(n / SegmentBase) + 1;
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+size_t concurrent_vector<T, SegmentBase, Allocator>::segment_begin(size_t segment) {
+    return segment == 0 ? 0 : SegmentBase << (segment - 1);
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+size_t concurrent_vector<T, SegmentBase, Allocator>::segment_size(size_t segment) {
+    return segment == 0 ? SegmentBase : SegmentBase << (segment - 1);
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+std::atomic<unsigned char>* concurrent_vector<T, SegmentBase, Allocator>::ready_flags(T* data, size_t segment) {
+    return (std::atomic<unsigned char>*)(data + segment_size(segment));
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+T* concurrent_vector<T, SegmentBase, Allocator>::slot(size_t n) {
+    size_t segment = segment_of(n);
+    T* data = segments_[segment].load(std::memory_order_acquire);
+
+    if (data == nullptr) {
+        // Several producers may race to allocate the same segment: the first one to install it wins and
+        // the others free their copy
+        size_t size = segment_size(segment);
+        T* newData = (T*)Allocator::allocate((sizeof(T) + 1) * size);
+
+        std::atomic<unsigned char>* flags = ready_flags(newData, segment);
+        for (size_t i = 0; i < size; i++) {
+            new (&flags[i]) std::atomic<unsigned char>(0);
+        }
+
+        if (segments_[segment].compare_exchange_strong(data, newData, std::memory_order_acq_rel)) {
+            data = newData;
+        } else {
+            Allocator::deallocate(newData);
+        }
+    }
+
+    return &data[n - segment_begin(segment)];
+}
+
+template <typename T, size_t SegmentBase, typename Allocator>
+void concurrent_vector<T, SegmentBase, Allocator>::publish(size_t first, size_t last) {
+    for (size_t i = first; i < last; i++) {
+        size_t segment = segment_of(i);
+        T* data = segments_[segment].load(std::memory_order_acquire);
+        ready_flags(data, segment)[i - segment_begin(segment)].store(1);
+    }
+
+    // Every flag store is followed by a scan from the published length, so whichever producer completes
+    // the prefix last is guaranteed to see all of it and move the length past it
+    size_t published = published_.load();
+    for (;;) {
+        size_t end = published;
+        while (end < claimed_.load()) {
+            size_t segment = segment_of(end);
+            T* data = segments_[segment].load(std::memory_order_acquire);
+            if (data == nullptr || ready_flags(data, segment)[end - segment_begin(segment)].load() == 0) {
+                break;
+            }
+            end += 1;
+        }
+
+        if (end == published) {
+            return;
+        }
+
+        if (published_.compare_exchange_weak(published, end)) {
+            published = end;
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef SKETCH_STL_CPU_H
+#define SKETCH_STL_CPU_H
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SKETCH_STL_X86 1
+#endif
+
+#if defined(_MSC_VER) && defined(SKETCH_STL_X86)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+/**
+ * Compile a single function for an instruction set that the rest of the translation unit does not assume, so
+ * that it can be selected at run time. MSVC accepts every intrinsic without it
+ */
+#if defined(__GNUC__) && defined(SKETCH_STL_X86)
+#define SKETCH_STL_TARGET(isa) __attribute__((target(isa)))
+#else
+#define SKETCH_STL_TARGET(isa)
+#endif
+
+/**
+ * Ask the processor to bring the cache line holding an address into the caches. It is only a hint: the address
+ * does not need to be valid
+ */
+#if defined(__GNUC__)
+#define SKETCH_STL_PREFETCH(addr) __builtin_prefetch((const void*)(addr))
+#elif defined(_MSC_VER) && defined(SKETCH_STL_X86)
+#define SKETCH_STL_PREFETCH(addr) _mm_prefetch((const char*)(addr), _MM_HINT_T0)
+#else
+#define SKETCH_STL_PREFETCH(addr) ((void)(addr))
+#endif
+
+namespace SketchStl {
+
+/**
+ * Tell whether the processor running the program supports the POPCNT instruction
+ */
+inline bool cpu_has_popcnt() {
+#if defined(__GNUC__) && defined(SKETCH_STL_X86)
+    return __builtin_cpu_supports("popcnt") != 0;
+#elif defined(_MSC_VER) && defined(SKETCH_STL_X86)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 23)) != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Tell whether the processor running the program, and the operating system, support AVX2
+ */
+inline bool cpu_has_avx2() {
+#if defined(__GNUC__) && defined(SKETCH_STL_X86)
+    return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER) && defined(SKETCH_STL_X86)
+    // The OS must save the YMM registers, which is reported through OSXSAVE and XCR0
+    int info[4];
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * Tell whether the processor running the program, and the operating system, support the foundation of AVX-512
+ */
+inline bool cpu_has_avx512f() {
+#if defined(__GNUC__) && defined(SKETCH_STL_X86)
+    return __builtin_cpu_supports("avx512f") != 0;
+#elif defined(_MSC_VER) && defined(SKETCH_STL_X86)
+    // The OS must save the YMM, ZMM and mask registers
+    int info[4];
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0xE6) != 0xE6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    return false;
+#endif
+}
+
+}
+
+#endif
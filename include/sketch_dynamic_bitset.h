@@ -0,0 +1,203 @@
+#ifndef SKETCH_STL_DYNAMIC_BITSET_H
+#define SKETCH_STL_DYNAMIC_BITSET_H
+
+#include "sketch_memory.h"
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace SketchStl {
+
+/**
+ * @class dynamic_bitset
+ * This class represents a resizable array of bits packed in 64-bit words, one bit per element. The bitwise
+ * operations work on whole words, with AVX2 when the processor has it, and counting uses the POPCNT instruction
+ * when available. The bits past the size in the last word are always 0, so whole words can be counted and
+ * searched without masking
+ */
+class dynamic_bitset {
+    public:
+        // USEFUL STATICS
+        static const size_t npos = -1;
+        static const size_t bits_per_word = 64;
+
+        /**
+         * Default constructor
+         * Constructs an empty bitset
+         */
+        dynamic_bitset();
+
+        /**
+         * Fill constructor
+         * @param n The number of bits
+         * @param value The value of every bit
+         */
+        explicit dynamic_bitset(size_t n, bool value=false);
+
+        size_t size() const { return length_; }
+        bool empty() const { return length_ == 0; }
+
+        /**
+         * Return the words holding the bits. Bit i is bit (i % 64) of word (i / 64)
+         */
+        uint64_t* data() { return words_.data(); }
+        const uint64_t* data() const { return words_.data(); }
+        size_t num_words() const { return words_.size(); }
+
+        /**
+         * Return the value of a bit
+         * @param pos The position of the bit
+         */
+        bool test(size_t pos) const;
+        bool operator[](size_t pos) const { return test(pos); }
+
+        /**
+         * Set a bit to 1, or to a value
+         * @param pos The position of the bit
+         * @param value The new value of the bit
+         */
+        void set(size_t pos);
+        void set(size_t pos, bool value);
+
+        /**
+         * Set a bit to 0
+         * @param pos The position of the bit
+         */
+        void reset(size_t pos);
+
+        /**
+         * Invert a bit
+         * @param pos The position of the bit
+         */
+        void flip(size_t pos);
+
+        /**
+         * Set every bit to 1
+         */
+        void set();
+
+        /**
+         * Set every bit to 0
+         */
+        void reset();
+
+        /**
+         * Resize the bitset
+         * @param n The new number of bits
+         * @param value The value of the added bits
+         */
+        void resize(size_t n, bool value=false);
+
+        /**
+         * Add a bit at the end of the bitset
+         * @param value The value of the bit
+         */
+        void push_back(bool value);
+
+        /**
+         * Remove every bit
+         */
+        void clear();
+
+        /**
+         * Return the number of bits set to 1
+         */
+        size_t count() const;
+
+        bool any() const { return find_first() != npos; }
+        bool none() const { return find_first() == npos; }
+        bool all() const { return count() == length_; }
+
+        /**
+         * Combine this bitset with another one of the same size, bit by bit
+         * @param rhs The other bitset
+         */
+        dynamic_bitset& operator&=(const dynamic_bitset& rhs);
+        dynamic_bitset& operator|=(const dynamic_bitset& rhs);
+        dynamic_bitset& operator^=(const dynamic_bitset& rhs);
+
+        /**
+         * Clear the bits that are set in another bitset of the same size, that is *this &= ~rhs
+         * @param rhs The other bitset
+         */
+        dynamic_bitset& and_not(const dynamic_bitset& rhs);
+
+        /**
+         * Return the position of the first bit set to 1, or npos
+         */
+        size_t find_first() const;
+
+        /**
+         * Return the position of the first bit set to 1 after a position, or npos
+         * @param pos The position after which the search starts
+         */
+        size_t find_next(size_t pos) const;
+
+        /**
+         * Return the number of bits set to 1 in [0, pos). Linear in pos: use a bitset_rank_index for repeated queries
+         * @param pos The end of the counted range. Can be size()
+         */
+        size_t rank(size_t pos) const;
+
+        /**
+         * Return the position of the k-th bit set to 1, counting from 0, or npos if there are not that many.
+         * Linear: use a bitset_rank_index for repeated queries
+         * @param k The rank of the bit
+         */
+        size_t select(size_t k) const;
+
+        friend bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs);
+        friend bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs);
+
+    private:
+        /**
+         * Clear the bits of the last word that are past the size
+         */
+        void trim();
+
+        aligned_vector<uint64_t, cache_line_size>   words_;     /**< The bits */
+        size_t                                      length_;    /**< The number of bits */
+};
+
+dynamic_bitset operator&(const dynamic_bitset& lhs, const dynamic_bitset& rhs);
+dynamic_bitset operator|(const dynamic_bitset& lhs, const dynamic_bitset& rhs);
+dynamic_bitset operator^(const dynamic_bitset& lhs, const dynamic_bitset& rhs);
+
+/**
+ * @class bitset_rank_index
+ * Sampled counts over a dynamic_bitset that answer rank in constant time and select in logarithmic time. The
+ * number of set bits before every block of 512 bits is stored, which costs one word per eight words of the
+ * bitset. The index refers to the bitset and must be rebuilt after the bitset changes
+ */
+class bitset_rank_index {
+    public:
+        static const size_t words_per_block = 8;
+
+        /**
+         * Constructor
+         * @param bits The bitset to index. Must outlive the index
+         */
+        explicit bitset_rank_index(const dynamic_bitset& bits);
+
+        /**
+         * Return the number of bits set to 1 in [0, pos)
+         * @param pos The end of the counted range. Can be size()
+         */
+        size_t rank(size_t pos) const;
+
+        /**
+         * Return the position of the k-th bit set to 1, counting from 0, or npos if there are not that many
+         * @param k The rank of the bit
+         */
+        size_t select(size_t k) const;
+
+    private:
+        const dynamic_bitset*   bits_;      /**< The indexed bitset */
+        vector<uint64_t>        blocks_;    /**< The number of set bits before every block, plus the total */
+};
+
+}
+
+#endif
@@ -0,0 +1,194 @@
+#ifndef SKETCH_STL_EYTZINGER_INDEX_H
+#define SKETCH_STL_EYTZINGER_INDEX_H
+
+#include "sketch_bit.h"
+#include "sketch_cpu.h"
+#include "sketch_memory.h"
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+
+namespace SketchStl {
+
+/**
+ * @class eytzinger_index
+ * This class represents a read-only copy of a sorted array laid out in the order of a breadth-first walk of its
+ * binary search tree: the root first, then the children of node k at 2k and 2k + 1. A search then reads memory
+ * from left to right, the first levels of the tree stay in the caches, and the descendants a few levels below a
+ * node are contiguous, so they are prefetched one cache line at a time while the search goes on. Searches are
+ * branchless and return a slot, the position of the element in data(). permute gives the same layout to payloads
+ * kept next to the keys
+ */
+template <typename T, typename Compare=std::less<T> >
+class eytzinger_index {
+    public:
+        static const size_t npos = (size_t)-1;
+
+        /**
+         * Default constructor
+         * Constructs an empty index
+         */
+        explicit eytzinger_index(const Compare& comp=Compare()) : values_(1), length_(0), comp_(comp) {}
+
+        /**
+         * Build constructor
+         * @param sorted The sorted elements to index
+         * @param n The number of elements
+         * @param comp The comparison function the elements are sorted with
+         */
+        eytzinger_index(const T* sorted, size_t n, const Compare& comp=Compare());
+
+        template <typename Allocator, typename SizeType>
+        explicit eytzinger_index(const vector<T, Allocator, SizeType>& sorted, const Compare& comp=Compare()) :
+            eytzinger_index(sorted.data(), sorted.size(), comp) {}
+
+        size_t size() const { return length_; }
+        bool empty() const { return length_ == 0; }
+
+        /**
+         * Return the elements in their search order
+         */
+        const T* data() const { return values_.data() + 1; }
+
+        /**
+         * Access the element in a slot
+         * @param slot The slot of the element
+         */
+        const T& operator[](size_t slot) const;
+
+        /**
+         * Find the slot of the first element that is not less than a value
+         * @param value The value to look for
+         * @return The slot, or npos if every element is less than the value
+         */
+        size_t lower_bound(const T& value) const;
+
+        /**
+         * Find the slot of the first element that is greater than a value
+         * @param value The value to look for
+         * @return The slot, or npos if no element is greater than the value
+         */
+        size_t upper_bound(const T& value) const;
+
+        /**
+         * Find the slot of an element equal to a value
+         * @param value The value to look for
+         * @return The slot, or npos if no element is equal to the value
+         */
+        size_t find(const T& value) const;
+
+        /**
+         * Lay out an array that goes with the sorted elements the way the elements are, so that out[slot] is the
+         * payload of the element in that slot
+         * @param sorted The array, in the order of the sorted elements
+         * @param out Receives size() values
+         */
+        template <typename U>
+        void permute(const U* sorted, U* out) const;
+
+    private:
+        /**
+         * How many nodes apart the descendants to prefetch are: with a cache line of them, the loop prefetches the
+         * nodes log2(prefetch_stride) levels below the current one
+         */
+        static const size_t prefetch_stride = sizeof(T) <= cache_line_size && (cache_line_size % sizeof(T)) == 0 ?
+            cache_line_size / sizeof(T) : 2;
+
+        /**
+         * Copy the sorted elements into the subtree of a node, in order
+         * @param sorted The sorted array
+         * @param out The destination, indexed by slot
+         * @param n The number of nodes
+         * @param i The next sorted element to copy
+         * @param k The node at the root of the subtree, numbered from 1
+         * @return The next sorted element to copy after the subtree
+         */
+        template <typename U>
+        static size_t layout(const U* sorted, U* out, size_t n, size_t i, size_t k);
+
+        /**
+         * Walk down the tree, going right whenever goRight says so
+         * @return The node the walk ended on, or 0 if it always went right
+         */
+        template <typename GoRight>
+        size_t descend(GoRight goRight) const;
+
+        aligned_vector<T, cache_line_size>  values_;    /**< The nodes, from index 1. Index 0 is unused */
+        size_t                              length_;    /**< The number of elements */
+        Compare                             comp_;      /**< The comparison function */
+};
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T, typename Compare>
+const size_t eytzinger_index<T, Compare>::npos;
+
+template <typename T, typename Compare>
+eytzinger_index<T, Compare>::eytzinger_index(const T* sorted, size_t n, const Compare& comp) : values_(n + 1), length_(n), comp_(comp) {
+    layout(sorted, values_.data() + 1, n, 0, 1);
+}
+
+template <typename T, typename Compare>
+const T& eytzinger_index<T, Compare>::operator[](size_t slot) const {
+    assert(slot < length_);
+    return values_.data()[slot + 1];
+}
+
+template <typename T, typename Compare>
+size_t eytzinger_index<T, Compare>::lower_bound(const T& value) const {
+    size_t k = descend([&](const T& node) { return comp_(node, value); });
+    return k == 0 ? npos : k - 1;
+}
+
+template <typename T, typename Compare>
+size_t eytzinger_index<T, Compare>::upper_bound(const T& value) const {
+    size_t k = descend([&](const T& node) { return !comp_(value, node); });
+    return k == 0 ? npos : k - 1;
+}
+
+template <typename T, typename Compare>
+size_t eytzinger_index<T, Compare>::find(const T& value) const {
+    size_t slot = lower_bound(value);
+    return slot != npos && !comp_(value, (*this)[slot]) ? slot : npos;
+}
+
+template <typename T, typename Compare>
+template <typename U>
+void eytzinger_index<T, Compare>::permute(const U* sorted, U* out) const {
+    layout(sorted, out, length_, 0, 1);
+}
+
+template <typename T, typename Compare>
+template <typename U>
+size_t eytzinger_index<T, Compare>::layout(const U* sorted, U* out, size_t n, size_t i, size_t k) {
+    if (k <= n) {
+        i = layout(sorted, out, n, i, 2 * k);
+        out[k - 1] = sorted[i++];
+        i = layout(sorted, out, n, i, 2 * k + 1);
+    }
+
+    return i;
+}
+
+template <typename T, typename Compare>
+template <typename GoRight>
+size_t eytzinger_index<T, Compare>::descend(GoRight goRight) const {
+    const T* values = values_.data();
+    uintptr_t address = (uintptr_t)values;
+
+    size_t k = 1;
+    while (k <= length_) {
+        SKETCH_STL_PREFETCH(address + k * prefetch_stride * sizeof(T));
+        k = 2 * k + (goRight(values[k]) ? 1 : 0);
+    }
+
+    // The answer is the last node where the walk went left: strip the trailing right turns, then that left turn
+    return (size_t)(k >> (count_trailing_zeros(~(uint64_t)k) + 1));
+}
+
+}
+
+#endif
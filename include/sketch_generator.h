@@ -0,0 +1,177 @@
+#ifndef SKETCH_STL_GENERATOR_H
+#define SKETCH_STL_GENERATOR_H
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <coroutine>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class generator
+ * This class represents a sequence of elements computed by a coroutine, one at a time, as they are asked for. The
+ * coroutine runs until its next co_yield every time the iterator is incremented, and the iterator refers to the
+ * yielded object in the coroutine frame, so nothing is copied or buffered between the producer and the consumer.
+ * A generator can be walked once. It is a source for the views of sketch_ranges.h like a vector is
+ */
+template <typename T>
+class generator {
+    public:
+        typedef typename std::remove_cv<typename std::remove_reference<T>::type>::type value_type;
+        typedef typename std::conditional<std::is_reference<T>::value, T, T&>::type reference;
+
+        class promise_type {
+            public:
+                generator get_return_object() { return generator(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+                std::suspend_always initial_suspend() noexcept { return std::suspend_always(); }
+                std::suspend_always final_suspend() noexcept { return std::suspend_always(); }
+
+                /**
+                 * Keep the address of the yielded object, which lives until the coroutine resumes
+                 */
+                std::suspend_always yield_value(typename std::remove_reference<reference>::type& val) noexcept;
+                std::suspend_always yield_value(typename std::remove_reference<reference>::type&& val) noexcept;
+
+                void return_void() {}
+
+                /**
+                 * Let an exception leave the coroutine through the call that resumed it
+                 */
+                void unhandled_exception() { throw; }
+
+                /**
+                 * A generator cannot wait for anything else than its consumer
+                 */
+                template <typename U>
+                std::suspend_never await_transform(U&& value) = delete;
+
+                reference value() const { return static_cast<reference>(*value_); }
+
+            private:
+                typename std::remove_reference<reference>::type* value_ = nullptr;   /**< The last yielded object */
+        };
+
+        /**
+         * @class iterator
+         * Input iterator over the elements. The end iterator compares equal to any iterator whose coroutine is done
+         */
+        class iterator {
+            public:
+                typedef std::input_iterator_tag iterator_category;
+                typedef typename generator::value_type value_type;
+                typedef typename generator::reference reference;
+                typedef ptrdiff_t difference_type;
+                typedef typename std::remove_reference<reference>::type* pointer;
+
+                iterator() : coroutine_(nullptr) {}
+                explicit iterator(std::coroutine_handle<promise_type> coroutine) : coroutine_(coroutine) {}
+
+                reference operator*() const { return coroutine_.promise().value(); }
+                pointer operator->() const { return std::addressof(coroutine_.promise().value()); }
+
+                iterator& operator++();
+                void operator++(int) { ++*this; }
+
+                bool operator==(const iterator& rhs) const { return done() == rhs.done(); }
+                bool operator!=(const iterator& rhs) const { return done() != rhs.done(); }
+
+            private:
+                bool done() const { return !coroutine_ || coroutine_.done(); }
+
+                std::coroutine_handle<promise_type> coroutine_;     /**< The coroutine, null for the end iterator */
+        };
+
+        generator() : coroutine_(nullptr), started_(false) {}
+
+        /**
+         * Move constructor
+         * @param src The generator to take the coroutine from
+         */
+        generator(generator&& src) noexcept : coroutine_(src.coroutine_), started_(src.started_) { src.coroutine_ = nullptr; }
+
+        /**
+         * Destructor
+         * Destroys the coroutine, wherever it is suspended, along with the objects of its frame
+         */
+        ~generator();
+
+        generator& operator=(generator&& rhs) noexcept;
+
+        generator(const generator&) = delete;
+        generator& operator=(const generator&) = delete;
+
+        /**
+         * Run the coroutine up to its first element the first time it is called. Later calls give an iterator at
+         * the element the coroutine is suspended on, without resuming it
+         */
+        iterator begin();
+        iterator end() { return iterator(); }
+
+    private:
+        explicit generator(std::coroutine_handle<promise_type> coroutine) : coroutine_(coroutine), started_(false) {}
+
+        std::coroutine_handle<promise_type> coroutine_;     /**< The coroutine */
+        bool                                started_;       /**< Whether the coroutine was resumed past its start */
+};
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T>
+std::suspend_always generator<T>::promise_type::yield_value(typename std::remove_reference<reference>::type& val) noexcept {
+    value_ = std::addressof(val);
+    return std::suspend_always();
+}
+
+template <typename T>
+std::suspend_always generator<T>::promise_type::yield_value(typename std::remove_reference<reference>::type&& val) noexcept {
+    // The temporary lives in the frame until the end of the co_yield expression, which outlasts the suspension
+    value_ = std::addressof(val);
+    return std::suspend_always();
+}
+
+template <typename T>
+typename generator<T>::iterator& generator<T>::iterator::operator++() {
+    assert(!done());
+    coroutine_.resume();
+    return *this;
+}
+
+template <typename T>
+generator<T>::~generator() {
+    if (coroutine_) {
+        coroutine_.destroy();
+    }
+}
+
+template <typename T>
+generator<T>& generator<T>::operator=(generator&& rhs) noexcept {
+    if (this != &rhs) {
+        if (coroutine_) {
+            coroutine_.destroy();
+        }
+        coroutine_ = rhs.coroutine_;
+        started_ = rhs.started_;
+        rhs.coroutine_ = nullptr;
+    }
+
+    return *this;
+}
+
+template <typename T>
+typename generator<T>::iterator generator<T>::begin() {
+    if (coroutine_ && !started_ && !coroutine_.done()) {
+        started_ = true;
+        coroutine_.resume();
+    }
+
+    return iterator(coroutine_);
+}
+
+}
+
+#endif
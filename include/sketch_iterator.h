@@ -1,6 +1,11 @@
 #ifndef SKETCH_STL_ITERATOR_H
 #define SKETCH_STL_ITERATOR_H
 
+#include <stddef.h>
+
+#include <iterator>
+#include <type_traits>
+
 namespace SketchStl {
 
 /**
@@ -10,22 +15,28 @@ namespace SketchStl {
 template <typename T>
 class base_iterator {
     public:
-        base_iterator();
-        base_iterator(T* ptr);
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        constexpr base_iterator();
+        constexpr base_iterator(T* ptr);
         base_iterator(const T& src);
 
-        base_iterator& operator=(const base_iterator& rhs);
+        constexpr base_iterator& operator=(const base_iterator& rhs);
 
-        base_iterator& operator++();
-        base_iterator operator++(int) const;
+        constexpr base_iterator& operator++();
+        constexpr base_iterator operator++(int);
 
-        bool operator==(const base_iterator& rhs) const;
-        bool operator!=(const base_iterator& rhs) const;
+        constexpr bool operator==(const base_iterator& rhs) const;
+        constexpr bool operator!=(const base_iterator& rhs) const;
 
-        T& operator*();
-        const T& operator*() const;
-        T& operator->();
-        const T& operator->() const;
+        constexpr T& operator*();
+        constexpr const T& operator*() const;
+        constexpr T* operator->();
+        constexpr const T* operator->() const;
 
     protected:
         T* ptr_;
@@ -38,10 +49,12 @@ class base_iterator {
 template <typename T>
 class bidirectionnal_iterator : public base_iterator<T> {
     public:
-        bidirectionnal_iterator();
-        bidirectionnal_iterator(T* ptr);
-        bidirectionnal_iterator& operator--() const;
-        bidirectionnal_iterator& operator--(int);
+        typedef std::bidirectional_iterator_tag iterator_category;
+
+        constexpr bidirectionnal_iterator();
+        constexpr bidirectionnal_iterator(T* ptr);
+        constexpr bidirectionnal_iterator& operator--();
+        constexpr bidirectionnal_iterator operator--(int);
 };
 
 /**
@@ -51,34 +64,69 @@ class bidirectionnal_iterator : public base_iterator<T> {
 template <typename T>
 class random_access_iterator : public bidirectionnal_iterator<T> {
     public:
-        random_access_iterator();
-        random_access_iterator(T* ptr);
-        random_access_iterator operator+(size_t n) const;
-        friend random_access_iterator operator+(size_t n, const random_access_iterator& rhs);
-
-        random_access_iterator operator-(size_t n) const;
-        friend random_access_iterator operator-(size_t n, const random_access_iterator& rhs);
+        typedef std::random_access_iterator_tag iterator_category;
+
+        constexpr random_access_iterator();
+        constexpr random_access_iterator(T* ptr);
+
+        constexpr random_access_iterator& operator++();
+        constexpr random_access_iterator operator++(int);
+        constexpr random_access_iterator& operator--();
+        constexpr random_access_iterator operator--(int);
+
+        constexpr random_access_iterator operator+(size_t n) const;
+        friend constexpr random_access_iterator operator+(size_t n, const random_access_iterator& rhs) {
+            return rhs + n;
+        }
+
+        constexpr random_access_iterator operator-(size_t n) const;
+        friend constexpr random_access_iterator operator-(size_t n, const random_access_iterator& rhs) {
+            return rhs - n;
+        }
+
+        /**
+         * Return the number of elements between two iterators
+         * @param rhs The iterator to measure the distance from
+         */
+        constexpr ptrdiff_t operator-(const random_access_iterator& rhs) const;
+
+        constexpr bool operator<(const random_access_iterator& rhs) const;
+        constexpr bool operator>(const random_access_iterator& rhs) const;
+        constexpr bool operator<=(const random_access_iterator& rhs) const;
+        constexpr bool operator>=(const random_access_iterator& rhs) const;
+
+        constexpr random_access_iterator& operator+=(size_t n);
+        constexpr random_access_iterator& operator-=(size_t n);
+
+        constexpr T& operator[](size_t n);
+        constexpr const T& operator[](size_t n) const;
+};
 
-        bool operator<(const random_access_iterator& rhs) const;
-        bool operator>(const random_access_iterator& rhs) const;
-        bool operator<=(const random_access_iterator& rhs) const;
-        bool operator>=(const random_access_iterator& rhs) const;
+/**
+ * @class is_contiguous_iterator
+ * Tells whether the elements referred to by an iterator type are laid out contiguously in memory, which
+ * allows the containers to copy ranges of trivially copyable elements with a single memcpy
+ */
+template <typename It>
+struct is_contiguous_iterator : std::false_type {
+};
 
-        random_access_iterator& operator+=(size_t n);
-        random_access_iterator& operator-=(size_t n);
+template <typename T>
+struct is_contiguous_iterator<T*> : std::true_type {
+};
 
-        T& operator[](size_t n);
-        const T& operator[](size_t n) const;
+template <typename T>
+struct is_contiguous_iterator<random_access_iterator<T>> : std::true_type {
 };
 
 /////////////////////////////////////////////////////////////////////////
 // BASE_ITERATOR
 template <typename T>
-base_iterator<T>::base_iterator() : ptr_(nullptr) {
+constexpr base_iterator<T>::base_iterator() : ptr_(nullptr) {
 }
 
 template <typename T>
-base_iterator<T>::base_iterator(T* ptr) : ptr_(ptr) {
+constexpr base_iterator<T>::base_iterator(T* ptr) : ptr_(ptr) {
 }
 
 template <typename T>
@@ -86,149 +134,172 @@ base_iterator<T>::base_iterator(const T& src) : ptr_(src.ptr_) {
 }
 
 template <typename T>
-base_iterator<T>& base_iterator<T>::operator=(const base_iterator<T>& rhs) {
+constexpr base_iterator<T>& base_iterator<T>::operator=(const base_iterator<T>& rhs) {
     ptr_ = rhs.ptr_;
     return *this;
 }
 
 template <typename T>
-base_iterator<T>& base_iterator<T>::operator++() {
+constexpr base_iterator<T>& base_iterator<T>::operator++() {
     ptr_++;
     return *this;
 }
 
 template <typename T>
-base_iterator<T> base_iterator<T>::operator++(int) const {
-    base_iterator<T> copy(ptr_ + 1);
+constexpr base_iterator<T> base_iterator<T>::operator++(int) {
+    base_iterator<T> copy(ptr_);
+    ptr_++;
     return copy;
 }
 
 template <typename T>
-bool base_iterator<T>::operator==(const base_iterator<T>& rhs) const {
+constexpr bool base_iterator<T>::operator==(const base_iterator<T>& rhs) const {
     return ptr_ == rhs.ptr_;
 }
 
 template <typename T>
-bool base_iterator<T>::operator!=(const base_iterator<T>& rhs) const {
+constexpr bool base_iterator<T>::operator!=(const base_iterator<T>& rhs) const {
     return ptr_ != rhs.ptr_;
 }
 
 template <typename T>
-T& base_iterator<T>::operator*() {
+constexpr T& base_iterator<T>::operator*() {
     return *ptr_;
 }
 
 template <typename T>
-const T& base_iterator<T>::operator*() const {
+constexpr const T& base_iterator<T>::operator*() const {
     return *ptr_;
 }
 
 template <typename T>
-T& base_iterator<T>::operator->() {
-    return *ptr;
+constexpr T* base_iterator<T>::operator->() {
+    return ptr_;
 }
 
 template <typename T>
-const T& base_iterator<T>::operator->() const {
-    return *ptr_;
+constexpr const T* base_iterator<T>::operator->() const {
+    return ptr_;
 }
 
 /////////////////////////////////////////////////////////////////////////
 // BIDIRECTIONNAL_ITERATOR
 template <typename T>
-bidirectionnal_iterator<T>::bidirectionnal_iterator() : base_iterator<T>() {
+constexpr bidirectionnal_iterator<T>::bidirectionnal_iterator() : base_iterator<T>() {
 }
 
 template <typename T>
-bidirectionnal_iterator<T>::bidirectionnal_iterator(T* ptr) : base_iterator<T>(ptr) {
+constexpr bidirectionnal_iterator<T>::bidirectionnal_iterator(T* ptr) : base_iterator<T>(ptr) {
 }
 
 template <typename T>
-bidirectionnal_iterator<T>& bidirectionnal_iterator<T>::operator--() const {
-    bidirectionnal_iterator<T> copy(ptr_ - 1);
-    return copy;
+constexpr bidirectionnal_iterator<T>& bidirectionnal_iterator<T>::operator--() {
+    this->ptr_--;
+    return *this;
 }
 
 template <typename T>
-bidirectionnal_iterator<T>& bidirectionnal_iterator<T>::operator--(int) {
-    ptr--;
-    return *this;
+constexpr bidirectionnal_iterator<T> bidirectionnal_iterator<T>::operator--(int) {
+    bidirectionnal_iterator<T> copy(this->ptr_);
+    this->ptr_--;
+    return copy;
 }
 
 /////////////////////////////////////////////////////////////////////////
 // RANDOM_ACCESS_ITERATOR
 template <typename T>
-random_access_iterator<T>::random_access_iterator() : bidirectionnal_iterator<T>() {
+constexpr random_access_iterator<T>::random_access_iterator() : bidirectionnal_iterator<T>() {
 }
 
 template <typename T>
-random_access_iterator<T>::random_access_iterator(T* ptr) : bidirectionnal_iterator<T>(ptr) {
+constexpr random_access_iterator<T>::random_access_iterator(T* ptr) : bidirectionnal_iterator<T>(ptr) {
 }
 
 template <typename T>
-random_access_iterator<T> random_access_iterator<T>::operator+(size_t n) const {
-    random_access_iterator<T> copy(ptr_);
-    copy.ptr_ += n;
+constexpr random_access_iterator<T>& random_access_iterator<T>::operator++() {
+    this->ptr_++;
+    return *this;
+}
+
+template <typename T>
+constexpr random_access_iterator<T> random_access_iterator<T>::operator++(int) {
+    random_access_iterator<T> copy(this->ptr_);
+    this->ptr_++;
+    return copy;
+}
+
+template <typename T>
+constexpr random_access_iterator<T>& random_access_iterator<T>::operator--() {
+    this->ptr_--;
+    return *this;
+}
+
+template <typename T>
+constexpr random_access_iterator<T> random_access_iterator<T>::operator--(int) {
+    random_access_iterator<T> copy(this->ptr_);
+    this->ptr_--;
     return copy;
 }
 
 template <typename T>
-random_access_iterator<T> operator+(size_t n, const random_access_iterator<T>& rhs) {
-    return rhs + n;
+constexpr random_access_iterator<T> random_access_iterator<T>::operator+(size_t n) const {
+    random_access_iterator<T> copy(this->ptr_);
+    copy.ptr_ += n;
+    return copy;
 }
 
 template <typename T>
-random_access_iterator<T> random_access_iterator<T>::operator-(size_t n) const {
-    random_access_iterator<T> copy(ptr_);
+constexpr random_access_iterator<T> random_access_iterator<T>::operator-(size_t n) const {
+    random_access_iterator<T> copy(this->ptr_);
     copy.ptr_ -= n;
     return copy;
 }
 
 template <typename T>
-random_access_iterator<T> operator-(size_t n, const random_access_iterator<T>& rhs) {
-    return rhs - n;
+constexpr ptrdiff_t random_access_iterator<T>::operator-(const random_access_iterator<T>& rhs) const {
+    return this->ptr_ - rhs.ptr_;
 }
 
 template <typename T>
-bool random_access_iterator<T>::operator<(const random_access_iterator<T>& rhs) const {
-    return ptr_ < rhs.ptr_;
+constexpr bool random_access_iterator<T>::operator<(const random_access_iterator<T>& rhs) const {
+    return this->ptr_ < rhs.ptr_;
 }
 
 template <typename T>
-bool random_access_iterator<T>::operator>(const random_access_iterator<T>& rhs) const {
-    return ptr_ > rhs.ptr_;
+constexpr bool random_access_iterator<T>::operator>(const random_access_iterator<T>& rhs) const {
+    return this->ptr_ > rhs.ptr_;
 }
 
 template <typename T>
-bool random_access_iterator<T>::operator<=(const random_access_iterator<T>& rhs) const {
-    return ptr_ <= rhs.ptr_;
+constexpr bool random_access_iterator<T>::operator<=(const random_access_iterator<T>& rhs) const {
+    return this->ptr_ <= rhs.ptr_;
 }
 
 template <typename T>
-bool random_access_iterator<T>::operator>=(const random_access_iterator<T>& rhs) const {
-    return ptr_ >= rhs.ptr_;
+constexpr bool random_access_iterator<T>::operator>=(const random_access_iterator<T>& rhs) const {
+    return this->ptr_ >= rhs.ptr_;
 }
 
 template <typename T>
-random_access_iterator<T>& random_access_iterator<T>::operator+=(size_t n) {
-    ptr_ += n;
+constexpr random_access_iterator<T>& random_access_iterator<T>::operator+=(size_t n) {
+    this->ptr_ += n;
     return *this;
 }
 
 template <typename T>
-random_access_iterator<T>& random_access_iterator<T>::operator-=(size_t n) {
-    ptr_ -= n;
+constexpr random_access_iterator<T>& random_access_iterator<T>::operator-=(size_t n) {
+    this->ptr_ -= n;
     return *this;
 }
 
 template <typename T>
-T& random_access_iterator<T>::operator[](size_t n) {
-    return (ptr_ + n);
+constexpr T& random_access_iterator<T>::operator[](size_t n) {
+    return *(this->ptr_ + n);
 }
 
 template <typename T>
-const T& random_access_iterator<T>::operator[](size_t n) const {
-    return (ptr_ + n);
+constexpr const T& random_access_iterator<T>::operator[](size_t n) const {
+    return *(this->ptr_ + n);
 }
 
 }
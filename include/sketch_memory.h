@@ -0,0 +1,89 @@
+#ifndef SKETCH_STL_MEMORY_H
+#define SKETCH_STL_MEMORY_H
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace SketchStl {
+
+/**
+ * Size of a cache line on the targeted processors. Data written by different threads is kept this far apart
+ * to avoid false sharing
+ */
+static const size_t cache_line_size = 64;
+
+/**
+ * @class allocator
+ * Default storage policy of the containers. Memory is obtained with malloc and released with free,
+ * which gives the usual fundamental alignment
+ */
+struct allocator {
+    static const size_t alignment = alignof(max_align_t);
+
+    /**
+     * Allocate a block of memory
+     * @param size The size of the block, in bytes
+     * @return A pointer to the block, or nullptr if the allocation failed
+     */
+    static void* allocate(size_t size) {
+        return malloc(size);
+    }
+
+    /**
+     * Free a block previously returned by allocate
+     * @param ptr The block to free. Can be nullptr
+     */
+    static void deallocate(void* ptr) {
+        free(ptr);
+    }
+};
+
+/**
+ * @class aligned_allocator
+ * Storage policy that returns blocks aligned on Align bytes, typically a cache line or a SIMD register width
+ */
+template <size_t Align>
+struct aligned_allocator {
+    static_assert((Align & (Align - 1)) == 0, "The alignment must be a power of two");
+    static_assert(Align >= sizeof(void*), "The alignment must be at least the size of a pointer");
+
+    static const size_t alignment = Align;
+
+    /**
+     * Allocate an aligned block of memory
+     * @param size The size of the block, in bytes
+     * @return A pointer to the block, or nullptr if the allocation failed
+     */
+    static void* allocate(size_t size) {
+#if defined(_WIN32)
+        return _aligned_malloc(size, Align);
+#else
+        void* ptr = nullptr;
+        if (posix_memalign(&ptr, Align, size) != 0) {
+            return nullptr;
+        }
+        return ptr;
+#endif
+    }
+
+    /**
+     * Free a block previously returned by allocate
+     * @param ptr The block to free. Can be nullptr
+     */
+    static void deallocate(void* ptr) {
+#if defined(_WIN32)
+        _aligned_free(ptr);
+#else
+        free(ptr);
+#endif
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,413 @@
+#ifndef SKETCH_STL_NUMERIC_H
+#define SKETCH_STL_NUMERIC_H
+
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/////////////////////////////////////////////////////////////////////////
+// REDUCTIONS AND TRANSFORMS
+//
+// Loops over arrays of numbers. The templates work on any arithmetic type with four independent accumulators, so
+// that additions do not wait on each other and compilers can vectorize them with the baseline instruction set.
+// The overloads for int32_t and float pick AVX2 or AVX-512 kernels at run time, with aligned loads and stores
+// when the arrays are aligned on a register, as the ones of an aligned_vector are. Sums of 32-bit integers are
+// computed on 64 bits. Floating-point sums add the elements in a different order than a sequential loop, so they
+// may round differently. The result of min and max is unspecified if the elements hold NaNs
+
+/**
+ * The type sums and dot products are computed in
+ */
+template <typename T>
+struct accumulator_type {
+    typedef T type;
+};
+
+template <>
+struct accumulator_type<int32_t> {
+    typedef int64_t type;
+};
+
+/**
+ * The instruction sets the kernels can use, from the least to the most capable
+ */
+enum simd_level {
+    simd_scalar,
+    simd_avx2,
+    simd_avx512
+};
+
+/**
+ * Return the most capable instruction set of the processor running the program
+ */
+simd_level simd_supported();
+
+/**
+ * Return the instruction set the kernels use, by default the most capable one
+ */
+simd_level simd_active();
+
+/**
+ * Make the kernels use another instruction set, to compare them or to measure them
+ * @param level The instruction set. It is lowered to the most capable one of the processor
+ */
+void set_simd_active(simd_level level);
+
+/**
+ * Return the sum of the elements of an array
+ * @param data The array
+ * @param n The number of elements
+ */
+template <typename T>
+typename accumulator_type<T>::type sum(const T* data, size_t n);
+
+/**
+ * Return the smallest, the largest, or both of the elements of an array
+ * @param data The array
+ * @param n The number of elements. Must not be 0
+ */
+template <typename T>
+T min(const T* data, size_t n);
+
+template <typename T>
+T max(const T* data, size_t n);
+
+template <typename T>
+std::pair<T, T> minmax(const T* data, size_t n);
+
+/**
+ * Return the sum of the products of the elements of two arrays
+ * @param a The first array
+ * @param b The second array
+ * @param n The number of elements of each array
+ */
+template <typename T>
+typename accumulator_type<T>::type dot(const T* a, const T* b, size_t n);
+
+/**
+ * Return the number of elements of an array equal to a value
+ * @param data The array
+ * @param n The number of elements
+ * @param value The value to count
+ */
+template <typename T>
+size_t count(const T* data, size_t n, T value);
+
+/**
+ * Set the elements of an array to a value
+ * @param data The array
+ * @param n The number of elements
+ * @param value The value
+ */
+template <typename T>
+void fill(T* data, size_t n, T value);
+
+/**
+ * Scale the elements of an array and offset them: dst[i] = src[i] * scale + offset. Integers wrap around
+ * @param src The source array
+ * @param dst The destination array. Can be the source array
+ * @param n The number of elements
+ * @param scale The factor
+ * @param offset The offset
+ */
+template <typename T>
+void transform(const T* src, T* dst, size_t n, T scale, T offset);
+
+int64_t sum(const int32_t* data, size_t n);
+float sum(const float* data, size_t n);
+
+int32_t min(const int32_t* data, size_t n);
+float min(const float* data, size_t n);
+
+int32_t max(const int32_t* data, size_t n);
+float max(const float* data, size_t n);
+
+std::pair<int32_t, int32_t> minmax(const int32_t* data, size_t n);
+std::pair<float, float> minmax(const float* data, size_t n);
+
+int64_t dot(const int32_t* a, const int32_t* b, size_t n);
+float dot(const float* a, const float* b, size_t n);
+
+size_t count(const int32_t* data, size_t n, int32_t value);
+size_t count(const float* data, size_t n, float value);
+
+void fill(int32_t* data, size_t n, int32_t value);
+void fill(float* data, size_t n, float value);
+
+void transform(const int32_t* src, int32_t* dst, size_t n, int32_t scale, int32_t offset);
+void transform(const float* src, float* dst, size_t n, float scale, float offset);
+
+/////////////////////////////////////////////////////////////////////////
+// SCANS AND HISTOGRAMS
+//
+// Prefix sums turn sizes into offsets and counts into bucket boundaries. The overloads for uint32_t scan eight
+// elements in a register with AVX2, and wrap around like the scalar loop. The parallel variants cut arrays of more
+// than parallel_scan_min_block elements per thread into blocks: every thread sums its block, the block totals are
+// scanned, then every thread scans its block from its total. They read the source twice and write it once
+
+static const size_t parallel_scan_min_block = 1 << 16;
+
+/**
+ * The number of buckets up to which histogram counts in four tables, so that runs of equal values do not wait on
+ * the previous increment of the same counter
+ */
+static const size_t histogram_lane_buckets = 1024;
+
+/**
+ * Write the inclusive prefix sums of an array: dst[i] = src[0] + ... + src[i]
+ * @param src The source array
+ * @param dst The destination array. Can be the source array
+ * @param n The number of elements
+ * @return The sum of every element
+ */
+template <typename T>
+T inclusive_scan(const T* src, T* dst, size_t n);
+
+/**
+ * Write the exclusive prefix sums of an array: dst[i] = init + src[0] + ... + src[i - 1]
+ * @param src The source array
+ * @param dst The destination array. Can be the source array
+ * @param n The number of elements
+ * @param init The value of the first sum
+ * @return init plus the sum of every element, which is where the element after the last one would start
+ */
+template <typename T>
+T exclusive_scan(const T* src, T* dst, size_t n, T init=T());
+
+uint32_t inclusive_scan(const uint32_t* src, uint32_t* dst, size_t n);
+uint32_t exclusive_scan(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init=0);
+
+/**
+ * The same scans, run by several threads
+ * @param threads The number of threads, including the calling one. 0 uses one per hardware thread. Fewer are used
+ * when the blocks would be too small to be worth a thread
+ */
+uint32_t parallel_inclusive_scan(const uint32_t* src, uint32_t* dst, size_t n, unsigned threads=0);
+uint32_t parallel_exclusive_scan(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init=0, unsigned threads=0);
+
+/**
+ * Count the occurrences of every value of an array
+ * @param values The array. Every value must be lower than buckets
+ * @param n The number of elements
+ * @param counts Receives the number of occurrences of every value, from 0 to buckets - 1
+ * @param buckets The number of values
+ */
+void histogram(const uint32_t* values, size_t n, uint32_t* counts, size_t buckets);
+
+/**
+ * The same operations on vectors
+ */
+template <typename T, typename Allocator, typename SizeType>
+typename accumulator_type<T>::type sum(const vector<T, Allocator, SizeType>& vec) {
+    return SketchStl::sum(vec.data(), vec.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+T min(const vector<T, Allocator, SizeType>& vec) {
+    return SketchStl::min(vec.data(), vec.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+T max(const vector<T, Allocator, SizeType>& vec) {
+    return SketchStl::max(vec.data(), vec.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+std::pair<T, T> minmax(const vector<T, Allocator, SizeType>& vec) {
+    return SketchStl::minmax(vec.data(), vec.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+typename accumulator_type<T>::type dot(const vector<T, Allocator, SizeType>& a, const vector<T, Allocator, SizeType>& b) {
+    assert(a.size() == b.size());
+    return SketchStl::dot(a.data(), b.data(), a.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+size_t count(const vector<T, Allocator, SizeType>& vec, T value) {
+    return SketchStl::count(vec.data(), vec.size(), value);
+}
+
+template <typename T, typename Allocator, typename SizeType>
+void fill(vector<T, Allocator, SizeType>& vec, T value) {
+    SketchStl::fill(vec.data(), vec.size(), value);
+}
+
+template <typename T, typename Allocator, typename SizeType>
+void transform(const vector<T, Allocator, SizeType>& src, vector<T, Allocator, SizeType>& dst, T scale, T offset) {
+    dst.resize(src.size());
+    SketchStl::transform(src.data(), dst.data(), src.size(), scale, offset);
+}
+
+template <typename T, typename Allocator, typename SizeType>
+T inclusive_scan(const vector<T, Allocator, SizeType>& src, vector<T, Allocator, SizeType>& dst) {
+    dst.resize(src.size());
+    return SketchStl::inclusive_scan(src.data(), dst.data(), src.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+T exclusive_scan(const vector<T, Allocator, SizeType>& src, vector<T, Allocator, SizeType>& dst, T init=T()) {
+    dst.resize(src.size());
+    return SketchStl::exclusive_scan(src.data(), dst.data(), src.size(), init);
+}
+
+template <typename Allocator, typename SizeType>
+void histogram(const vector<uint32_t, Allocator, SizeType>& values, size_t buckets, vector<uint32_t, Allocator, SizeType>& counts) {
+    counts.resize(buckets);
+    SketchStl::histogram(values.data(), values.size(), counts.data(), buckets);
+}
+
+/////////////////////////////////////////////////////////////////////////
+/**
+ * Compute x * scale + offset, wrapping around for integers instead of overflowing
+ */
+template <typename T, bool Integral=std::is_integral<T>::value>
+struct multiply_add {
+    static T apply(T x, T scale, T offset) { return x * scale + offset; }
+};
+
+template <typename T>
+struct multiply_add<T, true> {
+    static T apply(T x, T scale, T offset) {
+        return (T)((unsigned long long)x * (unsigned long long)scale + (unsigned long long)offset);
+    }
+};
+
+template <typename T>
+typename accumulator_type<T>::type sum(const T* data, size_t n) {
+    typedef typename accumulator_type<T>::type acc_type;
+
+    acc_type acc0 = 0;
+    acc_type acc1 = 0;
+    acc_type acc2 = 0;
+    acc_type acc3 = 0;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 += data[i];
+        acc1 += data[i + 1];
+        acc2 += data[i + 2];
+        acc3 += data[i + 3];
+    }
+    for (; i < n; i++) {
+        acc0 += data[i];
+    }
+
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+template <typename T>
+T min(const T* data, size_t n) {
+    return SketchStl::minmax<T>(data, n).first;
+}
+
+template <typename T>
+T max(const T* data, size_t n) {
+    return SketchStl::minmax<T>(data, n).second;
+}
+
+template <typename T>
+std::pair<T, T> minmax(const T* data, size_t n) {
+    assert(n > 0);
+
+    T lo0 = data[0];
+    T hi0 = data[0];
+    T lo1 = data[0];
+    T hi1 = data[0];
+
+    size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        lo0 = data[i] < lo0 ? data[i] : lo0;
+        hi0 = data[i] > hi0 ? data[i] : hi0;
+        lo1 = data[i + 1] < lo1 ? data[i + 1] : lo1;
+        hi1 = data[i + 1] > hi1 ? data[i + 1] : hi1;
+    }
+    for (; i < n; i++) {
+        lo0 = data[i] < lo0 ? data[i] : lo0;
+        hi0 = data[i] > hi0 ? data[i] : hi0;
+    }
+
+    return std::pair<T, T>(lo1 < lo0 ? lo1 : lo0, hi1 > hi0 ? hi1 : hi0);
+}
+
+template <typename T>
+typename accumulator_type<T>::type dot(const T* a, const T* b, size_t n) {
+    typedef typename accumulator_type<T>::type acc_type;
+
+    acc_type acc0 = 0;
+    acc_type acc1 = 0;
+    acc_type acc2 = 0;
+    acc_type acc3 = 0;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc0 += (acc_type)a[i] * b[i];
+        acc1 += (acc_type)a[i + 1] * b[i + 1];
+        acc2 += (acc_type)a[i + 2] * b[i + 2];
+        acc3 += (acc_type)a[i + 3] * b[i + 3];
+    }
+    for (; i < n; i++) {
+        acc0 += (acc_type)a[i] * b[i];
+    }
+
+    return (acc0 + acc1) + (acc2 + acc3);
+}
+
+template <typename T>
+size_t count(const T* data, size_t n, T value) {
+    size_t found = 0;
+    for (size_t i = 0; i < n; i++) {
+        found += data[i] == value ? 1 : 0;
+    }
+
+    return found;
+}
+
+template <typename T>
+void fill(T* data, size_t n, T value) {
+    for (size_t i = 0; i < n; i++) {
+        data[i] = value;
+    }
+}
+
+template <typename T>
+void transform(const T* src, T* dst, size_t n, T scale, T offset) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = multiply_add<T>::apply(src[i], scale, offset);
+    }
+}
+
+template <typename T>
+T inclusive_scan(const T* src, T* dst, size_t n) {
+    T total = T();
+    for (size_t i = 0; i < n; i++) {
+        total += src[i];
+        dst[i] = total;
+    }
+
+    return total;
+}
+
+template <typename T>
+T exclusive_scan(const T* src, T* dst, size_t n, T init) {
+    T total = init;
+    for (size_t i = 0; i < n; i++) {
+        // Read before writing, since dst can be src
+        T value = src[i];
+        dst[i] = total;
+        total += value;
+    }
+
+    return total;
+}
+
+}
+
+#endif
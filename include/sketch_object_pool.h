@@ -0,0 +1,705 @@
+#ifndef SKETCH_STL_OBJECT_POOL_H
+#define SKETCH_STL_OBJECT_POOL_H
+
+#include "sketch_memory.h"
+#include "sketch_vector.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <utility>
+
+namespace SketchStl {
+
+/////////////////////////////////////////////////////////////////////////
+// THREAD CACHES
+//
+// Every thread that uses a pool gets its own cache of free slots for it, so allocating and freeing a slot only
+// touch memory that belongs to the calling thread: no lock, and no atomic operation on a cache line shared with
+// the other threads. A thread finds its cache through a thread-local table keyed by the identifier of the pool,
+// which is never reused, and keeps the last one it used apart so that the common case is a single comparison.
+// The caches also count the slots their thread handed out and took back since they last went to the pool, and add
+// that count to the live count of the pool whenever they refill or spill a batch under its lock. When a thread exits, its caches give their slots back to their pools, which hand them
+// to the next threads that come along. A cache is held by both its pool and its thread, and deleted by the last
+// one to let go of it, so pools and threads can end in any order
+
+/**
+ * @struct pool_thread_cache
+ * The free slots a thread keeps for a pool, and the count of the slots it handed out and took back since it last
+ * settled with the pool. Only the thread writes them, other threads only read the counts
+ */
+struct alignas(cache_line_size) pool_thread_cache {
+    void*                   head;       /**< The free slots, chained through their first word */
+    size_t                  count;      /**< The number of free slots */
+    std::atomic<ptrdiff_t>  pending;    /**< The slots handed out minus the slots taken back since the last settlement */
+    std::atomic<ptrdiff_t>  highest;    /**< The highest value of pending since the last settlement */
+    pool_thread_cache*      next;       /**< The next cache of the pool */
+    bool                    attached;   /**< Whether a thread works with the cache. Guarded by the lock of the pool */
+    std::atomic<int>        owners;     /**< The number of holders among the pool and a thread */
+    std::mutex              lock;       /**< Guards pool between the exit of the thread and the destruction of the pool */
+    void*                   pool;       /**< The pool, null once it is destroyed */
+    void                    (*detach)(void* pool, pool_thread_cache* cache);    /**< Gives the free slots back to the pool */
+
+    pool_thread_cache() : head(nullptr), count(0), pending(0), highest(0), next(nullptr), attached(false), owners(0), pool(nullptr), detach(nullptr) {}
+
+    /**
+     * Count a slot handed out or taken back by the thread of the cache
+     */
+    void note_allocation() {
+        ptrdiff_t out = pending.load(std::memory_order_relaxed) + 1;
+        pending.store(out, std::memory_order_relaxed);
+
+        if (out > highest.load(std::memory_order_relaxed)) {
+            highest.store(out, std::memory_order_relaxed);
+        }
+    }
+
+    void note_deallocation() { pending.store(pending.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed); }
+
+    /**
+     * Let go of the cache, deleting it if nothing else holds it
+     */
+    void release() {
+        if (owners.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            delete this;
+        }
+    }
+};
+
+/**
+ * @struct pool_last_cache
+ * The cache a thread used last, trivially destructible so that it stays readable while the thread exits
+ */
+struct pool_last_cache {
+    uint64_t            pool;       /**< The identifier of the pool, 0 for none */
+    pool_thread_cache*  cache;      /**< The cache of the thread for that pool */
+    bool                exited;     /**< Whether the caches of the thread are gone, which sends it to the shared lists */
+};
+
+inline thread_local pool_last_cache pool_last = { 0, nullptr, false };
+
+/**
+ * The identifier of the next pool, shared by the pools of every type
+ */
+inline std::atomic<uint64_t> pool_next_id(1);
+
+/**
+ * @class pool_thread_registry
+ * The caches of a thread, one per pool it used. Gives them back when the thread exits
+ */
+class pool_thread_registry {
+    public:
+        pool_thread_registry() : caches_() {}
+        ~pool_thread_registry();
+
+        pool_thread_registry(const pool_thread_registry&) = delete;
+        pool_thread_registry& operator=(const pool_thread_registry&) = delete;
+
+        /**
+         * Return the cache of the thread for a pool, or nullptr if the thread has none yet
+         * @param pool The identifier of the pool
+         */
+        pool_thread_cache* find(uint64_t pool) const;
+
+        /**
+         * Record the cache of the thread for a pool, and let go of the caches of the pools destroyed since
+         * @param pool The identifier of the pool
+         * @param cache The cache, which the thread now holds
+         */
+        void add(uint64_t pool, pool_thread_cache* cache);
+
+    private:
+        /**
+         * Give the free slots of a cache back to its pool if it still exists, then let go of the cache
+         */
+        static void leave(pool_thread_cache* cache);
+
+        vector<std::pair<uint64_t, pool_thread_cache*>> caches_;    /**< The caches and the pools they belong to */
+};
+
+inline thread_local pool_thread_registry pool_thread_caches;
+
+/**
+ * @class object_pool
+ * This class represents a pool of fixed-size slots for objects of type T, carved out of large blocks of
+ * SlotsPerBlock slots. Free slots are chained through their own storage, so the pool needs no bookkeeping memory
+ * besides the blocks. Every thread works with its own cache of free slots without any synchronization, and only
+ * goes to the shared free list of the pool, one batch at a time under a lock, when its cache runs empty or
+ * overflows. Blocks are only returned to the Allocator by release_all() or the destructor
+ */
+template <typename T, size_t SlotsPerBlock=1024, typename Allocator=allocator>
+class object_pool {
+    static_assert(SlotsPerBlock > 0, "A block must hold at least one slot");
+
+    public:
+        /**
+         * Default constructor
+         * Constructs an empty pool, without allocating any block
+         */
+        object_pool();
+
+        /**
+         * Destructor
+         * Frees every block. The objects still alive are not destroyed. No other thread may use the pool any more,
+         * but threads that used it can exit at the same time
+         */
+        ~object_pool();
+
+        object_pool(const object_pool&) = delete;
+        object_pool& operator=(const object_pool&) = delete;
+
+        /**
+         * Take an uninitialized slot from the pool. Thread-safe
+         * @return A slot able to hold a T, or nullptr if the pool needed a new block and the Allocator failed
+         */
+        void* allocate();
+
+        /**
+         * Give a slot back to the pool. Thread-safe
+         * @param ptr A slot returned by allocate. Can be nullptr
+         */
+        void deallocate(void* ptr);
+
+        /**
+         * Construct an object in a slot of the pool. Thread-safe
+         * @param args The arguments of the constructor of T
+         * @return The object, or nullptr if no slot could be allocated
+         */
+        template <typename... Args>
+        T* create(Args&&... args);
+
+        /**
+         * Destroy an object created by create and give its slot back. Thread-safe
+         * @param obj The object. Can be nullptr
+         */
+        void destroy(T* obj);
+
+        /**
+         * Give every block back to the Allocator at once. The objects still alive are not destroyed and every slot
+         * becomes invalid. Not thread-safe
+         */
+        void release_all();
+
+        /**
+         * Return the number of slots currently handed out. Only a snapshot when other threads are running
+         */
+        size_t live_count() const;
+
+        /**
+         * Return the highest number of slots that were handed out at the same time. The pool only sees the counts
+         * of a thread when its cache refills or spills a batch, so the result is exact for a single thread and
+         * can overshoot by up to one cache of slots per thread otherwise, whichever threads free the slots
+         */
+        size_t peak_count() const;
+
+        /**
+         * Return the number of blocks allocated by the pool
+         */
+        size_t block_count() const { return blockCount_.load(std::memory_order_relaxed); }
+
+        static const size_t slot_alignment = alignof(T) > alignof(void*) ? alignof(T) : alignof(void*);
+        static const size_t slot_size = ((sizeof(T) > sizeof(void*) ? sizeof(T) : sizeof(void*)) + slot_alignment - 1) / slot_alignment * slot_alignment;
+
+    private:
+        static_assert(slot_alignment <= Allocator::alignment, "The allocator does not align the blocks enough for T");
+
+        static const size_t cache_capacity = 64;    /**< The number of free slots a cache holds before spilling */
+        static const size_t refill_count = 32;      /**< The number of slots moved at once into an empty cache */
+        static const size_t block_header = (sizeof(void*) + slot_alignment - 1) / slot_alignment * slot_alignment;
+
+        struct free_node {
+            free_node* next;
+        };
+
+        /**
+         * Return the cache of the calling thread, making one on its first call for this pool
+         * @return The cache, or nullptr if the thread is exiting and its caches are gone
+         */
+        pool_thread_cache* thread_cache();
+        pool_thread_cache* attach();
+
+        /**
+         * Give the free slots of a cache back to a pool whose thread exits, and leave the cache to the next thread
+         * @param pool The pool
+         * @param cache The cache
+         */
+        static void detach(void* pool, pool_thread_cache* cache);
+
+        /**
+         * Fill an empty cache from the shared free list, allocating a block if the list is empty. The cache gets
+         * fewer slots, or none, if the Allocator fails
+         * @param c The cache
+         */
+        void refill(pool_thread_cache& c);
+
+        /**
+         * Move half of a full cache to the shared free list
+         * @param c The cache
+         */
+        void spill(pool_thread_cache& c);
+
+        /**
+         * Add the slots a cache handed out and took back since its last settlement to the live count of the pool,
+         * and raise the peak to the highest live count they reached. The shared lock must be held
+         * @param c The cache
+         */
+        void settle(pool_thread_cache& c);
+
+        /**
+         * Take a slot that was never used from the newest block, allocating a new block if it is exhausted. The
+         * shared lock must be held
+         * @return The slot, or nullptr if the Allocator failed
+         */
+        free_node* carve();
+
+        const uint64_t      id_;                    /**< The identifier of the pool, which no other pool ever gets */
+
+        mutable std::mutex  lock_;                  /**< Protects the shared free list, the blocks and the caches */
+        free_node*          free_;                  /**< The shared free list */
+        void*               blocks_;                /**< The blocks, chained through their first word */
+        char*               bump_;                  /**< The next never-used slot of the newest block */
+        char*               bumpEnd_;               /**< The end of the newest block */
+        pool_thread_cache*  caches_;                /**< The caches of the threads, chained through next */
+        ptrdiff_t           live_;                  /**< The slots handed out, as of the last settlement of every cache */
+        size_t              peak_;                  /**< The highest live count seen by a settlement */
+
+        std::atomic<size_t> blockCount_;            /**< The number of blocks */
+};
+
+/**
+ * @class pool_allocator
+ * Storage policy that draws the storage of a container from a process-wide object_pool of SlotSize-byte slots.
+ * Requests that do not fit in a slot fall back to malloc. Every block starts with a small header recording where
+ * it came from, so deallocate needs no size. Suited to the many small vectors of a program: a container whose
+ * storage stays under SlotSize bytes never reaches malloc
+ */
+template <size_t SlotSize=256, size_t SlotsPerBlock=1024>
+struct pool_allocator {
+    static const size_t alignment = alignof(max_align_t);
+
+    struct alignas(max_align_t) slot {
+        unsigned char bytes[SlotSize];
+    };
+
+    typedef object_pool<slot, SlotsPerBlock> pool_type;
+
+    /**
+     * Return the pool shared by every container using this policy. It is never destroyed, so that containers
+     * with static storage duration can still free their storage at exit
+     */
+    static pool_type& pool() {
+        static pool_type* instance = new pool_type();
+        return *instance;
+    }
+
+    /**
+     * Allocate a block of memory
+     * @param size The size of the block, in bytes
+     * @return A pointer to the block, or nullptr if the allocation failed
+     */
+    static void* allocate(size_t size) {
+        const size_t header = alignof(max_align_t);
+
+        unsigned char* block;
+        if (size + header <= SlotSize) {
+            block = (unsigned char*)pool().allocate();
+            if (block == nullptr) {
+                return nullptr;
+            }
+            block[0] = 1;
+        } else {
+            block = (unsigned char*)malloc(size + header);
+            if (block == nullptr) {
+                return nullptr;
+            }
+            block[0] = 0;
+        }
+
+        return block + header;
+    }
+
+    /**
+     * Free a block previously returned by allocate
+     * @param ptr The block to free. Can be nullptr
+     */
+    static void deallocate(void* ptr) {
+        if (ptr == nullptr) {
+            return;
+        }
+
+        unsigned char* block = (unsigned char*)ptr - alignof(max_align_t);
+        if (block[0] == 1) {
+            pool().deallocate(block);
+        } else {
+            free(block);
+        }
+    }
+};
+
+
+/////////////////////////////////////////////////////////////////////////
+inline pool_thread_registry::~pool_thread_registry() {
+    // Any pool used from now on, by the destructors of the other thread-locals, goes to its shared free list
+    pool_last.pool = 0;
+    pool_last.cache = nullptr;
+    pool_last.exited = true;
+
+    for (size_t i = 0; i < caches_.size(); i++) {
+        leave(caches_[i].second);
+    }
+}
+
+inline pool_thread_cache* pool_thread_registry::find(uint64_t pool) const {
+    for (size_t i = 0; i < caches_.size(); i++) {
+        if (caches_[i].first == pool) {
+            return caches_[i].second;
+        }
+    }
+
+    return nullptr;
+}
+
+inline void pool_thread_registry::add(uint64_t pool, pool_thread_cache* cache) {
+    for (size_t i = 0; i < caches_.size();) {
+        pool_thread_cache* c = caches_[i].second;
+        bool destroyed;
+        {
+            std::lock_guard<std::mutex> guard(c->lock);
+            destroyed = c->pool == nullptr;
+        }
+
+        if (destroyed) {
+            c->release();
+            caches_.unordered_erase(caches_.begin() + i);
+        } else {
+            i++;
+        }
+    }
+
+    caches_.push_back(std::make_pair(pool, cache));
+}
+
+inline void pool_thread_registry::leave(pool_thread_cache* cache) {
+    {
+        std::lock_guard<std::mutex> guard(cache->lock);
+        if (cache->pool != nullptr) {
+            cache->detach(cache->pool, cache);
+        }
+    }
+
+    cache->release();
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+object_pool<T, SlotsPerBlock, Allocator>::object_pool() : id_(pool_next_id.fetch_add(1, std::memory_order_relaxed)), free_(nullptr), blocks_(nullptr),
+                                                          bump_(nullptr), bumpEnd_(nullptr), caches_(nullptr), live_(0), peak_(0), blockCount_(0) {
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+object_pool<T, SlotsPerBlock, Allocator>::~object_pool() {
+    pool_thread_cache* caches;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        caches = caches_;
+        caches_ = nullptr;
+    }
+
+    // A thread exiting now either gave its slots back already or sees that the pool is gone. The lock of the
+    // pool is not held here, since an exiting thread takes it while holding the lock of its cache
+    while (caches != nullptr) {
+        pool_thread_cache* next = caches->next;
+        {
+            std::lock_guard<std::mutex> guard(caches->lock);
+            caches->pool = nullptr;
+        }
+        caches->release();
+        caches = next;
+    }
+
+    release_all();
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void* object_pool<T, SlotsPerBlock, Allocator>::allocate() {
+    pool_thread_cache* c = thread_cache();
+    if (c == nullptr) {
+        std::lock_guard<std::mutex> guard(lock_);
+        free_node* node = free_;
+        if (node != nullptr) {
+            free_ = node->next;
+        } else {
+            node = carve();
+        }
+
+        if (node != nullptr) {
+            live_ += 1;
+            if (live_ > (ptrdiff_t)peak_) {
+                peak_ = (size_t)live_;
+            }
+        }
+        return node;
+    }
+
+    if (c->head == nullptr) {
+        refill(*c);
+        if (c->head == nullptr) {
+            return nullptr;
+        }
+    }
+
+    free_node* node = (free_node*)c->head;
+    c->head = node->next;
+    c->count -= 1;
+    c->note_allocation();
+
+    return node;
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::deallocate(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    free_node* node = (free_node*)ptr;
+    pool_thread_cache* c = thread_cache();
+    if (c == nullptr) {
+        std::lock_guard<std::mutex> guard(lock_);
+        node->next = free_;
+        free_ = node;
+        live_ -= 1;
+        return;
+    }
+
+    node->next = (free_node*)c->head;
+    c->head = node;
+    c->count += 1;
+    c->note_deallocation();
+
+    if (c->count > cache_capacity) {
+        spill(*c);
+    }
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+template <typename... Args>
+T* object_pool<T, SlotsPerBlock, Allocator>::create(Args&&... args) {
+    void* slot = allocate();
+    if (slot == nullptr) {
+        return nullptr;
+    }
+
+    return new (slot) T(std::forward<Args>(args)...);
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::destroy(T* obj) {
+    if (obj == nullptr) {
+        return;
+    }
+
+    obj->~T();
+    deallocate(obj);
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::release_all() {
+    while (blocks_ != nullptr) {
+        void* next = *(void**)blocks_;
+        Allocator::deallocate(blocks_);
+        blocks_ = next;
+    }
+
+    // The caches stay with their threads, empty. The peak is kept
+    for (pool_thread_cache* c = caches_; c != nullptr; c = c->next) {
+        settle(*c);
+        c->head = nullptr;
+        c->count = 0;
+    }
+    live_ = 0;
+
+    free_ = nullptr;
+    bump_ = bumpEnd_ = nullptr;
+    blockCount_.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+size_t object_pool<T, SlotsPerBlock, Allocator>::live_count() const {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    // The count of a cache is negative when its thread freed slots that other threads allocated
+    ptrdiff_t live = live_;
+    for (pool_thread_cache* c = caches_; c != nullptr; c = c->next) {
+        live += c->pending.load(std::memory_order_relaxed);
+    }
+
+    return live > 0 ? (size_t)live : 0;
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+size_t object_pool<T, SlotsPerBlock, Allocator>::peak_count() const {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    // The caches may have reached a higher count since they last settled
+    ptrdiff_t peak = live_;
+    for (pool_thread_cache* c = caches_; c != nullptr; c = c->next) {
+        peak += c->highest.load(std::memory_order_relaxed);
+    }
+
+    return peak > (ptrdiff_t)peak_ ? (size_t)peak : peak_;
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+pool_thread_cache* object_pool<T, SlotsPerBlock, Allocator>::thread_cache() {
+    if (pool_last.pool == id_) {
+        return pool_last.cache;
+    }
+    if (pool_last.exited) {
+        return nullptr;
+    }
+
+    pool_thread_cache* c = pool_thread_caches.find(id_);
+    if (c == nullptr) {
+        c = attach();
+        pool_thread_caches.add(id_, c);
+    }
+
+    pool_last.pool = id_;
+    pool_last.cache = c;
+    return c;
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+pool_thread_cache* object_pool<T, SlotsPerBlock, Allocator>::attach() {
+    std::lock_guard<std::mutex> guard(lock_);
+
+    // The cache of a thread that exited is taken over, already settled, so that the pool keeps one cache per
+    // running thread rather than one per thread it ever saw
+    for (pool_thread_cache* c = caches_; c != nullptr; c = c->next) {
+        if (!c->attached) {
+            c->attached = true;
+            c->owners.fetch_add(1, std::memory_order_relaxed);
+            return c;
+        }
+    }
+
+    pool_thread_cache* c = new pool_thread_cache();
+    c->attached = true;
+    c->owners.store(2, std::memory_order_relaxed);
+    c->pool = this;
+    c->detach = &object_pool::detach;
+    c->next = caches_;
+    caches_ = c;
+
+    return c;
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::detach(void* pool, pool_thread_cache* cache) {
+    object_pool* self = (object_pool*)pool;
+    std::lock_guard<std::mutex> guard(self->lock_);
+
+    free_node* head = (free_node*)cache->head;
+    if (head != nullptr) {
+        free_node* tail = head;
+        while (tail->next != nullptr) {
+            tail = tail->next;
+        }
+        tail->next = self->free_;
+        self->free_ = head;
+    }
+
+    cache->head = nullptr;
+    cache->count = 0;
+    cache->attached = false;
+    self->settle(*cache);
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::refill(pool_thread_cache& c) {
+    std::lock_guard<std::mutex> guard(lock_);
+    settle(c);
+
+    for (size_t i = 0; i < refill_count; i++) {
+        free_node* node = free_;
+        if (node != nullptr) {
+            free_ = node->next;
+        } else {
+            node = carve();
+            if (node == nullptr) {
+                return;
+            }
+        }
+
+        node->next = (free_node*)c.head;
+        c.head = node;
+        c.count += 1;
+    }
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::spill(pool_thread_cache& c) {
+    // The half that stays is the most recently freed one, which is the most likely to still be in the cache
+    size_t kept = cache_capacity / 2;
+
+    free_node* last = (free_node*)c.head;
+    for (size_t i = 1; i < kept; i++) {
+        last = last->next;
+    }
+
+    free_node* first = last->next;
+    free_node* tail = first;
+    while (tail->next != nullptr) {
+        tail = tail->next;
+    }
+
+    last->next = nullptr;
+    c.count = kept;
+
+    std::lock_guard<std::mutex> guard(lock_);
+    tail->next = free_;
+    free_ = first;
+    settle(c);
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+void object_pool<T, SlotsPerBlock, Allocator>::settle(pool_thread_cache& c) {
+    ptrdiff_t peak = live_ + c.highest.load(std::memory_order_relaxed);
+    if (peak > (ptrdiff_t)peak_) {
+        peak_ = (size_t)peak;
+    }
+
+    live_ += c.pending.load(std::memory_order_relaxed);
+    c.pending.store(0, std::memory_order_relaxed);
+    c.highest.store(0, std::memory_order_relaxed);
+}
+
+template <typename T, size_t SlotsPerBlock, typename Allocator>
+typename object_pool<T, SlotsPerBlock, Allocator>::free_node* object_pool<T, SlotsPerBlock, Allocator>::carve() {
+    if (bump_ == bumpEnd_) {
+        char* block = (char*)Allocator::allocate(block_header + slot_size * SlotsPerBlock);
+        if (block == nullptr) {
+            return nullptr;
+        }
+
+        *(void**)block = blocks_;
+        blocks_ = block;
+        blockCount_.fetch_add(1, std::memory_order_relaxed);
+
+        bump_ = block + block_header;
+        bumpEnd_ = bump_ + slot_size * SlotsPerBlock;
+    }
+
+    free_node* node = (free_node*)bump_;
+    bump_ += slot_size;
+
+    return node;
+}
+
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef SKETCH_STL_PACKED_VECTOR_H
+#define SKETCH_STL_PACKED_VECTOR_H
+
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <type_traits>
+
+namespace SketchStl {
+
+/**
+ * Read a field of bits from an array of words. Bit p of the array is bit (p % 64) of word (p / 64)
+ * @param words The array of words
+ * @param pos The position of the first bit of the field
+ * @param bits The width of the field, from 1 to 64
+ */
+inline uint64_t extract_bits(const uint64_t* words, size_t pos, unsigned bits) {
+    size_t word = pos / 64;
+    unsigned offset = pos % 64;
+
+    uint64_t value = words[word] >> offset;
+    if (offset + bits > 64) {
+        value |= words[word + 1] << (64 - offset);
+    }
+
+    return bits == 64 ? value : value & ((1ULL << bits) - 1);
+}
+
+/**
+ * Write a field of bits into an array of words
+ * @param words The array of words
+ * @param pos The position of the first bit of the field
+ * @param bits The width of the field, from 1 to 64
+ * @param value The value of the field. Must fit in bits
+ */
+inline void deposit_bits(uint64_t* words, size_t pos, unsigned bits, uint64_t value) {
+    size_t word = pos / 64;
+    unsigned offset = pos % 64;
+    uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+
+    words[word] = (words[word] & ~(mask << offset)) | (value << offset);
+    if (offset + bits > 64) {
+        words[word + 1] = (words[word + 1] & ~(mask >> (64 - offset))) | (value >> (64 - offset));
+    }
+}
+
+/**
+ * Decode consecutive fields of the same width into 32-bit integers, with AVX2 when the processor has it
+ * @param words The array of words holding the fields
+ * @param numWords The number of words of the array, which the decoder never reads past
+ * @param bits The width of the fields, from 0 to 32. A width of 0 decodes zeros
+ * @param first The index of the first field to decode
+ * @param n The number of fields to decode
+ * @param out Receives the n values
+ */
+void unpack_bits(const uint64_t* words, size_t numWords, unsigned bits, size_t first, size_t n, uint32_t* out);
+
+/**
+ * @class packed_vector
+ * This class represents a dynamic array of unsigned integers stored on exactly Bits bits each, packed back to back
+ * in 64-bit words. Values can straddle two words. Element access decodes a single value, while unpack decodes
+ * whole ranges at once for scans
+ */
+template <unsigned Bits>
+class packed_vector {
+    static_assert(Bits >= 1 && Bits <= 64, "The width of the values must be between 1 and 64 bits");
+
+    public:
+        typedef typename std::conditional<(Bits <= 32), uint32_t, uint64_t>::type value_type;
+
+        static const value_type max_value = (value_type)(Bits == 64 ? ~0ULL : (1ULL << (Bits % 64)) - 1);
+
+        /**
+         * Default constructor
+         * Constructs an empty container
+         */
+        packed_vector() : words_(), length_(0) {}
+
+        /**
+         * Fill constructor
+         * @param n The number of elements
+         * @param val The value of every element
+         */
+        explicit packed_vector(size_t n, value_type val=0);
+
+        size_t size() const { return length_; }
+        bool empty() const { return length_ == 0; }
+
+        /**
+         * Return the words holding the values, and their number
+         */
+        const uint64_t* data() const { return words_.data(); }
+        size_t num_words() const { return words_.size(); }
+
+        /**
+         * Return the number of bytes used by the values
+         */
+        size_t memory_bytes() const { return words_.size() * sizeof(uint64_t); }
+
+        /**
+         * Access element
+         * @param n The position at which we want to access the element
+         */
+        value_type operator[](size_t n) const;
+        value_type get(size_t n) const { return (*this)[n]; }
+
+        /**
+         * Modify an element
+         * @param n The position of the element
+         * @param val The new value. Must fit in Bits bits
+         */
+        void set(size_t n, value_type val);
+
+        /**
+         * Make the container able to hold n elements without reallocating
+         * @param n The number of elements
+         */
+        void reserve(size_t n) { words_.reserve(word_count(n)); }
+
+        /**
+         * Add an element at the end of the container
+         * @param val The value to add. Must fit in Bits bits
+         */
+        void push_back(value_type val);
+
+        /**
+         * Remove every element
+         */
+        void clear();
+
+        /**
+         * Decode a range of elements
+         * @param first The position of the first element
+         * @param n The number of elements
+         * @param out Receives the n elements
+         */
+        void unpack(size_t first, size_t n, value_type* out) const;
+
+        /**
+         * Decode every element into a vector, which is resized to the size of the container
+         * @param out Receives the elements
+         */
+        template <typename Allocator, typename SizeType>
+        void unpack(vector<value_type, Allocator, SizeType>& out) const;
+
+    private:
+        static size_t word_count(size_t n) { return (n * Bits + 63) / 64; }
+
+        static void unpack_range(const uint64_t* words, size_t numWords, size_t first, size_t n, uint32_t* out);
+        static void unpack_range(const uint64_t* words, size_t numWords, size_t first, size_t n, uint64_t* out);
+
+        vector<uint64_t>    words_;     /**< The packed values */
+        size_t              length_;    /**< The number of values */
+};
+
+/**
+ * @class delta_sequence
+ * This class represents an append-only sequence of 32-bit integers compressed by blocks of block_size values,
+ * meant for sorted lists such as posting lists. A block keeps its first value, then the differences between
+ * consecutive values, minus the smallest of them (frame of reference), packed on the width of the largest one.
+ * Dense sorted lists then cost a few bits per value. Any sequence can be stored, since the differences wrap
+ * around, but unsorted data compresses poorly. The values of the last, incomplete block stay uncompressed
+ * until the block is full
+ */
+class delta_sequence {
+    public:
+        static const size_t block_size = 128;
+
+        /**
+         * Default constructor
+         * Constructs an empty sequence
+         */
+        delta_sequence();
+
+        size_t size() const { return length_; }
+        bool empty() const { return length_ == 0; }
+
+        /**
+         * Return the number of bytes used by the sequence, including the block headers and the pending values
+         */
+        size_t memory_bytes() const;
+
+        /**
+         * Return the number of blocks, counting the incomplete last block
+         */
+        size_t num_blocks() const { return (length_ + block_size - 1) / block_size; }
+
+        /**
+         * Access element. Decodes the beginning of its block
+         * @param n The position at which we want to access the element
+         */
+        uint32_t operator[](size_t n) const;
+
+        /**
+         * Add a value at the end of the sequence
+         * @param value The value to add
+         */
+        void push_back(uint32_t value);
+
+        /**
+         * Decode a whole block
+         * @param n The index of the block
+         * @param out Receives the values of the block, at most block_size of them
+         * @return The number of values in the block
+         */
+        size_t decode_block(size_t n, uint32_t* out) const;
+
+        /**
+         * Decode every element into a vector, which is resized to the size of the sequence
+         * @param out Receives the elements
+         */
+        void unpack(vector<uint32_t>& out) const;
+
+        /**
+         * Remove every element
+         */
+        void clear();
+
+    private:
+        struct block {
+            size_t      offset;     /**< The first word of the packed differences */
+            uint32_t    base;       /**< The first value of the block */
+            uint32_t    minDelta;   /**< The smallest difference between two consecutive values */
+            uint32_t    bits;       /**< The width of the packed differences */
+        };
+
+        /**
+         * Compress the pending values into a block
+         */
+        void flush();
+
+        vector<block>       blocks_;    /**< The compressed blocks */
+        vector<uint64_t>    words_;     /**< The packed differences of every block */
+        vector<uint32_t>    pending_;   /**< The values of the incomplete last block */
+        size_t              length_;    /**< The number of values */
+};
+
+/////////////////////////////////////////////////////////////////////////
+template <unsigned Bits>
+const typename packed_vector<Bits>::value_type packed_vector<Bits>::max_value;
+
+template <unsigned Bits>
+packed_vector<Bits>::packed_vector(size_t n, value_type val) : words_(), length_(0) {
+    reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        push_back(val);
+    }
+}
+
+template <unsigned Bits>
+typename packed_vector<Bits>::value_type packed_vector<Bits>::operator[](size_t n) const {
+    assert(n < length_);
+    return (value_type)extract_bits(words_.data(), n * Bits, Bits);
+}
+
+template <unsigned Bits>
+void packed_vector<Bits>::set(size_t n, value_type val) {
+    assert(n < length_);
+    assert(val <= max_value);
+    deposit_bits(words_.data(), n * Bits, Bits, val);
+}
+
+template <unsigned Bits>
+void packed_vector<Bits>::push_back(value_type val) {
+    assert(val <= max_value);
+
+    size_t needed = word_count(length_ + 1);
+    while (words_.size() < needed) {
+        words_.push_back(0);
+    }
+
+    deposit_bits(words_.data(), length_ * Bits, Bits, val);
+    length_ += 1;
+}
+
+template <unsigned Bits>
+void packed_vector<Bits>::clear() {
+    words_.clear();
+    length_ = 0;
+}
+
+template <unsigned Bits>
+void packed_vector<Bits>::unpack(size_t first, size_t n, value_type* out) const {
+    assert(first + n <= length_);
+    unpack_range(words_.data(), words_.size(), first, n, out);
+}
+
+template <unsigned Bits>
+template <typename Allocator, typename SizeType>
+void packed_vector<Bits>::unpack(vector<value_type, Allocator, SizeType>& out) const {
+    out.resize(length_);
+    unpack_range(words_.data(), words_.size(), 0, length_, out.data());
+}
+
+template <unsigned Bits>
+void packed_vector<Bits>::unpack_range(const uint64_t* words, size_t numWords, size_t first, size_t n, uint32_t* out) {
+    unpack_bits(words, numWords, Bits, first, n, out);
+}
+
+template <unsigned Bits>
+void packed_vector<Bits>::unpack_range(const uint64_t* words, size_t numWords, size_t first, size_t n, uint64_t* out) {
+    (void)numWords;
+    for (size_t i = 0; i < n; i++) {
+        out[i] = extract_bits(words, (first + i) * Bits, Bits);
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef SKETCH_STL_PARALLEL_H
+#define SKETCH_STL_PARALLEL_H
+
+#include "sketch_vector.h"
+
+#include <stddef.h>
+
+#include <thread>
+
+namespace SketchStl {
+
+/////////////////////////////////////////////////////////////////////////
+// PARALLEL BLOCKS
+//
+// The parallel variants of the kernels cut their arrays into one block of consecutive elements per thread. Each
+// thread works on its own part of the output, so they never write to the same cache lines but at the edges of the
+// blocks. The threads are started for every call, so blocks smaller than what the kernels pass as min_block would
+// cost more to start than they save
+
+/**
+ * Return the number of blocks to cut an array into, one per thread, so that no block is smaller than min_block
+ * @param n The number of elements
+ * @param min_block The smallest number of elements worth a thread
+ * @param threads The number of threads, including the calling one. 0 uses one per hardware thread
+ */
+inline size_t parallel_block_count(size_t n, size_t min_block, unsigned threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+
+    size_t blocks = n / min_block;
+    blocks = blocks < threads ? blocks : threads;
+    return blocks > 0 ? blocks : 1;
+}
+
+/**
+ * Cut an array into blocks of the same size and call work(block, first, last) on each of them, each on its own
+ * thread. The calling thread takes the first block, and the call returns once every block is done
+ * @param n The number of elements
+ * @param blocks The number of blocks
+ * @param work The function, called with the index of the block and the positions of its first and past its last
+ * element
+ */
+template <typename Work>
+void parallel_for_blocks(size_t n, size_t blocks, const Work& work) {
+    const size_t block = (n + blocks - 1) / blocks;
+    auto run = [n, block, &work](size_t b) {
+        size_t first = b * block < n ? b * block : n;
+        size_t last = first + block < n ? first + block : n;
+        work(b, first, last);
+    };
+
+    vector<std::thread> threads;
+    threads.reserve(blocks - 1);
+    for (size_t b = 1; b < blocks; b++) {
+        threads.push_back(std::thread(run, b));
+    }
+
+    run(0);
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,242 @@
+#ifndef SKETCH_STL_PRIORITY_QUEUE_H
+#define SKETCH_STL_PRIORITY_QUEUE_H
+
+#include "sketch_algorithm.h"
+#include "sketch_static_vector.h"
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <functional>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class priority_queue
+ * This class represents a queue that always gives access to its largest element according to Compare. It is a
+ * d-ary heap of Arity children per node kept in a vector: 4 by default, which halves the depth of the tree
+ * compared to a binary heap and keeps the children of a node on one cache line. Elements are moved through the
+ * heap and can be moved out of it, so string or vector payloads are never copied
+ */
+template <typename T, typename Compare=std::less<T>, size_t Arity=4>
+class priority_queue {
+    public:
+        /**
+         * Default constructor
+         * @param comp The comparison function
+         */
+        explicit priority_queue(const Compare& comp=Compare()) : values_(), comp_(comp) {}
+
+        /**
+         * Heapify constructor
+         * Takes the elements of a vector and arranges them into a heap in linear time
+         * @param values The elements
+         * @param comp The comparison function
+         */
+        explicit priority_queue(vector<T>&& values, const Compare& comp=Compare());
+
+        /**
+         * Return the largest element
+         */
+        const T& top() const;
+
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+
+        /**
+         * Make the queue able to hold n elements without reallocating
+         * @param n The number of elements
+         */
+        void reserve(size_t n) { values_.reserve(n); }
+        size_t capacity() const { return values_.capacity(); }
+
+        /**
+         * Add an element
+         * @param val The element to add
+         */
+        void push(const T& val);
+        void push(T&& val);
+
+        /**
+         * Remove the largest element
+         */
+        void pop();
+
+        /**
+         * Remove the largest element and return it
+         */
+        T extract_top();
+
+        /**
+         * Replace the elements of the queue by those of a vector, arranged into a heap in linear time
+         * @param values The elements
+         */
+        void heapify(vector<T>&& values);
+
+        /**
+         * Remove every element
+         */
+        void clear() { values_.clear(); }
+
+    private:
+        vector<T>   values_;    /**< The heap */
+        Compare     comp_;      /**< The comparison function */
+};
+
+/**
+ * @class top_k
+ * This class represents a collector of the K largest elements, according to Compare, of a stream of any length.
+ * They are kept in a bounded heap of fixed capacity whose root is the smallest of them: an element that does not
+ * beat the root is rejected by a single comparison, which is what happens to most elements of a long stream
+ */
+template <typename T, size_t K, typename Compare=std::less<T> >
+class top_k {
+    static_assert(K > 0, "A top_k collector must keep at least one element");
+
+    public:
+        /**
+         * Default constructor
+         * @param comp The comparison function
+         */
+        explicit top_k(const Compare& comp=Compare()) : values_(), comp_(comp) {}
+
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+        bool full() const { return values_.full(); }
+
+        /**
+         * Return the smallest element kept, which the next elements have to beat
+         */
+        const T& threshold() const;
+
+        /**
+         * Return the elements kept, in heap order
+         */
+        const T* data() const { return values_.data(); }
+
+        /**
+         * Offer an element
+         * @param val The element
+         * @return Whether the element was kept
+         */
+        bool push(const T& val);
+        bool push(T&& val);
+
+        /**
+         * Move the elements kept to the end of a vector, largest first, and empty the collector
+         * @param out Receives the elements
+         */
+        template <typename Allocator, typename SizeType>
+        void take_sorted(vector<T, Allocator, SizeType>& out);
+
+        /**
+         * Remove every element
+         */
+        void clear() { values_.clear(); }
+
+    private:
+        static const size_t arity = 4;
+
+        static_vector<T, K>         values_;    /**< The heap, with the smallest element at the front */
+        reverse_compare<Compare>    comp_;      /**< The comparison function, reversed */
+};
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T, typename Compare, size_t Arity>
+priority_queue<T, Compare, Arity>::priority_queue(vector<T>&& values, const Compare& comp) : values_(std::move(values)), comp_(comp) {
+    SketchStl::make_heap<Arity>(values_.data(), values_.data() + values_.size(), comp_);
+}
+
+template <typename T, typename Compare, size_t Arity>
+const T& priority_queue<T, Compare, Arity>::top() const {
+    assert(!empty());
+    return values_[0];
+}
+
+template <typename T, typename Compare, size_t Arity>
+void priority_queue<T, Compare, Arity>::push(const T& val) {
+    values_.push_back(val);
+    SketchStl::push_heap<Arity>(values_.data(), values_.data() + values_.size(), comp_);
+}
+
+template <typename T, typename Compare, size_t Arity>
+void priority_queue<T, Compare, Arity>::push(T&& val) {
+    values_.push_back(std::move(val));
+    SketchStl::push_heap<Arity>(values_.data(), values_.data() + values_.size(), comp_);
+}
+
+template <typename T, typename Compare, size_t Arity>
+void priority_queue<T, Compare, Arity>::pop() {
+    assert(!empty());
+    SketchStl::pop_heap<Arity>(values_.data(), values_.data() + values_.size(), comp_);
+    values_.pop_back();
+}
+
+template <typename T, typename Compare, size_t Arity>
+T priority_queue<T, Compare, Arity>::extract_top() {
+    assert(!empty());
+    SketchStl::pop_heap<Arity>(values_.data(), values_.data() + values_.size(), comp_);
+
+    T top = std::move(values_.back());
+    values_.pop_back();
+
+    return top;
+}
+
+template <typename T, typename Compare, size_t Arity>
+void priority_queue<T, Compare, Arity>::heapify(vector<T>&& values) {
+    values_ = std::move(values);
+    SketchStl::make_heap<Arity>(values_.data(), values_.data() + values_.size(), comp_);
+}
+
+template <typename T, size_t K, typename Compare>
+const T& top_k<T, K, Compare>::threshold() const {
+    assert(!empty());
+    return values_[0];
+}
+
+template <typename T, size_t K, typename Compare>
+bool top_k<T, K, Compare>::push(const T& val) {
+    // The element is only copied once it is known to be kept
+    if (values_.full() && !comp_.comp(values_[0], val)) {
+        return false;
+    }
+
+    return push(T(val));
+}
+
+template <typename T, size_t K, typename Compare>
+bool top_k<T, K, Compare>::push(T&& val) {
+    if (!values_.full()) {
+        values_.push_back(std::move(val));
+        SketchStl::push_heap<arity>(values_.data(), values_.data() + values_.size(), comp_);
+        return true;
+    }
+
+    // The new element takes the place of the root, if it beats it
+    if (!comp_.comp(values_[0], val)) {
+        return false;
+    }
+
+    SketchStl::heap_sift_down<arity>(values_.data(), (ptrdiff_t)K, 0, std::move(val), comp_);
+    return true;
+}
+
+template <typename T, size_t K, typename Compare>
+template <typename Allocator, typename SizeType>
+void top_k<T, K, Compare>::take_sorted(vector<T, Allocator, SizeType>& out) {
+    // Sorting with the reversed order puts the largest element first
+    SketchStl::sort_heap<arity>(values_.data(), values_.data() + values_.size(), comp_);
+
+    out.reserve(out.size() + values_.size());
+    for (size_t i = 0; i < values_.size(); i++) {
+        out.push_back(std::move(values_[i]));
+    }
+    values_.clear();
+}
+
+}
+
+#endif
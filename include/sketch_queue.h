@@ -0,0 +1,515 @@
+#ifndef SKETCH_STL_QUEUE_H
+#define SKETCH_STL_QUEUE_H
+
+#include "sketch_memory.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class spsc_queue
+ * This class represents a bounded, lock-free queue between exactly one producer thread and one consumer thread.
+ * The elements live in a ring buffer whose capacity is rounded up to a power of two. The head, written by the
+ * consumer, and the tail, written by the producer, sit on separate cache lines, and each side keeps a private
+ * copy of the other index so that it only reads the shared one when the queue looks full or empty.
+ * Elements are moved in and out of the queue, so a string or vector payload hands over its buffer without copying
+ */
+template <typename T, typename Allocator=allocator>
+class spsc_queue {
+    public:
+        /**
+         * Constructor
+         * @param capacity The minimum number of elements the queue can hold
+         */
+        explicit spsc_queue(size_t capacity);
+
+        /**
+         * Destructor
+         * Destroys the elements left in the queue
+         */
+        ~spsc_queue();
+
+        spsc_queue(const spsc_queue&) = delete;
+        spsc_queue& operator=(const spsc_queue&) = delete;
+
+        /**
+         * Add an element at the back of the queue. Producer side only
+         * @param val The value to add
+         * @return false if the queue is full
+         */
+        bool try_push(const T& val);
+        bool try_push(T&& val);
+
+        /**
+         * Move as many elements of an array as possible at the back of the queue. Producer side only
+         * @param values The elements to move
+         * @param n The number of elements in the array
+         * @return The number of elements moved, the first ones of the array
+         */
+        size_t try_push(T* values, size_t n);
+
+        /**
+         * Remove the element at the front of the queue. Consumer side only
+         * @param val Receives the element
+         * @return false if the queue is empty
+         */
+        bool try_pop(T& val);
+
+        /**
+         * Remove up to n elements from the front of the queue. Consumer side only
+         * @param values Receives the elements
+         * @param n The maximum number of elements to remove
+         * @return The number of elements removed
+         */
+        size_t try_pop(T* values, size_t n);
+
+        /**
+         * Return the number of elements in the queue. Only a snapshot when the other side is running
+         */
+        size_t size() const;
+        bool empty() const { return size() == 0; }
+        size_t capacity() const { return mask_ + 1; }
+
+    private:
+        /**
+         * Return the number of free slots, refreshing the copy of the head if fewer than n are known to be free
+         * @param tail The tail of the queue
+         * @param n The number of slots the producer wants
+         */
+        size_t free_slots(size_t tail, size_t n);
+
+        /**
+         * Return the number of filled slots, refreshing the copy of the tail if fewer than n are known to be filled
+         * @param head The head of the queue
+         * @param n The number of elements the consumer wants
+         */
+        size_t filled_slots(size_t head, size_t n);
+
+        T*                  slots_;                     /**< The ring buffer */
+        size_t              mask_;                      /**< The capacity minus one */
+        char                pad0_[cache_line_size];
+
+        std::atomic<size_t> head_;                      /**< The index of the next element to pop */
+        size_t              cachedTail_;                /**< The tail, as last seen by the consumer */
+        char                pad1_[cache_line_size];
+
+        std::atomic<size_t> tail_;                      /**< The index of the next slot to fill */
+        size_t              cachedHead_;                /**< The head, as last seen by the producer */
+        char                pad2_[cache_line_size];
+};
+
+/**
+ * @class mpmc_queue
+ * This class represents a bounded, lock-free queue that any number of threads can push to and pop from, following
+ * Dmitry Vyukov's design. Every slot carries a sequence number telling which lap of the ring it is ready for: a
+ * producer claims a slot by advancing the enqueue position with a compare-and-swap once the slot's sequence shows
+ * that it was emptied, and publishes the element by bumping the sequence; consumers do the same on the other side.
+ * Threads never wait for each other: a full or empty queue makes the operation fail instead.
+ * The enqueue and dequeue positions sit on separate cache lines, and elements are moved in and out of the queue
+ */
+template <typename T, typename Allocator=allocator>
+class mpmc_queue {
+    public:
+        /**
+         * Constructor
+         * @param capacity The minimum number of elements the queue can hold. The queue holds at least 2
+         */
+        explicit mpmc_queue(size_t capacity);
+
+        /**
+         * Destructor
+         * Destroys the elements left in the queue. No other thread may use the queue anymore
+         */
+        ~mpmc_queue();
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        /**
+         * Add an element at the back of the queue
+         * @param val The value to add
+         * @return false if the queue is full
+         */
+        bool try_push(const T& val);
+        bool try_push(T&& val);
+
+        /**
+         * Move as many elements of an array as possible at the back of the queue. The elements are claimed with
+         * a single compare-and-swap, so they stay contiguous in the queue
+         * @param values The elements to move
+         * @param n The number of elements in the array
+         * @return The number of elements moved, the first ones of the array
+         */
+        size_t try_push(T* values, size_t n);
+
+        /**
+         * Remove the element at the front of the queue
+         * @param val Receives the element
+         * @return false if the queue is empty
+         */
+        bool try_pop(T& val);
+
+        /**
+         * Remove up to n consecutive elements from the front of the queue
+         * @param values Receives the elements
+         * @param n The maximum number of elements to remove
+         * @return The number of elements removed
+         */
+        size_t try_pop(T* values, size_t n);
+
+        /**
+         * Return the number of elements in the queue. Only a snapshot when other threads are running
+         */
+        size_t size() const;
+        bool empty() const { return size() == 0; }
+        size_t capacity() const { return mask_ + 1; }
+
+    private:
+        struct cell {
+            std::atomic<size_t>                                         sequence;
+            typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+            T* value() { return (T*)&storage; }
+        };
+
+        /**
+         * Claim up to n consecutive slots to fill
+         * @param n The number of slots wanted
+         * @param pos Receives the position of the first claimed slot
+         * @return The number of claimed slots, 0 if the queue is full
+         */
+        size_t claim_push(size_t n, size_t& pos);
+
+        /**
+         * Claim up to n consecutive elements to remove
+         * @param n The number of elements wanted
+         * @param pos Receives the position of the first claimed element
+         * @return The number of claimed elements, 0 if the queue is empty
+         */
+        size_t claim_pop(size_t n, size_t& pos);
+
+        cell*               cells_;                     /**< The ring buffer */
+        size_t              mask_;                      /**< The capacity minus one */
+        char                pad0_[cache_line_size];
+
+        std::atomic<size_t> enqueuePos_;                /**< The position of the next slot to claim for a push */
+        char                pad1_[cache_line_size];
+
+        std::atomic<size_t> dequeuePos_;                /**< The position of the next element to claim for a pop */
+        char                pad2_[cache_line_size];
+};
+
+/**
+ * Round a queue capacity up to a power of two
+ * @param n The requested capacity. Must not be 0
+ */
+inline size_t queue_capacity(size_t n) {
+    assert(n > 0);
+
+    size_t capacity = 1;
+    while (capacity < n) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T, typename Allocator>
+spsc_queue<T, Allocator>::spsc_queue(size_t capacity) : head_(0), cachedTail_(0), tail_(0), cachedHead_(0) {
+    mask_ = queue_capacity(capacity) - 1;
+    slots_ = (T*)Allocator::allocate(sizeof(T) * (mask_ + 1));
+}
+
+template <typename T, typename Allocator>
+spsc_queue<T, Allocator>::~spsc_queue() {
+    size_t tail = tail_.load(std::memory_order_acquire);
+    for (size_t i = head_.load(std::memory_order_relaxed); i != tail; i++) {
+        slots_[i & mask_].~T();
+    }
+
+    Allocator::deallocate(slots_);
+}
+
+template <typename T, typename Allocator>
+bool spsc_queue<T, Allocator>::try_push(const T& val) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (free_slots(tail, 1) == 0) {
+        return false;
+    }
+
+    new (&slots_[tail & mask_]) T(val);
+    tail_.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T, typename Allocator>
+bool spsc_queue<T, Allocator>::try_push(T&& val) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    if (free_slots(tail, 1) == 0) {
+        return false;
+    }
+
+    new (&slots_[tail & mask_]) T(std::move(val));
+    tail_.store(tail + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T, typename Allocator>
+size_t spsc_queue<T, Allocator>::try_push(T* values, size_t n) {
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    size_t count = free_slots(tail, n);
+    if (count > n) {
+        count = n;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        new (&slots_[(tail + i) & mask_]) T(std::move(values[i]));
+    }
+    tail_.store(tail + count, std::memory_order_release);
+
+    return count;
+}
+
+template <typename T, typename Allocator>
+bool spsc_queue<T, Allocator>::try_pop(T& val) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    if (filled_slots(head, 1) == 0) {
+        return false;
+    }
+
+    T& slot = slots_[head & mask_];
+    val = std::move(slot);
+    slot.~T();
+    head_.store(head + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T, typename Allocator>
+size_t spsc_queue<T, Allocator>::try_pop(T* values, size_t n) {
+    size_t head = head_.load(std::memory_order_relaxed);
+    size_t count = filled_slots(head, n);
+    if (count > n) {
+        count = n;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        T& slot = slots_[(head + i) & mask_];
+        values[i] = std::move(slot);
+        slot.~T();
+    }
+    head_.store(head + count, std::memory_order_release);
+
+    return count;
+}
+
+template <typename T, typename Allocator>
+size_t spsc_queue<T, Allocator>::size() const {
+    // The head is read first: the tail can only move further while it is being read, so the difference never wraps
+    size_t head = head_.load(std::memory_order_acquire);
+    size_t tail = tail_.load(std::memory_order_acquire);
+
+    return tail - head;
+}
+
+template <typename T, typename Allocator>
+size_t spsc_queue<T, Allocator>::free_slots(size_t tail, size_t n) {
+    size_t count = capacity() - (tail - cachedHead_);
+    if (count < n) {
+        cachedHead_ = head_.load(std::memory_order_acquire);
+        count = capacity() - (tail - cachedHead_);
+    }
+
+    return count;
+}
+
+template <typename T, typename Allocator>
+size_t spsc_queue<T, Allocator>::filled_slots(size_t head, size_t n) {
+    size_t count = cachedTail_ - head;
+    if (count < n) {
+        cachedTail_ = tail_.load(std::memory_order_acquire);
+        count = cachedTail_ - head;
+    }
+
+    return count;
+}
+
+/////////////////////////////////////////////////////////////////////////
+template <typename T, typename Allocator>
+mpmc_queue<T, Allocator>::mpmc_queue(size_t capacity) : enqueuePos_(0), dequeuePos_(0) {
+    // With a single slot, the sequence of a slot full from one lap is the one of the slot free for the next lap
+    mask_ = queue_capacity(capacity < 2 ? 2 : capacity) - 1;
+    cells_ = (cell*)Allocator::allocate(sizeof(cell) * (mask_ + 1));
+
+    // A slot is free for the push at position p when its sequence is p, so the first lap starts at the slot index
+    for (size_t i = 0; i <= mask_; i++) {
+        new (&cells_[i].sequence) std::atomic<size_t>(i);
+    }
+}
+
+template <typename T, typename Allocator>
+mpmc_queue<T, Allocator>::~mpmc_queue() {
+    size_t end = enqueuePos_.load(std::memory_order_acquire);
+    for (size_t i = dequeuePos_.load(std::memory_order_acquire); i != end; i++) {
+        cells_[i & mask_].value()->~T();
+    }
+
+    Allocator::deallocate(cells_);
+}
+
+template <typename T, typename Allocator>
+bool mpmc_queue<T, Allocator>::try_push(const T& val) {
+    size_t pos;
+    if (claim_push(1, pos) == 0) {
+        return false;
+    }
+
+    cell& c = cells_[pos & mask_];
+    new (c.value()) T(val);
+    c.sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T, typename Allocator>
+bool mpmc_queue<T, Allocator>::try_push(T&& val) {
+    size_t pos;
+    if (claim_push(1, pos) == 0) {
+        return false;
+    }
+
+    cell& c = cells_[pos & mask_];
+    new (c.value()) T(std::move(val));
+    c.sequence.store(pos + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T, typename Allocator>
+size_t mpmc_queue<T, Allocator>::try_push(T* values, size_t n) {
+    size_t pos;
+    size_t count = claim_push(n, pos);
+
+    for (size_t i = 0; i < count; i++) {
+        cell& c = cells_[(pos + i) & mask_];
+        new (c.value()) T(std::move(values[i]));
+        c.sequence.store(pos + i + 1, std::memory_order_release);
+    }
+
+    return count;
+}
+
+template <typename T, typename Allocator>
+bool mpmc_queue<T, Allocator>::try_pop(T& val) {
+    size_t pos;
+    if (claim_pop(1, pos) == 0) {
+        return false;
+    }
+
+    cell& c = cells_[pos & mask_];
+    val = std::move(*c.value());
+    c.value()->~T();
+    c.sequence.store(pos + mask_ + 1, std::memory_order_release);
+
+    return true;
+}
+
+template <typename T, typename Allocator>
+size_t mpmc_queue<T, Allocator>::try_pop(T* values, size_t n) {
+    size_t pos;
+    size_t count = claim_pop(n, pos);
+
+    for (size_t i = 0; i < count; i++) {
+        cell& c = cells_[(pos + i) & mask_];
+        values[i] = std::move(*c.value());
+        c.value()->~T();
+        c.sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+    }
+
+    return count;
+}
+
+template <typename T, typename Allocator>
+size_t mpmc_queue<T, Allocator>::size() const {
+    size_t dequeuePos = dequeuePos_.load(std::memory_order_acquire);
+    size_t enqueuePos = enqueuePos_.load(std::memory_order_acquire);
+
+    return enqueuePos - dequeuePos;
+}
+
+template <typename T, typename Allocator>
+size_t mpmc_queue<T, Allocator>::claim_push(size_t n, size_t& pos) {
+    pos = enqueuePos_.load(std::memory_order_relaxed);
+    if (n == 0) {
+        return 0;
+    }
+
+    for (;;) {
+        size_t count = 0;
+        while (count < n && cells_[(pos + count) & mask_].sequence.load(std::memory_order_acquire) == pos + count) {
+            count += 1;
+        }
+
+        if (count == 0) {
+            // The slot is either still holding the element of the previous lap, and the queue is full, or was
+            // already claimed by another producer, and the position is stale
+            intptr_t diff = (intptr_t)(cells_[pos & mask_].sequence.load(std::memory_order_acquire) - pos);
+            if (diff < 0) {
+                return 0;
+            }
+
+            pos = enqueuePos_.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        // The slots can only be handed out by moving the enqueue position past them, so they are still free if
+        // the position did not move
+        if (enqueuePos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+            return count;
+        }
+    }
+}
+
+template <typename T, typename Allocator>
+size_t mpmc_queue<T, Allocator>::claim_pop(size_t n, size_t& pos) {
+    pos = dequeuePos_.load(std::memory_order_relaxed);
+    if (n == 0) {
+        return 0;
+    }
+
+    for (;;) {
+        size_t count = 0;
+        while (count < n && cells_[(pos + count) & mask_].sequence.load(std::memory_order_acquire) == pos + count + 1) {
+            count += 1;
+        }
+
+        if (count == 0) {
+            intptr_t diff = (intptr_t)(cells_[pos & mask_].sequence.load(std::memory_order_acquire) - (pos + 1));
+            if (diff < 0) {
+                return 0;
+            }
+
+            pos = dequeuePos_.load(std::memory_order_relaxed);
+            continue;
+        }
+
+        if (dequeuePos_.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+            return count;
+        }
+    }
+}
+
+}
+
+#endif
@@ -0,0 +1,714 @@
+#ifndef SKETCH_STL_RANGES_H
+#define SKETCH_STL_RANGES_H
+
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/////////////////////////////////////////////////////////////////////////
+// VIEWS
+//
+// Lazy adaptors over vectors. A view holds its source by value and computes its elements when they are read, so a
+// pipeline such as vec | views::filter(p) | views::transform(f) | views::take(10) allocates nothing and reads the
+// source once, in the loop of whoever consumes it: a range-based for, for_each, or to_vector, which is the only
+// step that materializes the elements.
+//
+// Every view walks its elements with a cursor: first() gives the cursor of the first element, done(c) tells
+// whether c is past the last one, read(c) gives its element and next(c) moves to the following one. The adaptors
+// wrap the cursors of their source, so the compiler inlines a whole pipeline into one loop. Views whose size is
+// known without walking them, which is every view that has no filter upstream, also have size() and operator[].
+// A view refers to the elements of the vector it was made from, which must outlive it. Any other range with
+// begin() and end(), such as a generator or a channel, is a source too, but the views made from it can only be
+// walked once and their iterators are input iterators
+namespace views {
+
+/**
+ * @class view_base
+ * The base class of every view, which tells views apart from the other types
+ */
+struct view_base {
+};
+
+template <typename T>
+struct is_view : std::is_base_of<view_base, typename std::decay<T>::type> {
+};
+
+/**
+ * @class view_iterator
+ * Forward iterator over a view, or input iterator over a view that can only be walked once. The end iterator is a
+ * sentinel that compares equal to any iterator whose cursor is done
+ */
+template <typename View>
+class view_iterator {
+    public:
+        typedef typename std::conditional<View::single_pass, std::input_iterator_tag, std::forward_iterator_tag>::type iterator_category;
+        typedef typename View::value_type value_type;
+        typedef typename View::reference reference;
+        typedef ptrdiff_t difference_type;
+        typedef void pointer;
+
+        view_iterator() : view_(nullptr), cursor_(), end_(true) {}
+
+        /**
+         * Constructor
+         * @param view The view
+         * @param end Whether this is the end iterator
+         */
+        view_iterator(const View* view, bool end) : view_(view), cursor_(end ? typename View::cursor() : view->first()), end_(end) {}
+
+        reference operator*() const { return view_->read(cursor_); }
+
+        view_iterator& operator++() {
+            view_->next(cursor_);
+            return *this;
+        }
+
+        view_iterator operator++(int) {
+            view_iterator copy(*this);
+            view_->next(cursor_);
+            return copy;
+        }
+
+        bool operator==(const view_iterator& rhs) const;
+        bool operator!=(const view_iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        bool done() const { return end_ || view_->done(cursor_); }
+
+        const View*             view_;      /**< The view */
+        typename View::cursor   cursor_;    /**< The position in the view */
+        bool                    end_;       /**< Whether this is the end iterator */
+};
+
+/**
+ * @class view_interface
+ * The members every view derives from its cursor
+ */
+template <typename Derived>
+class view_interface : public view_base {
+    public:
+        typedef view_iterator<Derived> iterator;
+
+        iterator begin() const { return iterator(&derived(), false); }
+        iterator end() const { return iterator(&derived(), true); }
+
+        /**
+         * Call a function on every element, in a single loop
+         * @param f The function
+         */
+        template <typename F>
+        void for_each(F f) const;
+
+    private:
+        const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+/**
+ * @class ref_view
+ * The elements of a vector, or of any contiguous array
+ */
+template <typename T>
+class ref_view : public view_interface<ref_view<T>> {
+    public:
+        typedef typename std::remove_const<T>::type value_type;
+        typedef T& reference;
+        typedef size_t cursor;
+
+        static const bool sized = true;
+        static const bool single_pass = false;
+
+        ref_view() : data_(nullptr), length_(0) {}
+
+        /**
+         * Constructor
+         * @param data The first element
+         * @param length The number of elements
+         */
+        ref_view(T* data, size_t length) : data_(data), length_(length) {}
+
+        cursor first() const { return 0; }
+        bool done(cursor c) const { return c == length_; }
+        void next(cursor& c) const { c += 1; }
+        reference read(cursor c) const { return data_[c]; }
+
+        size_t size() const { return length_; }
+        reference operator[](size_t n) const { return assert(n < length_), data_[n]; }
+
+    private:
+        T*      data_;      /**< The first element */
+        size_t  length_;    /**< The number of elements */
+};
+
+/**
+ * @class input_view
+ * The elements of any other range with begin() and end(), such as a generator or a channel, walked through its
+ * iterators. Ranges that produce their elements as they are read can only be walked once
+ */
+template <typename Range>
+class input_view : public view_interface<input_view<Range>> {
+    public:
+        typedef decltype(std::declval<Range&>().begin()) cursor;
+        typedef decltype(*std::declval<const cursor&>()) reference;
+        typedef typename std::decay<reference>::type value_type;
+
+        static const bool sized = false;
+        static const bool single_pass = true;
+
+        explicit input_view(Range& range) : range_(&range) {}
+
+        cursor first() const { return range_->begin(); }
+        bool done(const cursor& c) const { return c == range_->end(); }
+        void next(cursor& c) const { ++c; }
+        reference read(const cursor& c) const { return *c; }
+
+    private:
+        Range*  range_;     /**< The range */
+};
+
+/**
+ * @class filter_view
+ * The elements of a view for which a predicate holds
+ */
+template <typename Base, typename Pred>
+class filter_view : public view_interface<filter_view<Base, Pred>> {
+    public:
+        typedef typename Base::value_type value_type;
+        typedef typename Base::reference reference;
+        typedef typename Base::cursor cursor;
+
+        static const bool sized = false;
+        static const bool single_pass = Base::single_pass;
+
+        filter_view(const Base& base, const Pred& pred) : base_(base), pred_(pred) {}
+
+        cursor first() const;
+        bool done(const cursor& c) const { return base_.done(c); }
+        void next(cursor& c) const;
+        reference read(const cursor& c) const { return base_.read(c); }
+
+    private:
+        /**
+         * Move a cursor to the next element for which the predicate holds, starting with its own
+         */
+        void skip(cursor& c) const;
+
+        Base    base_;  /**< The source */
+        Pred    pred_;  /**< The predicate */
+};
+
+/**
+ * @class transform_view
+ * The results of a function applied to every element of a view
+ */
+template <typename Base, typename F>
+class transform_view : public view_interface<transform_view<Base, F>> {
+    public:
+        typedef decltype(std::declval<const F&>()(std::declval<typename Base::reference>())) reference;
+        typedef typename std::decay<reference>::type value_type;
+        typedef typename Base::cursor cursor;
+
+        static const bool sized = Base::sized;
+        static const bool single_pass = Base::single_pass;
+
+        transform_view(const Base& base, const F& f) : base_(base), f_(f) {}
+
+        cursor first() const { return base_.first(); }
+        bool done(const cursor& c) const { return base_.done(c); }
+        void next(cursor& c) const { base_.next(c); }
+        reference read(const cursor& c) const { return f_(base_.read(c)); }
+
+        size_t size() const { return base_.size(); }
+        reference operator[](size_t n) const { return f_(base_[n]); }
+
+    private:
+        Base    base_;  /**< The source */
+        F       f_;     /**< The function */
+};
+
+/**
+ * @class take_view
+ * The first elements of a view. Walking it stops after them, even when its source goes on
+ */
+template <typename Base>
+class take_view : public view_interface<take_view<Base>> {
+    public:
+        typedef typename Base::value_type value_type;
+        typedef typename Base::reference reference;
+        typedef std::pair<typename Base::cursor, size_t> cursor;
+
+        static const bool sized = Base::sized;
+        static const bool single_pass = Base::single_pass;
+
+        take_view(const Base& base, size_t count) : base_(base), count_(count) {}
+
+        cursor first() const { return cursor(base_.first(), 0); }
+        bool done(const cursor& c) const { return c.second == count_ || base_.done(c.first); }
+        void next(cursor& c) const;
+        reference read(const cursor& c) const { return base_.read(c.first); }
+
+        size_t size() const { return base_.size() < count_ ? base_.size() : count_; }
+        reference operator[](size_t n) const { return assert(n < size()), base_[n]; }
+
+    private:
+        Base    base_;  /**< The source */
+        size_t  count_; /**< The number of elements to keep */
+};
+
+/**
+ * @class drop_view
+ * The elements of a view after the first ones
+ */
+template <typename Base>
+class drop_view : public view_interface<drop_view<Base>> {
+    public:
+        typedef typename Base::value_type value_type;
+        typedef typename Base::reference reference;
+        typedef typename Base::cursor cursor;
+
+        static const bool sized = Base::sized;
+        static const bool single_pass = Base::single_pass;
+
+        drop_view(const Base& base, size_t count) : base_(base), count_(count) {}
+
+        cursor first() const;
+        bool done(const cursor& c) const { return base_.done(c); }
+        void next(cursor& c) const { base_.next(c); }
+        reference read(const cursor& c) const { return base_.read(c); }
+
+        size_t size() const { return base_.size() > count_ ? base_.size() - count_ : 0; }
+        reference operator[](size_t n) const { return assert(n < size()), base_[count_ + n]; }
+
+    private:
+        Base    base_;  /**< The source */
+        size_t  count_; /**< The number of elements to skip */
+};
+
+/**
+ * @class zip_view
+ * Pairs of the elements at the same position in two views, as long as the shorter one
+ */
+template <typename First, typename Second>
+class zip_view : public view_interface<zip_view<First, Second>> {
+    public:
+        typedef std::pair<typename First::value_type, typename Second::value_type> value_type;
+        typedef std::pair<typename First::reference, typename Second::reference> reference;
+        typedef std::pair<typename First::cursor, typename Second::cursor> cursor;
+
+        static const bool sized = First::sized && Second::sized;
+        static const bool single_pass = First::single_pass || Second::single_pass;
+
+        zip_view(const First& first, const Second& second) : first_(first), second_(second) {}
+
+        cursor first() const { return cursor(first_.first(), second_.first()); }
+        bool done(const cursor& c) const { return first_.done(c.first) || second_.done(c.second); }
+        void next(cursor& c) const;
+        reference read(const cursor& c) const { return reference(first_.read(c.first), second_.read(c.second)); }
+
+        size_t size() const { return first_.size() < second_.size() ? first_.size() : second_.size(); }
+        reference operator[](size_t n) const { return reference(first_[n], second_[n]); }
+
+    private:
+        First   first_;     /**< The view of the first elements */
+        Second  second_;    /**< The view of the second elements */
+};
+
+/**
+ * @class enumerate_view
+ * Pairs of the position of every element of a view and of the element
+ */
+template <typename Base>
+class enumerate_view : public view_interface<enumerate_view<Base>> {
+    public:
+        typedef std::pair<size_t, typename Base::value_type> value_type;
+        typedef std::pair<size_t, typename Base::reference> reference;
+        typedef std::pair<size_t, typename Base::cursor> cursor;
+
+        static const bool sized = Base::sized;
+        static const bool single_pass = Base::single_pass;
+
+        explicit enumerate_view(const Base& base) : base_(base) {}
+
+        cursor first() const { return cursor(0, base_.first()); }
+        bool done(const cursor& c) const { return base_.done(c.second); }
+        void next(cursor& c) const;
+        reference read(const cursor& c) const { return reference(c.first, base_.read(c.second)); }
+
+        size_t size() const { return base_.size(); }
+        reference operator[](size_t n) const { return reference(n, base_[n]); }
+
+    private:
+        Base    base_;  /**< The source */
+};
+
+/**
+ * @class slice_view
+ * Consecutive elements of a view of known size, reached through its operator[]
+ */
+template <typename Base>
+class slice_view : public view_interface<slice_view<Base>> {
+    public:
+        typedef typename Base::value_type value_type;
+        typedef typename Base::reference reference;
+        typedef size_t cursor;
+
+        static const bool sized = true;
+        static const bool single_pass = Base::single_pass;
+
+        /**
+         * Constructor
+         * @param base The source
+         * @param pos The position of the first element in the source
+         * @param length The number of elements
+         */
+        slice_view(const Base& base, size_t pos, size_t length) : base_(base), pos_(pos), length_(length) {}
+
+        cursor first() const { return 0; }
+        bool done(cursor c) const { return c == length_; }
+        void next(cursor& c) const { c += 1; }
+        reference read(cursor c) const { return base_[pos_ + c]; }
+
+        size_t size() const { return length_; }
+        reference operator[](size_t n) const { return assert(n < length_), base_[pos_ + n]; }
+
+    private:
+        Base    base_;      /**< The source */
+        size_t  pos_;       /**< The position of the first element in the source */
+        size_t  length_;    /**< The number of elements */
+};
+
+/**
+ * @class chunk_view
+ * The elements of a view of known size cut into slices of the same length, except for the last one which may be
+ * shorter
+ */
+template <typename Base>
+class chunk_view : public view_interface<chunk_view<Base>> {
+    static_assert(Base::sized, "Only views of known size can be cut into chunks");
+
+    public:
+        typedef slice_view<Base> value_type;
+        typedef slice_view<Base> reference;
+        typedef size_t cursor;
+
+        static const bool sized = true;
+        static const bool single_pass = Base::single_pass;
+
+        chunk_view(const Base& base, size_t length) : base_(base), length_(length) { assert(length > 0); }
+
+        cursor first() const { return 0; }
+        bool done(cursor c) const { return c == size(); }
+        void next(cursor& c) const { c += 1; }
+        reference read(cursor c) const { return (*this)[c]; }
+
+        size_t size() const { return (base_.size() + length_ - 1) / length_; }
+        reference operator[](size_t n) const;
+
+    private:
+        Base    base_;      /**< The source */
+        size_t  length_;    /**< The number of elements of every chunk */
+};
+
+/**
+ * Return the view of every element of a vector
+ * @param vec The vector
+ */
+template <typename T, typename Allocator, typename SizeType>
+ref_view<T> all(vector<T, Allocator, SizeType>& vec) {
+    return ref_view<T>(vec.data(), vec.size());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+ref_view<const T> all(const vector<T, Allocator, SizeType>& vec) {
+    return ref_view<const T>(vec.data(), vec.size());
+}
+
+/**
+ * A view would outlive a temporary vector
+ */
+template <typename T, typename Allocator, typename SizeType>
+void all(vector<T, Allocator, SizeType>&& vec) = delete;
+
+template <typename View, typename=typename std::enable_if<is_view<View>::value>::type>
+const View& all(const View& view) {
+    return view;
+}
+
+/**
+ * Return the view of the elements of any other range. Like a vector, the range must outlive the view
+ * @param range The range
+ */
+template <typename Range, typename=typename std::enable_if<!is_view<Range>::value>::type, typename=decltype(std::declval<Range&>().begin())>
+input_view<Range> all(Range& range) {
+    return input_view<Range>(range);
+}
+
+/**
+ * @class adaptor_base
+ * The base class of the adaptors that go on the right of a | in a pipeline. Each one makes a view from the view
+ * on its left
+ */
+struct adaptor_base {
+};
+
+template <typename Pred>
+struct filter_adaptor : adaptor_base {
+    explicit filter_adaptor(const Pred& p) : pred(p) {}
+
+    Pred pred;
+
+    template <typename Base>
+    filter_view<Base, Pred> operator()(const Base& base) const { return filter_view<Base, Pred>(base, pred); }
+};
+
+template <typename F>
+struct transform_adaptor : adaptor_base {
+    explicit transform_adaptor(const F& fn) : f(fn) {}
+
+    F f;
+
+    template <typename Base>
+    transform_view<Base, F> operator()(const Base& base) const { return transform_view<Base, F>(base, f); }
+};
+
+struct take_adaptor : adaptor_base {
+    explicit take_adaptor(size_t n) : count(n) {}
+
+    size_t count;
+
+    template <typename Base>
+    take_view<Base> operator()(const Base& base) const { return take_view<Base>(base, count); }
+};
+
+struct drop_adaptor : adaptor_base {
+    explicit drop_adaptor(size_t n) : count(n) {}
+
+    size_t count;
+
+    template <typename Base>
+    drop_view<Base> operator()(const Base& base) const { return drop_view<Base>(base, count); }
+};
+
+struct enumerate_adaptor : adaptor_base {
+    template <typename Base>
+    enumerate_view<Base> operator()(const Base& base) const { return enumerate_view<Base>(base); }
+};
+
+struct chunk_adaptor : adaptor_base {
+    explicit chunk_adaptor(size_t n) : length(n) {}
+
+    size_t length;
+
+    template <typename Base>
+    chunk_view<Base> operator()(const Base& base) const { return chunk_view<Base>(base, length); }
+};
+
+struct to_vector_adaptor : adaptor_base {
+    template <typename Base>
+    vector<typename Base::value_type> operator()(const Base& base) const;
+};
+
+/**
+ * Keep the elements for which a predicate holds
+ * @param pred The predicate
+ */
+template <typename Pred>
+filter_adaptor<Pred> filter(Pred pred) {
+    return filter_adaptor<Pred>(pred);
+}
+
+/**
+ * Replace every element by the result of a function
+ * @param f The function
+ */
+template <typename F>
+transform_adaptor<F> transform(F f) {
+    return transform_adaptor<F>(f);
+}
+
+/**
+ * Keep the first elements
+ * @param count The number of elements to keep
+ */
+inline take_adaptor take(size_t count) {
+    return take_adaptor(count);
+}
+
+/**
+ * Skip the first elements
+ * @param count The number of elements to skip
+ */
+inline drop_adaptor drop(size_t count) {
+    return drop_adaptor(count);
+}
+
+/**
+ * Pair every element with its position
+ */
+inline enumerate_adaptor enumerate() {
+    return enumerate_adaptor();
+}
+
+/**
+ * Cut the elements into slices
+ * @param length The number of elements of every slice but the last one. Must not be 0
+ */
+inline chunk_adaptor chunk(size_t length) {
+    return chunk_adaptor(length);
+}
+
+/**
+ * Pair the elements of two vectors or views at the same position
+ * @param first The first elements
+ * @param second The second elements
+ */
+template <typename First, typename Second>
+auto zip(First&& first, Second&& second) -> zip_view<typename std::decay<decltype(views::all(std::forward<First>(first)))>::type, typename std::decay<decltype(views::all(std::forward<Second>(second)))>::type> {
+    typedef typename std::decay<decltype(views::all(std::forward<First>(first)))>::type first_view;
+    typedef typename std::decay<decltype(views::all(std::forward<Second>(second)))>::type second_view;
+    return zip_view<first_view, second_view>(views::all(std::forward<First>(first)), views::all(std::forward<Second>(second)));
+}
+
+/**
+ * Copy or move the elements of a view into a new vector, in a single pass
+ * @param view The view
+ */
+template <typename View>
+vector<typename View::value_type> to_vector(const View& view);
+
+inline to_vector_adaptor to_vector() {
+    return to_vector_adaptor();
+}
+
+/**
+ * Apply an adaptor to a vector or to a view
+ * @param range The vector or the view
+ * @param adaptor The adaptor
+ */
+template <typename Range, typename Adaptor, typename=typename std::enable_if<std::is_base_of<adaptor_base, Adaptor>::value>::type>
+auto operator|(Range&& range, const Adaptor& adaptor) -> decltype(adaptor(views::all(std::forward<Range>(range)))) {
+    return adaptor(views::all(std::forward<Range>(range)));
+}
+
+/////////////////////////////////////////////////////////////////////////
+template <typename View>
+bool view_iterator<View>::operator==(const view_iterator<View>& rhs) const {
+    if (end_ || rhs.end_) {
+        return done() == rhs.done();
+    }
+
+    return cursor_ == rhs.cursor_;
+}
+
+template <typename Derived>
+template <typename F>
+void view_interface<Derived>::for_each(F f) const {
+    const Derived& view = derived();
+    for (typename Derived::cursor c = view.first(); !view.done(c); view.next(c)) {
+        f(view.read(c));
+    }
+}
+
+template <typename Base, typename Pred>
+typename filter_view<Base, Pred>::cursor filter_view<Base, Pred>::first() const {
+    cursor c = base_.first();
+    skip(c);
+    return c;
+}
+
+template <typename Base, typename Pred>
+void filter_view<Base, Pred>::next(cursor& c) const {
+    base_.next(c);
+    skip(c);
+}
+
+template <typename Base, typename Pred>
+void filter_view<Base, Pred>::skip(cursor& c) const {
+    while (!base_.done(c) && !pred_(base_.read(c))) {
+        base_.next(c);
+    }
+}
+
+template <typename Base>
+void take_view<Base>::next(cursor& c) const {
+    // The source is not moved past the last element taken, which could make a filter read further
+    c.second += 1;
+    if (c.second < count_) {
+        base_.next(c.first);
+    }
+}
+
+template <typename Base>
+typename drop_view<Base>::cursor drop_view<Base>::first() const {
+    cursor c = base_.first();
+    for (size_t i = 0; i < count_ && !base_.done(c); i++) {
+        base_.next(c);
+    }
+
+    return c;
+}
+
+template <typename First, typename Second>
+void zip_view<First, Second>::next(cursor& c) const {
+    first_.next(c.first);
+    second_.next(c.second);
+}
+
+template <typename Base>
+void enumerate_view<Base>::next(cursor& c) const {
+    c.first += 1;
+    base_.next(c.second);
+}
+
+template <typename Base>
+slice_view<Base> chunk_view<Base>::operator[](size_t n) const {
+    assert(n < size());
+
+    size_t pos = n * length_;
+    size_t left = base_.size() - pos;
+    return slice_view<Base>(base_, pos, left < length_ ? left : length_);
+}
+
+/**
+ * Make a vector able to hold the elements of a view, when their number is known without walking it
+ */
+template <typename T, typename View>
+void reserve_for(vector<T>& out, const View& view, std::true_type) {
+    out.reserve(view.size());
+}
+
+template <typename T, typename View>
+void reserve_for(vector<T>&, const View&, std::false_type) {
+}
+
+template <typename View>
+vector<typename View::value_type> to_vector(const View& view) {
+    typedef typename View::value_type value_type;
+    typedef typename View::reference reference;
+
+    vector<value_type> out;
+    views::reserve_for(out, view, std::integral_constant<bool, View::sized>());
+
+    view.for_each([&out](reference val) {
+        out.push_back(value_type(std::forward<reference>(val)));
+    });
+
+    return out;
+}
+
+template <typename Base>
+vector<typename Base::value_type> to_vector_adaptor::operator()(const Base& base) const {
+    return views::to_vector(base);
+}
+
+}
+
+}
+
+#endif
@@ -0,0 +1,344 @@
+#ifndef SKETCH_STL_SEGMENTED_VECTOR_H
+#define SKETCH_STL_SEGMENTED_VECTOR_H
+
+#include "sketch_memory.h"
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class segmented_iterator
+ * Random access iterator over a segmented_vector. It refers to an element by its index and finds its
+ * chunk through the chunk table, so it is invalidated when the table grows, like the iterators of a deque
+ */
+template <typename T, size_t ChunkSize>
+class segmented_iterator {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef ptrdiff_t difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        segmented_iterator() : chunks_(nullptr), index_(0) {}
+        segmented_iterator(T* const* chunks, size_t index) : chunks_(chunks), index_(index) {}
+
+        T& operator*() const { return chunks_[index_ / ChunkSize][index_ % ChunkSize]; }
+        T* operator->() const { return &(**this); }
+        T& operator[](ptrdiff_t n) const { return *(*this + n); }
+
+        segmented_iterator& operator++() { index_++; return *this; }
+        segmented_iterator operator++(int) { segmented_iterator copy(*this); index_++; return copy; }
+        segmented_iterator& operator--() { index_--; return *this; }
+        segmented_iterator operator--(int) { segmented_iterator copy(*this); index_--; return copy; }
+
+        segmented_iterator& operator+=(ptrdiff_t n) { index_ += n; return *this; }
+        segmented_iterator& operator-=(ptrdiff_t n) { index_ -= n; return *this; }
+        segmented_iterator operator+(ptrdiff_t n) const { return segmented_iterator(chunks_, index_ + n); }
+        segmented_iterator operator-(ptrdiff_t n) const { return segmented_iterator(chunks_, index_ - n); }
+        friend segmented_iterator operator+(ptrdiff_t n, const segmented_iterator& rhs) { return rhs + n; }
+        ptrdiff_t operator-(const segmented_iterator& rhs) const { return (ptrdiff_t)index_ - (ptrdiff_t)rhs.index_; }
+
+        bool operator==(const segmented_iterator& rhs) const { return index_ == rhs.index_; }
+        bool operator!=(const segmented_iterator& rhs) const { return index_ != rhs.index_; }
+        bool operator<(const segmented_iterator& rhs) const { return index_ < rhs.index_; }
+        bool operator>(const segmented_iterator& rhs) const { return index_ > rhs.index_; }
+        bool operator<=(const segmented_iterator& rhs) const { return index_ <= rhs.index_; }
+        bool operator>=(const segmented_iterator& rhs) const { return index_ >= rhs.index_; }
+
+    private:
+        T* const*   chunks_;    /**< The chunk table of the container */
+        size_t      index_;     /**< The index of the element in the container */
+};
+
+/**
+ * @class segmented_vector
+ * This class represents a dynamic array made of fixed-size chunks of ChunkSize elements, reached through a chunk
+ * table. Appending never moves existing elements, so their addresses stay valid for the lifetime of the element,
+ * and there is no reallocation spike: growing only allocates one new chunk and, rarely, grows the table of pointers.
+ * Indexed access is O(1)
+ */
+template <typename T, size_t ChunkSize=256, typename Allocator=allocator>
+class segmented_vector {
+    static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "The chunk size must be a power of two");
+
+    public:
+        typedef segmented_iterator<T, ChunkSize> iterator;
+        typedef const segmented_iterator<T, ChunkSize> const_iterator;
+
+        /**
+         * Default constructor
+         * Constructs an empty container without allocating any chunk
+         */
+        segmented_vector();
+
+        /**
+         * Fill constructor
+         * @param n The number of elements
+         * @param val The value to fill the container with
+         */
+        segmented_vector(size_t n, const T& val=T());
+
+        /**
+         * Copy constructor
+         * @param src The container to copy
+         */
+        segmented_vector(const segmented_vector& src);
+
+        /**
+         * Destructor
+         * Destroys the elements and frees the chunks
+         */
+        ~segmented_vector();
+
+        /**
+         * Assignment operator
+         * @param rhs The container to assign to this one
+         */
+        segmented_vector& operator=(const segmented_vector& rhs);
+
+        iterator begin() { return iterator(chunks_.data(), 0); }
+        const_iterator begin() const { return iterator(const_cast<T**>(chunks_.data()), 0); }
+        iterator end() { return iterator(chunks_.data(), length_); }
+        const_iterator end() const { return iterator(const_cast<T**>(chunks_.data()), length_); }
+
+        T& front() { return (*this)[0]; }
+        const T& front() const { return (*this)[0]; }
+        T& back() { return (*this)[length_ - 1]; }
+        const T& back() const { return (*this)[length_ - 1]; }
+
+        size_t size() const { return length_; }
+        size_t capacity() const { return chunks_.size() * ChunkSize; }
+        bool empty() const { return length_ == 0; }
+
+        /**
+         * Access element
+         * @param n The position at which we want to access the element
+         */
+        T& operator[](size_t n);
+        const T& operator[](size_t n) const;
+
+        /**
+         * Returns a reference to the element at position n in the container
+         * @param n The position at which we want to access the element
+         */
+        T& at(size_t n);
+        const T& at(size_t n) const;
+
+        /**
+         * Allocate the chunks needed to hold n elements. Existing elements are never moved
+         * @param n The number of elements the container must be able to hold without allocating
+         */
+        void reserve(size_t n);
+
+        /**
+         * Add an element at the end of the container. The addresses of the other elements are not modified
+         * @param val The value to add at the end
+         */
+        void push_back(const T& val);
+        void push_back(T&& val);
+
+        /**
+         * Add n default-constructed elements at the end of the container
+         * @param n The number of elements to add
+         * @return The index of the first added element
+         */
+        size_t grow_by(size_t n);
+
+        /**
+         * Remove the last element of the container. The chunk stays allocated
+         */
+        void pop_back();
+
+        /**
+         * Destroy every element. The chunks stay allocated
+         */
+        void clear();
+
+        /**
+         * Free the chunks that hold no element
+         */
+        void shrink_to_fit();
+
+        /**
+         * Return the number of chunks that hold at least one element
+         */
+        size_t chunk_count() const { return (length_ + ChunkSize - 1) / ChunkSize; }
+
+        /**
+         * Return a pointer to the contiguous elements of a chunk, for chunk-wise processing
+         * @param n The index of the chunk
+         */
+        T* chunk(size_t n) { return chunks_[n]; }
+        const T* chunk(size_t n) const { return chunks_[n]; }
+
+        /**
+         * Return the number of elements stored in a chunk
+         * @param n The index of the chunk
+         */
+        size_t chunk_size(size_t n) const;
+
+    private:
+        /**
+         * Return the address of the slot at index n, allocating its chunk if needed
+         * @param n The index of the slot
+         */
+        T* slot(size_t n);
+
+        vector<T*>  chunks_;    /**< The chunk table */
+        size_t      length_;    /**< The number of elements */
+};
+
+template <typename T, size_t ChunkSize, typename Allocator>
+segmented_vector<T, ChunkSize, Allocator>::segmented_vector() : chunks_(), length_(0) {
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+segmented_vector<T, ChunkSize, Allocator>::segmented_vector(size_t n, const T& val) : chunks_(), length_(0) {
+    reserve(n);
+    for (size_t i = 0; i < n; i++) {
+        push_back(val);
+    }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+segmented_vector<T, ChunkSize, Allocator>::segmented_vector(const segmented_vector& src) : chunks_(), length_(0) {
+    reserve(src.length_);
+    for (size_t i = 0; i < src.length_; i++) {
+        push_back(src[i]);
+    }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+segmented_vector<T, ChunkSize, Allocator>::~segmented_vector() {
+    clear();
+    shrink_to_fit();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+segmented_vector<T, ChunkSize, Allocator>& segmented_vector<T, ChunkSize, Allocator>::operator=(const segmented_vector& rhs) {
+    if (this != &rhs) {
+        clear();
+
+        reserve(rhs.length_);
+        for (size_t i = 0; i < rhs.length_; i++) {
+            push_back(rhs[i]);
+        }
+    }
+
+    return *this;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+T& segmented_vector<T, ChunkSize, Allocator>::operator[](size_t n) {
+    assert(n < length_);
+    return chunks_[n / ChunkSize][n % ChunkSize];
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+const T& segmented_vector<T, ChunkSize, Allocator>::operator[](size_t n) const {
+    assert(n < length_);
+    return chunks_[n / ChunkSize][n % ChunkSize];
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+T& segmented_vector<T, ChunkSize, Allocator>::at(size_t n) {
+    assert(n < length_);
+    return chunks_[n / ChunkSize][n % ChunkSize];
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+const T& segmented_vector<T, ChunkSize, Allocator>::at(size_t n) const {
+    assert(n < length_);
+    return chunks_[n / ChunkSize][n % ChunkSize];
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void segmented_vector<T, ChunkSize, Allocator>::reserve(size_t n) {
+    size_t chunkCount = (n + ChunkSize - 1) / ChunkSize;
+    if (chunkCount > chunks_.size()) {
+        chunks_.reserve(chunkCount);
+    }
+
+    while (chunks_.size() < chunkCount) {
+        chunks_.push_back((T*)Allocator::allocate(sizeof(T) * ChunkSize));
+    }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void segmented_vector<T, ChunkSize, Allocator>::push_back(const T& val) {
+    new (slot(length_)) T(val);
+    length_ += 1;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void segmented_vector<T, ChunkSize, Allocator>::push_back(T&& val) {
+    new (slot(length_)) T(std::move(val));
+    length_ += 1;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+size_t segmented_vector<T, ChunkSize, Allocator>::grow_by(size_t n) {
+    size_t first = length_;
+
+    reserve(length_ + n);
+    for (size_t i = 0; i < n; i++) {
+        new (slot(length_)) T();
+        length_ += 1;
+    }
+
+    return first;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void segmented_vector<T, ChunkSize, Allocator>::pop_back() {
+    length_ -= 1;
+    chunks_[length_ / ChunkSize][length_ % ChunkSize].~T();
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void segmented_vector<T, ChunkSize, Allocator>::clear() {
+    for (size_t i = 0; i < length_; i++) {
+        chunks_[i / ChunkSize][i % ChunkSize].~T();
+    }
+    length_ = 0;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+void segmented_vector<T, ChunkSize, Allocator>::shrink_to_fit() {
+    while (chunks_.size() > chunk_count()) {
+        Allocator::deallocate(chunks_.back());
+        chunks_.pop_back();
+    }
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+size_t segmented_vector<T, ChunkSize, Allocator>::chunk_size(size_t n) const {
+    assert(n < chunk_count());
+
+    if (n + 1 < chunk_count()) {
+        return ChunkSize;
+    }
+
+    return length_ - n * ChunkSize;
+}
+
+template <typename T, size_t ChunkSize, typename Allocator>
+T* segmented_vector<T, ChunkSize, Allocator>::slot(size_t n) {
+    if (n / ChunkSize >= chunks_.size()) {
+        chunks_.push_back((T*)Allocator::allocate(sizeof(T) * ChunkSize));
+    }
+
+    return &chunks_[n / ChunkSize][n % ChunkSize];
+}
+
+}
+
+#endif
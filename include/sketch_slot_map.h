@@ -0,0 +1,253 @@
+#ifndef SKETCH_STL_SLOT_MAP_H
+#define SKETCH_STL_SLOT_MAP_H
+
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class slot_handle
+ * Stable reference to a value of a slot_map. It names a slot and the generation of the slot at the time the
+ * value was inserted, so a handle to an erased value is detected even after its slot was reused
+ */
+struct slot_handle {
+    static const uint32_t npos = 0xFFFFFFFF;
+
+    slot_handle() : index(npos), generation(0) {}
+    slot_handle(uint32_t index, uint32_t generation) : index(index), generation(generation) {}
+
+    bool operator==(const slot_handle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+    bool operator!=(const slot_handle& rhs) const { return !(*this == rhs); }
+
+    uint32_t index;         /**< The slot of the value */
+    uint32_t generation;    /**< The generation of the slot when the value was inserted */
+};
+
+/**
+ * @class slot_map
+ * This class represents an unordered collection of values reached through generational handles. The values are
+ * kept packed in a vector, so iterating over them is a linear walk over contiguous memory, and a table of slots
+ * maps every handle to the current position of its value. Insertion and erasure are O(1): erasing moves the last
+ * value into the hole and frees the slot, which goes on a free list and is reused by the next insertion with a
+ * new generation, so stale handles never reach the wrong value
+ */
+template <typename T>
+class slot_map {
+    public:
+        typedef typename vector<T>::iterator iterator;
+        typedef typename vector<T>::const_iterator const_iterator;
+
+        /**
+         * Default constructor
+         * Constructs an empty container
+         */
+        slot_map() : freeHead_(slot_handle::npos) {}
+
+        iterator begin() { return values_.begin(); }
+        const_iterator begin() const { return values_.begin(); }
+        iterator end() { return values_.end(); }
+        const_iterator end() const { return values_.end(); }
+
+        /**
+         * Return the packed array of values. The order is unspecified and changes when values are erased
+         */
+        T* data() { return values_.data(); }
+        const T* data() const { return values_.data(); }
+
+        size_t size() const { return values_.size(); }
+        bool empty() const { return values_.empty(); }
+
+        /**
+         * Reserve room for n values, in the packed array and in the slot table
+         * @param n The number of values
+         */
+        void reserve(size_t n);
+
+        /**
+         * Add a value to the container
+         * @param val The value to add
+         * @return The handle of the value
+         */
+        slot_handle insert(const T& val);
+        slot_handle insert(T&& val);
+
+        /**
+         * Remove the value of a handle. Does nothing if the handle is stale
+         * @param handle The handle of the value
+         * @return true if a value was removed
+         */
+        bool erase(slot_handle handle);
+
+        /**
+         * Tell whether a handle still refers to a value of the container
+         * @param handle The handle to check
+         */
+        bool contains(slot_handle handle) const;
+
+        /**
+         * Return the value of a handle, or nullptr if the handle is stale
+         * @param handle The handle of the value
+         */
+        T* find(slot_handle handle);
+        const T* find(slot_handle handle) const;
+
+        /**
+         * Access the value of a handle. The handle must not be stale
+         * @param handle The handle of the value
+         */
+        T& operator[](slot_handle handle);
+        const T& operator[](slot_handle handle) const;
+
+        /**
+         * Return the handle of the value at a position of the packed array
+         * @param n The position of the value
+         */
+        slot_handle handle_at(size_t n) const;
+
+        /**
+         * Remove every value. Every outstanding handle becomes stale
+         */
+        void clear();
+
+    private:
+        struct slot {
+            uint32_t position;      /**< The position of the value when the slot is used, the next free slot otherwise */
+            uint32_t generation;    /**< Incremented every time the value of the slot is erased */
+        };
+
+        /**
+         * Take a slot from the free list, or add one to the table, and point it at the end of the packed array
+         * @return The handle of the slot
+         */
+        slot_handle acquire_slot();
+
+        vector<T>           values_;    /**< The packed values */
+        vector<uint32_t>    owners_;    /**< The slot of every packed value */
+        vector<slot>        slots_;     /**< The slot table */
+        uint32_t            freeHead_;  /**< The first free slot, or npos */
+};
+
+template <typename T>
+void slot_map<T>::reserve(size_t n) {
+    values_.reserve(n);
+    owners_.reserve(n);
+    slots_.reserve(n);
+}
+
+template <typename T>
+slot_handle slot_map<T>::insert(const T& val) {
+    slot_handle handle = acquire_slot();
+    values_.push_back(val);
+    owners_.push_back(handle.index);
+
+    return handle;
+}
+
+template <typename T>
+slot_handle slot_map<T>::insert(T&& val) {
+    slot_handle handle = acquire_slot();
+    values_.push_back(std::move(val));
+    owners_.push_back(handle.index);
+
+    return handle;
+}
+
+template <typename T>
+bool slot_map<T>::erase(slot_handle handle) {
+    if (!contains(handle)) {
+        return false;
+    }
+
+    slot& erased = slots_[handle.index];
+    uint32_t position = erased.position;
+
+    // The last value takes the place of the erased one, so its slot has to follow it
+    slots_[owners_.back()].position = position;
+    values_.unordered_erase(values_.begin() + position);
+    owners_.unordered_erase(owners_.begin() + position);
+
+    erased.generation += 1;
+    erased.position = freeHead_;
+    freeHead_ = handle.index;
+
+    return true;
+}
+
+template <typename T>
+bool slot_map<T>::contains(slot_handle handle) const {
+    return handle.index < slots_.size() && slots_[handle.index].generation == handle.generation;
+}
+
+template <typename T>
+T* slot_map<T>::find(slot_handle handle) {
+    return contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+}
+
+template <typename T>
+const T* slot_map<T>::find(slot_handle handle) const {
+    return contains(handle) ? &values_[slots_[handle.index].position] : nullptr;
+}
+
+template <typename T>
+T& slot_map<T>::operator[](slot_handle handle) {
+    assert(contains(handle));
+    return values_[slots_[handle.index].position];
+}
+
+template <typename T>
+const T& slot_map<T>::operator[](slot_handle handle) const {
+    assert(contains(handle));
+    return values_[slots_[handle.index].position];
+}
+
+template <typename T>
+slot_handle slot_map<T>::handle_at(size_t n) const {
+    uint32_t index = owners_[n];
+    return slot_handle(index, slots_[index].generation);
+}
+
+template <typename T>
+void slot_map<T>::clear() {
+    for (size_t i = 0; i < owners_.size(); i++) {
+        slot& used = slots_[owners_[i]];
+        used.generation += 1;
+        used.position = freeHead_;
+        freeHead_ = owners_[i];
+    }
+
+    values_.clear();
+    owners_.clear();
+}
+
+template <typename T>
+slot_handle slot_map<T>::acquire_slot() {
+    uint32_t position = (uint32_t)values_.size();
+
+    if (freeHead_ != slot_handle::npos) {
+        uint32_t index = freeHead_;
+        slot& reused = slots_[index];
+        freeHead_ = reused.position;
+        reused.position = position;
+
+        return slot_handle(index, reused.generation);
+    }
+
+    assert(slots_.size() < slot_handle::npos);
+
+    slot created;
+    created.position = position;
+    created.generation = 0;
+    slots_.push_back(created);
+
+    return slot_handle((uint32_t)(slots_.size() - 1), 0);
+}
+
+}
+
+#endif
@@ -0,0 +1,301 @@
+#ifndef SKETCH_STL_SOA_VECTOR_H
+#define SKETCH_STL_SOA_VECTOR_H
+
+#include "sketch_memory.h"
+#include "sketch_span.h"
+#include "sketch_vector.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class soa_row
+ * Proxy reference to one row of a soa_vector. It holds a pointer to the field of the row in every column, so
+ * that code written against an array of structures keeps working: fields are reached with get<I>(), and the
+ * whole row can be read or written as a tuple
+ */
+template <typename... Ts>
+class soa_row {
+    public:
+        /**
+         * Constructor
+         * @param fields The address of the row in every column
+         */
+        soa_row(Ts*... fields) : fields_(fields...) {}
+        soa_row(const soa_row& src) = default;
+
+        /**
+         * Return a field of the row
+         */
+        template <size_t I>
+        typename std::tuple_element<I, std::tuple<Ts...>>::type& get() const { return *std::get<I>(fields_); }
+
+        /**
+         * Assign every field of the row
+         * @param values The new values, in column order
+         */
+        const soa_row& operator=(const std::tuple<typename std::remove_const<Ts>::type...>& values) const;
+
+        /**
+         * Assign the fields of another row. The proxy keeps referring to the same row
+         * @param rhs The row to copy
+         */
+        const soa_row& operator=(const soa_row& rhs) const;
+
+        /**
+         * Copy the row out of the container
+         */
+        operator std::tuple<typename std::remove_const<Ts>::type...>() const;
+
+    private:
+        template <size_t... Is>
+        void assign(const std::tuple<typename std::remove_const<Ts>::type...>& values, std::index_sequence<Is...>) const;
+
+        template <size_t... Is>
+        std::tuple<typename std::remove_const<Ts>::type...> copy(std::index_sequence<Is...>) const;
+
+        std::tuple<Ts*...> fields_;     /**< The address of the row in every column */
+};
+
+/**
+ * @class soa_vector
+ * This class represents a dynamic array of records stored as a structure of arrays: every field Ts lives in its
+ * own contiguous column, and all the columns grow together. A kernel that only reads one or two fields then
+ * streams through exactly those columns instead of fetching whole records. The columns are aligned on a cache
+ * line and can be handed to kernels as spans, while operator[] returns a soa_row proxy for record-style code
+ */
+template <typename... Ts>
+class soa_vector {
+    static_assert(sizeof...(Ts) > 0, "A soa_vector needs at least one column");
+
+    public:
+        typedef soa_row<Ts...> reference;
+        typedef soa_row<const Ts...> const_reference;
+
+        /**
+         * The type of the field of a column
+         */
+        template <size_t I>
+        using column_type = typename std::tuple_element<I, std::tuple<Ts...>>::type;
+
+        /**
+         * Default constructor
+         * Constructs an empty container
+         */
+        soa_vector() {}
+
+        /**
+         * Return a view over a column, for kernels that process one field of every row
+         */
+        template <size_t I>
+        span<column_type<I>> column() { return span<column_type<I>>(std::get<I>(columns_).data(), size()); }
+        template <size_t I>
+        span<const column_type<I>> column() const { return span<const column_type<I>>(std::get<I>(columns_).data(), size()); }
+
+        /**
+         * Access a row
+         * @param n The position of the row
+         */
+        reference operator[](size_t n);
+        const_reference operator[](size_t n) const;
+
+        /**
+         * Access a single field of a row
+         * @param n The position of the row
+         */
+        template <size_t I>
+        column_type<I>& get(size_t n) { return std::get<I>(columns_)[n]; }
+        template <size_t I>
+        const column_type<I>& get(size_t n) const { return std::get<I>(columns_)[n]; }
+
+        size_t size() const { return std::get<0>(columns_).size(); }
+        bool empty() const { return size() == 0; }
+
+        /**
+         * Return the number of rows every column can hold without reallocating. The columns round their capacity
+         * to whole cache lines of their own type, so this is the smallest of them
+         */
+        size_t capacity() const { return min_capacity(std::index_sequence_for<Ts...>()); }
+
+        /**
+         * Make every column able to hold n rows without reallocating
+         * @param n The number of rows
+         */
+        void reserve(size_t n);
+
+        /**
+         * Resize every column. New rows are value-initialized
+         * @param n The new number of rows
+         */
+        void resize(size_t n);
+
+        /**
+         * Add a row at the end of the container
+         * @param values The fields of the row, in column order
+         */
+        void push_back(const Ts&... values);
+        void push_back(Ts&&... values);
+
+        /**
+         * Remove the last row
+         */
+        void pop_back();
+
+        /**
+         * Remove a row by moving the last row in its place. The order of the rows is not preserved
+         * @param n The position of the row to remove
+         */
+        void unordered_erase(size_t n);
+
+        /**
+         * Remove every row
+         */
+        void clear();
+
+    private:
+        template <size_t... Is>
+        reference row(size_t n, std::index_sequence<Is...>) { return reference(&std::get<Is>(columns_)[n]...); }
+        template <size_t... Is>
+        const_reference row(size_t n, std::index_sequence<Is...>) const { return const_reference(&std::get<Is>(columns_)[n]...); }
+
+        /**
+         * Call a function on every column
+         * @param f The function, taking the column as argument
+         */
+        template <typename Function, size_t... Is>
+        void for_each_column(Function f, std::index_sequence<Is...>);
+
+        template <size_t... Is>
+        size_t min_capacity(std::index_sequence<Is...>) const;
+
+        template <size_t... Is>
+        void push_back_values(std::index_sequence<Is...>, const Ts&... values);
+        template <size_t... Is>
+        void push_back_values(std::index_sequence<Is...>, Ts&&... values);
+
+        std::tuple<aligned_vector<Ts, cache_line_size>...> columns_;    /**< One array per field */
+};
+
+/////////////////////////////////////////////////////////////////////////
+template <typename... Ts>
+const soa_row<Ts...>& soa_row<Ts...>::operator=(const std::tuple<typename std::remove_const<Ts>::type...>& values) const {
+    assign(values, std::index_sequence_for<Ts...>());
+    return *this;
+}
+
+template <typename... Ts>
+const soa_row<Ts...>& soa_row<Ts...>::operator=(const soa_row& rhs) const {
+    assign(rhs.copy(std::index_sequence_for<Ts...>()), std::index_sequence_for<Ts...>());
+    return *this;
+}
+
+template <typename... Ts>
+soa_row<Ts...>::operator std::tuple<typename std::remove_const<Ts>::type...>() const {
+    return copy(std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void soa_row<Ts...>::assign(const std::tuple<typename std::remove_const<Ts>::type...>& values, std::index_sequence<Is...>) const {
+    int expand[] = { 0, (*std::get<Is>(fields_) = std::get<Is>(values), 0)... };
+    (void)expand;
+}
+
+template <typename... Ts>
+template <size_t... Is>
+std::tuple<typename std::remove_const<Ts>::type...> soa_row<Ts...>::copy(std::index_sequence<Is...>) const {
+    return std::tuple<typename std::remove_const<Ts>::type...>(*std::get<Is>(fields_)...);
+}
+
+/////////////////////////////////////////////////////////////////////////
+template <typename... Ts>
+typename soa_vector<Ts...>::reference soa_vector<Ts...>::operator[](size_t n) {
+    assert(n < size());
+    return row(n, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+typename soa_vector<Ts...>::const_reference soa_vector<Ts...>::operator[](size_t n) const {
+    assert(n < size());
+    return row(n, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::reserve(size_t n) {
+    for_each_column([n](auto& column) { column.reserve(n); }, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::resize(size_t n) {
+    for_each_column([n](auto& column) { column.resize(n); }, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::push_back(const Ts&... values) {
+    push_back_values(std::index_sequence_for<Ts...>(), values...);
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::push_back(Ts&&... values) {
+    push_back_values(std::index_sequence_for<Ts...>(), std::move(values)...);
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::pop_back() {
+    assert(!empty());
+    for_each_column([](auto& column) { column.pop_back(); }, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::unordered_erase(size_t n) {
+    assert(n < size());
+    for_each_column([n](auto& column) { column.unordered_erase(column.begin() + n); }, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+void soa_vector<Ts...>::clear() {
+    for_each_column([](auto& column) { column.clear(); }, std::index_sequence_for<Ts...>());
+}
+
+template <typename... Ts>
+template <typename Function, size_t... Is>
+void soa_vector<Ts...>::for_each_column(Function f, std::index_sequence<Is...>) {
+    int expand[] = { 0, (f(std::get<Is>(columns_)), 0)... };
+    (void)expand;
+}
+
+template <typename... Ts>
+template <size_t... Is>
+size_t soa_vector<Ts...>::min_capacity(std::index_sequence<Is...>) const {
+    size_t capacities[] = { std::get<Is>(columns_).capacity()... };
+    size_t result = capacities[0];
+    for (size_t i = 1; i < sizeof...(Is); i++) {
+        result = capacities[i] < result ? capacities[i] : result;
+    }
+
+    return result;
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void soa_vector<Ts...>::push_back_values(std::index_sequence<Is...>, const Ts&... values) {
+    int expand[] = { 0, (std::get<Is>(columns_).push_back(values), 0)... };
+    (void)expand;
+}
+
+template <typename... Ts>
+template <size_t... Is>
+void soa_vector<Ts...>::push_back_values(std::index_sequence<Is...>, Ts&&... values) {
+    int expand[] = { 0, (std::get<Is>(columns_).push_back(std::move(values)), 0)... };
+    (void)expand;
+}
+
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef SKETCH_STL_SPAN_H
+#define SKETCH_STL_SPAN_H
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <type_traits>
+
+namespace SketchStl {
+
+/**
+ * @class span
+ * This class represents a non-owning view over contiguous elements: a pointer and a length. It is cheap to copy
+ * and is how the containers hand out their raw storage to kernels
+ */
+template <typename T>
+class span {
+    public:
+        typedef T value_type;
+        typedef T* iterator;
+
+        constexpr span() : data_(nullptr), length_(0) {}
+
+        /**
+         * Constructor
+         * @param data The first element
+         * @param length The number of elements
+         */
+        constexpr span(T* data, size_t length) : data_(data), length_(length) {}
+
+        /**
+         * Conversion from a span of non-const elements to a span of const elements
+         * @param src The span to convert
+         */
+        template <typename U, typename=typename std::enable_if<std::is_convertible<U(*)[], T(*)[]>::value>::type>
+        constexpr span(const span<U>& src) : data_(src.data()), length_(src.size()) {}
+
+        constexpr T* data() const { return data_; }
+        constexpr size_t size() const { return length_; }
+        constexpr bool empty() const { return length_ == 0; }
+
+        constexpr T* begin() const { return data_; }
+        constexpr T* end() const { return data_ + length_; }
+
+        constexpr T& operator[](size_t n) const { return assert(n < length_), data_[n]; }
+
+        /**
+         * Return a view over part of this span
+         * @param pos The position of the first element of the view
+         * @param len The number of elements of the view
+         */
+        constexpr span subspan(size_t pos, size_t len) const {
+            return assert(pos + len <= length_), span(data_ + pos, len);
+        }
+
+    private:
+        T*      data_;      /**< The first element */
+        size_t  length_;    /**< The number of elements */
+};
+
+}
+
+#endif
@@ -0,0 +1,607 @@
+#ifndef SKETCH_STL_STATIC_VECTOR_H
+#define SKETCH_STL_STATIC_VECTOR_H
+
+#include "sketch_iterator.h"
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace SketchStl {
+
+/**
+ * @class static_vector_storage
+ * Inline storage of a static_vector. Elements of trivial types live in a plain array so that the container
+ * stays a literal type and can be used in constant expressions. Other types live in raw storage and are
+ * constructed and destroyed in place, so that an empty vector runs no constructor
+ */
+template <typename T, size_t N,
+          bool Trivial=std::is_trivially_default_constructible<T>::value && std::is_trivially_copyable<T>::value>
+class static_vector_storage {
+    protected:
+#if defined(__cpp_lib_is_constant_evaluated)
+        // Only constant evaluation needs every slot initialized. At run time, zeroing the N slots of an empty
+        // vector would be wasted work since an element is always written before it is read
+        constexpr static_vector_storage() : length_(0) {
+            if (std::is_constant_evaluated()) {
+                for (size_t i = 0; i < N; i++) {
+                    data_[i] = T();
+                }
+            }
+        }
+#else
+        constexpr static_vector_storage() : data_(), length_(0) {}
+#endif
+
+        constexpr T* ptr() { return data_; }
+        constexpr const T* ptr() const { return data_; }
+
+        constexpr void construct(size_t i, const T& val) { data_[i] = val; }
+        constexpr void construct(size_t i, T&& val) { data_[i] = std::move(val); }
+        constexpr void destroy(size_t) {}
+
+        T       data_[N];   /**< The elements */
+        size_t  length_;    /**< The number of elements */
+};
+
+template <typename T, size_t N>
+class static_vector_storage<T, N, false> {
+    protected:
+        static_vector_storage() : length_(0) {}
+
+        static_vector_storage(const static_vector_storage& src) : length_(0) {
+            for (; length_ < src.length_; length_++) {
+                construct(length_, src.ptr()[length_]);
+            }
+        }
+
+        ~static_vector_storage() {
+            for (size_t i = 0; i < length_; i++) {
+                destroy(i);
+            }
+        }
+
+        static_vector_storage& operator=(const static_vector_storage& rhs) {
+            if (this != &rhs) {
+                for (size_t i = 0; i < length_; i++) {
+                    destroy(i);
+                }
+
+                for (length_ = 0; length_ < rhs.length_; length_++) {
+                    construct(length_, rhs.ptr()[length_]);
+                }
+            }
+
+            return *this;
+        }
+
+        // The elements are moved one by one, and the source is left empty
+        static_vector_storage(static_vector_storage&& src) noexcept(std::is_nothrow_move_constructible<T>::value) : length_(0) {
+            for (; length_ < src.length_; length_++) {
+                construct(length_, std::move(src.ptr()[length_]));
+            }
+            src.clear_storage();
+        }
+
+        static_vector_storage& operator=(static_vector_storage&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            if (this != &rhs) {
+                clear_storage();
+
+                for (; length_ < rhs.length_; length_++) {
+                    construct(length_, std::move(rhs.ptr()[length_]));
+                }
+                rhs.clear_storage();
+            }
+
+            return *this;
+        }
+
+        T* ptr() { return reinterpret_cast<T*>(storage_); }
+        const T* ptr() const { return reinterpret_cast<const T*>(storage_); }
+
+        void construct(size_t i, const T& val) { new (ptr() + i) T(val); }
+        void construct(size_t i, T&& val) { new (ptr() + i) T(std::move(val)); }
+        void destroy(size_t i) { ptr()[i].~T(); }
+
+        void clear_storage() {
+            for (size_t i = 0; i < length_; i++) {
+                destroy(i);
+            }
+            length_ = 0;
+        }
+
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_[N];  /**< Raw storage for the elements */
+        size_t                                                      length_;     /**< The number of elements */
+};
+
+/**
+ * @class static_vector
+ * This class represents a contiguous array with a fixed capacity of N elements stored inline, so it never
+ * allocates. It offers the same interface as vector. For trivial types every member function can be
+ * used in constant expressions, which allows building tables at compile time
+ */
+template <typename T, size_t N>
+class static_vector : private static_vector_storage<T, N> {
+    static_assert(N > 0, "A static_vector must have a capacity of at least one element");
+
+    public:
+        typedef random_access_iterator<T> iterator;
+        typedef const random_access_iterator<T> const_iterator;
+
+        /**
+         * Default constructor
+         * Constructs an empty vector
+         */
+        constexpr static_vector();
+
+        /**
+         * Fill constructor
+         * Constructs a container with n elements. Each element is a copy of val
+         * @param n The number of elements. Must not exceed N
+         * @param val The value to fill the vector with
+         */
+        constexpr static_vector(size_t n, const T& val=T());
+
+        /**
+         * Range constructor
+         * Constructs a container with as many elements as the range [first, last), with each element
+         * constructed from its corresponding element in that range, in the same order
+         * @param first An iterator specifying the first position of the element in the range of elements
+         * @param last An iterator specifying the last, non-inclusive position of the element in the range of elements
+         */
+        template <typename InputIt, typename=typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        constexpr static_vector(InputIt first, InputIt last);
+
+        /**
+         * Return the iterator at the beginning of the vector
+         */
+        constexpr iterator begin();
+
+        /**
+         * Return a constant iterator at the beginning of the vector
+         */
+        constexpr const_iterator begin() const;
+
+        /**
+         * Return an iterator referring to the past-the-end element in the vector
+         */
+        constexpr iterator end();
+
+        /**
+         * Return a constant iterator referring to the past-the-end element in the vector
+         */
+        constexpr const_iterator end() const;
+
+        /**
+         * Return a reference to the first element in the vector
+         */
+        constexpr T& front();
+        constexpr const T& front() const;
+
+        /**
+         * Return a reference to the last element in the vector
+         */
+        constexpr T& back();
+        constexpr const T& back() const;
+
+        /**
+         * Return a pointer to the underlying array
+         */
+        constexpr T* data() { return this->ptr(); }
+        constexpr const T* data() const { return this->ptr(); }
+
+        constexpr size_t size() const { return this->length_; }
+        constexpr size_t capacity() const { return N; }
+        constexpr size_t max_size() const { return N; }
+        constexpr bool empty() const { return this->length_ == 0; }
+        constexpr bool full() const { return this->length_ == N; }
+
+        /**
+         * Resize the vector
+         * @param n The new size of the vector. Must not exceed N
+         * @param val The value to copy at the end of the vector, in case the new size is larger
+         */
+        constexpr void resize(size_t n, const T& val=T());
+
+        /**
+         * Access element
+         * @param n The position at which we want to access the element
+         */
+        constexpr T& operator[](size_t n);
+        constexpr const T& operator[](size_t n) const;
+
+        /**
+         * Returns a reference to the element at position n in the vector
+         * @param n The position at which we want to access the element
+         */
+        constexpr T& at(size_t n);
+        constexpr const T& at(size_t n) const;
+
+        /**
+         * Assign a new content to the vector by specifying a range of values from two iterators
+         * @param first The first element to consider in the range
+         * @param last The last, non-inclusive element to consider in the range
+         */
+        template <typename InputIt, typename=typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        constexpr void assign(InputIt first, InputIt last);
+
+        /**
+         * Fill the vector with a value
+         * @param n The new size for the vector. Must not exceed N
+         * @param val Value to fill the vector with
+         */
+        constexpr void assign(size_t n, const T& val);
+
+        /**
+         * Add an element at the end of the vector. The vector must not be full
+         * @param val The value to add at the end
+         */
+        constexpr void push_back(const T& val);
+        constexpr void push_back(T&& val);
+
+        /**
+         * Remove the last element of the vector
+         */
+        constexpr void pop_back();
+
+        /**
+         * Insert a single element in the vector
+         * @param position An iterator specifying the position at which to insert the element
+         * @param val The value of the element to insert
+         * @return An iterator that points to the newly inserted element
+         */
+        constexpr iterator insert(iterator position, const T& val);
+
+        /**
+         * Insert several elements in the vector
+         * @param position An iterator specifying the position at which to insert the elements
+         * @param n The number of elements to insert
+         * @param val The value of the element to insert
+         * @return An iterator that points to the first of the newly inserted elements
+         */
+        constexpr iterator insert(iterator position, size_t n, const T& val);
+
+        /** Insert a range of elements from two iterators in the vector
+        * @param position An iterator specifying the position at which to insert the range of elements
+        * @param first An iterator representing the first element in the range of elements to insert
+        * @param last An iterator representing the last, non-inclusive element in the range of elements to insert
+        * @return An iterator that points to the first of the newly inserted elements
+        */
+        template <typename InputIt, typename=typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        constexpr iterator insert(iterator position, InputIt first, InputIt last);
+
+        /**
+         * Erase an element from the vector
+         * @param position An iterator specifying the position at which to remove the element
+         * @return An iterator poiting to the new location of the element that followed the last element erased
+         */
+        constexpr iterator erase(iterator position);
+
+        /**
+         * Erase a range of elements from the vector
+         * @param first An iterator representing the first position of the range in the vector
+         * @param last An iterator representing the last, non-inclusive position of the range in the vector
+         * @return An iterator poiting to the new location of the element that followed the last element erased
+         */
+        constexpr iterator erase(iterator first, iterator last);
+
+        /**
+         * Erase an element in O(1) by moving the last element into its place. The order of the elements
+         * is not preserved
+         * @param position An iterator specifying the position at which to remove the element
+         * @return An iterator pointing to the element that took the place of the erased one
+         */
+        constexpr iterator unordered_erase(iterator position);
+
+        /**
+         * Erase every element that satisfies a predicate. The remaining elements are compacted, in order,
+         * in a single pass
+         * @param pred A function called on each element, returning true if the element must be erased
+         * @return The number of elements erased
+         */
+        template <typename Predicate>
+        constexpr size_t erase_if(Predicate pred);
+
+        /**
+         * Clear the vector
+         */
+        constexpr void clear();
+
+    private:
+        /**
+         * Move the elements [pos, length) n slots to the right. The n slots starting at pos are left
+         * without any live element, ready to be constructed into. The length is not modified
+         * @param pos The position of the first element to move
+         * @param n The number of slots to open
+         */
+        constexpr void open_gap(size_t pos, size_t n);
+
+        template <typename InputIt>
+        constexpr void insert_range(size_t pos, InputIt first, InputIt last, std::input_iterator_tag);
+        template <typename ForwardIt>
+        constexpr void insert_range(size_t pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+};
+
+template <typename T, size_t N>
+constexpr static_vector<T, N>::static_vector() : static_vector_storage<T, N>() {
+}
+
+template <typename T, size_t N>
+constexpr static_vector<T, N>::static_vector(size_t n, const T& val) : static_vector_storage<T, N>() {
+    assign(n, val);
+}
+
+template <typename T, size_t N>
+template <typename InputIt, typename>
+constexpr static_vector<T, N>::static_vector(InputIt first, InputIt last) : static_vector_storage<T, N>() {
+    assign(first, last);
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::begin() {
+    return iterator(this->ptr());
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::const_iterator static_vector<T, N>::begin() const {
+    return iterator(const_cast<T*>(this->ptr()));
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::end() {
+    return iterator(this->ptr() + this->length_);
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::const_iterator static_vector<T, N>::end() const {
+    return iterator(const_cast<T*>(this->ptr()) + this->length_);
+}
+
+template <typename T, size_t N>
+constexpr T& static_vector<T, N>::front() {
+    return this->ptr()[0];
+}
+
+template <typename T, size_t N>
+constexpr const T& static_vector<T, N>::front() const {
+    return this->ptr()[0];
+}
+
+template <typename T, size_t N>
+constexpr T& static_vector<T, N>::back() {
+    return this->ptr()[this->length_ - 1];
+}
+
+template <typename T, size_t N>
+constexpr const T& static_vector<T, N>::back() const {
+    return this->ptr()[this->length_ - 1];
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::resize(size_t n, const T& val) {
+    assert(n <= N);
+
+    for (size_t i = n; i < this->length_; i++) {
+        this->destroy(i);
+    }
+
+    for (size_t i = this->length_; i < n; i++) {
+        this->construct(i, val);
+    }
+
+    this->length_ = n;
+}
+
+template <typename T, size_t N>
+constexpr T& static_vector<T, N>::operator[](size_t n) {
+    assert(n < this->length_);
+    return this->ptr()[n];
+}
+
+template <typename T, size_t N>
+constexpr const T& static_vector<T, N>::operator[](size_t n) const {
+    assert(n < this->length_);
+    return this->ptr()[n];
+}
+
+template <typename T, size_t N>
+constexpr T& static_vector<T, N>::at(size_t n) {
+    assert(n < this->length_);
+    return this->ptr()[n];
+}
+
+template <typename T, size_t N>
+constexpr const T& static_vector<T, N>::at(size_t n) const {
+    assert(n < this->length_);
+    return this->ptr()[n];
+}
+
+template <typename T, size_t N>
+template <typename InputIt, typename>
+constexpr void static_vector<T, N>::assign(InputIt first, InputIt last) {
+    clear();
+
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::assign(size_t n, const T& val) {
+    assert(n <= N);
+    clear();
+
+    for (; this->length_ < n; this->length_++) {
+        this->construct(this->length_, val);
+    }
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::push_back(const T& val) {
+    assert(this->length_ < N);
+    this->construct(this->length_, val);
+    this->length_ += 1;
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::push_back(T&& val) {
+    assert(this->length_ < N);
+    this->construct(this->length_, std::move(val));
+    this->length_ += 1;
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::pop_back() {
+    this->length_ -= 1;
+    this->destroy(this->length_);
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::insert(iterator position, const T& val) {
+    return insert(position, 1, val);
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::insert(iterator position, size_t n, const T& val) {
+    size_t pos = position - begin();
+    assert(this->length_ + n <= N);
+
+    // val may be an element of the vector, which the gap moves
+    T copy(val);
+    open_gap(pos, n);
+    for (size_t i = pos; i < pos + n; i++) {
+        this->construct(i, copy);
+    }
+    this->length_ += n;
+
+    return begin() + pos;
+}
+
+template <typename T, size_t N>
+template <typename InputIt, typename>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::insert(iterator position, InputIt first, InputIt last) {
+    size_t pos = position - begin();
+    insert_range(pos, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+
+    return begin() + pos;
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::erase(iterator position) {
+    return erase(position, position + 1);
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::erase(iterator first, iterator last) {
+    size_t pos = first - begin();
+    size_t diff = last - first;
+
+    T* data = this->ptr();
+    for (size_t i = pos + diff; i < this->length_; i++) {
+        data[i - diff] = std::move(data[i]);
+    }
+
+    for (size_t i = this->length_ - diff; i < this->length_; i++) {
+        this->destroy(i);
+    }
+    this->length_ -= diff;
+
+    return begin() + pos;
+}
+
+template <typename T, size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::unordered_erase(iterator position) {
+    size_t pos = position - begin();
+
+    T* data = this->ptr();
+    if (pos != this->length_ - 1) {
+        data[pos] = std::move(data[this->length_ - 1]);
+    }
+    pop_back();
+
+    return begin() + pos;
+}
+
+template <typename T, size_t N>
+template <typename Predicate>
+constexpr size_t static_vector<T, N>::erase_if(Predicate pred) {
+    T* data = this->ptr();
+
+    size_t kept = 0;
+    for (size_t i = 0; i < this->length_; i++) {
+        if (pred(data[i])) {
+            continue;
+        }
+
+        if (kept != i) {
+            data[kept] = std::move(data[i]);
+        }
+        kept += 1;
+    }
+
+    size_t erased = this->length_ - kept;
+    for (size_t i = kept; i < this->length_; i++) {
+        this->destroy(i);
+    }
+    this->length_ = kept;
+
+    return erased;
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::clear() {
+    for (size_t i = 0; i < this->length_; i++) {
+        this->destroy(i);
+    }
+    this->length_ = 0;
+}
+
+template <typename T, size_t N>
+constexpr void static_vector<T, N>::open_gap(size_t pos, size_t n) {
+    T* data = this->ptr();
+
+    // Slots past the current length hold no element yet and must be constructed rather than assigned
+    for (size_t i = this->length_ + n; i-- > pos + n;) {
+        if (i >= this->length_) {
+            this->construct(i, std::move(data[i - n]));
+        } else {
+            data[i] = std::move(data[i - n]);
+        }
+    }
+
+    for (size_t i = pos; i < pos + n && i < this->length_; i++) {
+        this->destroy(i);
+    }
+}
+
+template <typename T, size_t N>
+template <typename InputIt>
+constexpr void static_vector<T, N>::insert_range(size_t pos, InputIt first, InputIt last, std::input_iterator_tag) {
+    for (; first != last; ++first, pos++) {
+        insert(begin() + pos, *first);
+    }
+}
+
+template <typename T, size_t N>
+template <typename ForwardIt>
+constexpr void static_vector<T, N>::insert_range(size_t pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    size_t n = 0;
+    for (ForwardIt it = first; it != last; ++it) {
+        n += 1;
+    }
+    assert(this->length_ + n <= N);
+
+    open_gap(pos, n);
+    for (size_t i = pos; i < pos + n; i++, ++first) {
+        this->construct(i, *first);
+    }
+    this->length_ += n;
+}
+
+}
+
+#endif
@@ -28,6 +28,13 @@ class string {
          */
         string(const string& str);
 
+        /**
+         * Move constructor. Takes the buffer of the source, which is left as an empty string without a buffer.
+         * Never allocates
+         * @param str The string to move
+         */
+        string(string&& str) noexcept;
+
         /**
          * Substring constructor
          * @param str The string to copy
@@ -68,6 +75,12 @@ class string {
          */
         string& operator=(const string& str);
 
+        /**
+         * Move assignment operator. Exchanges the buffers, the source is left with the old content of this string
+         * @param str The string to move
+         */
+        string& operator=(string&& str) noexcept;
+
         /**
          * Assignment operator from c-string
          * @param s The c-string to copy
@@ -341,7 +354,25 @@ class string {
          * Exchange the content of this string with another one
          * @param str The string to swap
          */
-        void swap(string& str);
+        void swap(string& str) noexcept;
+
+        /**
+         * Take ownership of an existing buffer without copying it. The previous content is freed.
+         * The buffer must have been allocated with malloc (or SketchStl::allocator) since the string
+         * will eventually release it with free
+         * @param s The buffer to adopt
+         * @param len The number of characters in the buffer
+         * @param cap The size of the buffer in bytes. It must leave room for the null character at s[len]
+         */
+        void adopt(char* s, size_t len, size_t cap);
+
+        /**
+         * Give up ownership of the buffer without copying it. The string becomes empty and holds no buffer. The
+         * caller must read the length and capacity before releasing, and is responsible for freeing the buffer
+         * with free
+         * @return The null-terminated buffer, or nullptr if the string held none
+         */
+        char* release();
 
         /**
          * Returns a pointer to an array that contains a null-terminated sequence of characters
@@ -514,9 +545,9 @@ class string {
         friend bool operator>=(const char* lhs, const string& rhs);
 
     private:
-        char*   data_;      /**< The c-string managed by the object */
+        char*   data_;      /**< The c-string managed by the object, null after a move or a release */
         size_t  length_;    /**< The length of the string */
-        size_t  capacity_;  /**< The capacity of the string. This is the actual size of the buffer */
+        size_t  capacity_;  /**< The capacity of the string. This is the actual size of the buffer, 0 when data_ is null */
 };
 
 }
@@ -2,19 +2,32 @@
 #define SKETCH_STL_VECTOR_H
 
 #include "sketch_iterator.h"
+#include "sketch_memory.h"
 
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <functional>
+#include <iterator>
+#include <new>
 #include <type_traits>
+#include <utility>
 
 namespace SketchStl {
 /**
  * @class vector
- * This class represents a dynamic contiguous array
+ * This class represents a dynamic contiguous array. The storage is obtained from the Allocator policy,
+ * which also decides the alignment of the array. The length and capacity are stored as SizeType, so a
+ * narrower type shrinks the vector itself at the cost of its maximum size: growing past what SizeType can count
+ * aborts
  */
-template <typename T>
+template <typename T, typename Allocator=allocator, typename SizeType=size_t>
 class vector {
     public:
         typedef random_access_iterator<T> iterator;
         typedef const random_access_iterator<T> const_iterator;
+        typedef Allocator allocator_type;
 
         /**
          * Default constructor
@@ -33,17 +46,26 @@ class vector {
         /**
          * Range constructor
          * Constructs a container with as many elements as the range [first, last), with each element
-         * constructed from its corresponding element in that range, in the same order
+         * constructed from its corresponding element in that range, in the same order. Forward ranges are
+         * measured first so that the array is allocated only once
          * @param first An iterator specifying the first position of the element in the range of elements
          * @param last An iterator specifying the last, non-inclusive position of the element in the range of elements
          */
-        vector(iterator first, iterator last);
+        template <typename InputIt, typename=typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        vector(InputIt first, InputIt last);
 
         /**
          * Copy constructor
          * @param src The vector to copy
          */
-        vector(const vector<T>& src);
+        vector(const vector& src);
+
+        /**
+         * Move constructor
+         * Takes the array of the source, which is left empty without storage
+         * @param src The vector to move
+         */
+        vector(vector&& src);
 
         /**
          * Destructor
@@ -55,7 +77,14 @@ class vector {
          * Assignment operator
          * @param rhs The vector to assign to this one
          */
-        vector<T>& operator=(const vector& rhs);
+        vector& operator=(const vector& rhs);
+
+        /**
+         * Move assignment operator
+         * Frees the elements of this vector and takes the array of the source, which is left empty without storage
+         * @param rhs The vector to move
+         */
+        vector& operator=(vector&& rhs);
 
         /**
          * Return the iterator at the beginning of the vector
@@ -97,6 +126,12 @@ class vector {
          */
         const T& back() const;
 
+        /**
+         * Return a pointer to the underlying array
+         */
+        T* data() { return data_; }
+        const T* data() const { return data_; }
+
         size_t size() const { return length_; }
         size_t capacity() const { return capacity_; }
         bool empty() const { return length_ == 0; }
@@ -135,7 +170,8 @@ class vector {
          * @param first The first element to consider in the range
          * @param last The last, non-inclusive element to consider in the range
          */
-        void assign(iterator first, iterator last);
+        template <typename InputIt, typename=typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        void assign(InputIt first, InputIt last);
 
         /**
          * Fill the vector with a value
@@ -149,6 +185,7 @@ class vector {
          * @param val The value to add at the end
          */
         void push_back(const T& val);
+        void push_back(T&& val);
 
         /**
          * Remove the last element of the vector
@@ -178,7 +215,15 @@ class vector {
         * @param last An iterator representing the last, non-inclusive element in the range of elements to insert
         * @return An iterator that points to the first of the newly inserted elements
         */
-        iterator insert(iterator position, iterator first, iterator last);
+        template <typename InputIt, typename=typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+        iterator insert(iterator position, InputIt first, InputIt last);
+
+        /**
+         * Append the elements of an array at the end of the vector
+         * @param ptr The first element of the array
+         * @param n The number of elements to append
+         */
+        void append(const T* ptr, size_t n);
 
         /**
          * Erase an element from the vector
@@ -195,422 +240,685 @@ class vector {
          */
         iterator erase(iterator first, iterator last);
 
+        /**
+         * Erase an element in O(1) by moving the last element into its place. The order of the elements
+         * is not preserved
+         * @param position An iterator specifying the position at which to remove the element
+         * @return An iterator pointing to the element that took the place of the erased one
+         */
+        iterator unordered_erase(iterator position);
+
+        /**
+         * Erase every element that satisfies a predicate. The remaining elements are compacted, in order,
+         * in a single pass
+         * @param pred A function called on each element, returning true if the element must be erased
+         * @return The number of elements erased
+         */
+        template <typename Predicate>
+        size_t erase_if(Predicate pred);
+
         /**
          * Clear the vector. This frees the allocated memory
          */
         void clear();
 
+        /**
+         * Take ownership of an existing array without copying it. The previous content is destroyed and freed.
+         * The array must have been obtained from Allocator::allocate, since the vector will eventually
+         * release it with Allocator::deallocate
+         * @param ptr The array to adopt
+         * @param len The number of constructed elements at the beginning of the array
+         * @param cap The number of elements the array can hold
+         */
+        void adopt(T* ptr, size_t len, size_t cap);
+
+        /**
+         * Give up ownership of the array without copying it. The vector becomes empty and holds no storage.
+         * The caller must read the size and capacity before releasing, and is responsible for destroying the
+         * elements and freeing the array with Allocator::deallocate
+         * @return The array
+         */
+        T* release();
+
     private:
+        /**
+         * Tells whether a range can be copied into the array with memcpy
+         */
+        template <typename It>
+        struct is_memcpy_range : std::integral_constant<bool,
+            is_contiguous_iterator<It>::value && std::is_trivially_copyable<T>::value &&
+            std::is_same<typename std::remove_cv<typename std::iterator_traits<It>::value_type>::type, T>::value> {
+        };
+
+        /**
+         * Tells whether a range may point into an array of T
+         */
+        template <typename It>
+        struct is_array_range : std::integral_constant<bool,
+            is_contiguous_iterator<It>::value &&
+            std::is_same<typename std::remove_cv<typename std::iterator_traits<It>::value_type>::type, T>::value> {
+        };
+
+        template <typename InputIt>
+        void assign_range(InputIt first, InputIt last, std::input_iterator_tag);
+        template <typename ForwardIt>
+        void assign_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+        template <typename InputIt>
+        void insert_range(size_t pos, InputIt first, InputIt last, std::input_iterator_tag);
+        template <typename ForwardIt>
+        void insert_range(size_t pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag);
+
+        /**
+         * Copy-construct n elements from a range into uninitialized memory
+         * @param dst The first uninitialized element
+         * @param first The beginning of the source range
+         * @param n The number of elements to construct
+         */
+        template <typename ForwardIt>
+        static void construct_range(T* dst, ForwardIt first, size_t n, std::true_type);
+        template <typename ForwardIt>
+        static void construct_range(T* dst, ForwardIt first, size_t n, std::false_type);
+
+        /**
+         * Tell whether a range of n elements starts in the array of this vector
+         * @param first The beginning of the range
+         * @param n The number of elements of the range
+         */
+        template <typename It>
+        bool points_into(It first, size_t n, std::true_type) const;
+        template <typename It>
+        bool points_into(It, size_t, std::false_type) const { return false; }
+
+        /**
+         * Move the elements [pos, length) n slots to the right. The n slots starting at pos are left
+         * uninitialized. The capacity must already be large enough
+         * @param pos The position of the first element to move
+         * @param n The number of slots to open
+         */
+        void open_gap(size_t pos, size_t n);
+        void open_gap(size_t pos, size_t n, std::true_type);
+        void open_gap(size_t pos, size_t n, std::false_type);
+
+        /**
+         * Make sure that n more elements fit in the array. The capacity at least doubles when growing so
+         * that repeated appends stay amortized O(1)
+         * @param n The number of elements about to be added
+         */
+        void grow_for(size_t n);
+
+        /**
+         * Move the elements to a new array of at least n elements. The capacity is rounded up when the
+         * allocator is over-aligned, so that the array always ends on a whole alignment block
+         * @param n The minimum capacity of the new array
+         */
+        void reallocate(size_t n);
+
+        /**
+         * Round a capacity up to a multiple of the allocator alignment. Aborts when SizeType cannot count n elements
+         * @param n The requested capacity
+         */
+        static size_t padded_capacity(size_t n);
+
+        /**
+         * Return the capacity to allocate for at least n elements: wanted, if SizeType can count that many, or
+         * else the largest capacity it can count. Aborts when n itself does not fit
+         * @param n The number of elements that must fit
+         * @param wanted The capacity to grow to, usually a multiple of n or of the current capacity
+         */
+        static size_t clamped_capacity(size_t n, size_t wanted);
+
+        /**
+         * Return the largest capacity SizeType can count, as a whole number of alignment blocks
+         */
+        static size_t max_capacity();
+
         T*          data_;      /**< The contiguous dynamic array */
-        size_t      length_;    /**< The length of the array */
-        size_t      capacity_;  /**< The capacity of the array */
-        iterator    begin_;     /**< Iterator representing the first element in the vector */
-        iterator    end_;       /**< Iterator representing the past-the-last element in the vector */
+        SizeType    length_;    /**< The length of the array */
+        SizeType    capacity_;  /**< The capacity of the array */
 };
 
-template <typename T>
-vector<T>::vector() : data_(nullptr), length_(0), capacity_(4) {
-    data_ = (T*)malloc(sizeof(T) * capacity_);
-    begin_ = &data_[0];
-    end_ = &data_[length_];
-}
+/**
+ * Vector whose array is aligned on Align bytes through every reallocation, and whose capacity is a whole
+ * number of Align-sized blocks. Use 32 or 64 to allow aligned AVX loads over the data
+ */
+template <typename T, size_t Align>
+using aligned_vector = vector<T, aligned_allocator<Align>>;
 
+/**
+ * Vector whose length and capacity are stored on 32 bits. On 64-bit targets the vector is 16 bytes instead of 24,
+ * which matters when storing a very large number of small vectors, for instance in adjacency lists
+ */
 template <typename T>
-vector<T>::vector(size_t n, const T& val) : length_(n), capacity_(n * 2) {
-    data_ = (T*)malloc(sizeof(T) * capacity_);
-    for (size_t i = 0; i < length_; i++) {
-        data_[i] = val;
-    }
+using compact_vector = vector<T, allocator, uint32_t>;
 
-    begin_ = &data_[0];
-    end_ = &data_[length_];
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>::vector() : data_(nullptr), length_(0), capacity_(padded_capacity(4)) {
+    data_ = (T*)Allocator::allocate(sizeof(T) * capacity_);
 }
 
-template <typename T>
-vector<T>::vector(iterator first, iterator last) {
-    length_ = ((size_t)&(*last) - (size_t)&(*first)) / sizeof(T);
-    capacity_ = length_ * 2;
-    data_ = (T*)malloc(sizeof(T) * capacity_);
-
-    for (size_t i = 0; first != last; ++first, i++) {
-        data_[i] = *first;
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>::vector(size_t n, const T& val) : length_(n), capacity_(padded_capacity(clamped_capacity(n, n * 2))) {
+    data_ = (T*)Allocator::allocate(sizeof(T) * capacity_);
+    for (size_t i = 0; i < length_; i++) {
+        new (&data_[i]) T(val);
     }
+}
 
-    begin_ = &data_[0];
-    end_ = &data_[length_];
+template <typename T, typename Allocator, typename SizeType>
+template <typename InputIt, typename>
+vector<T, Allocator, SizeType>::vector(InputIt first, InputIt last) : data_(nullptr), length_(0), capacity_(0) {
+    assign_range(first, last, typename std::iterator_traits<InputIt>::iterator_category());
 }
 
-template <typename T>
-vector<T>::vector(const vector<T>& src) {
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>::vector(const vector& src) {
     length_ = src.length_;
     capacity_ = src.capacity_;
-    data_ = (T*)malloc(sizeof(T) * capacity_);
+    data_ = (T*)Allocator::allocate(sizeof(T) * capacity_);
 
-    for (size_t i = 0; i < length_; i++) {
-        data_[i] = src.data_[i];
-    }
+    construct_range(data_, src.data_, length_, is_memcpy_range<T*>());
+}
 
-    begin_ = &data_[0];
-    end_ = &data_[length_];
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>::vector(vector&& src) : data_(src.data_), length_(src.length_), capacity_(src.capacity_) {
+    src.data_ = nullptr;
+    src.length_ = 0;
+    src.capacity_ = 0;
 }
 
-template <typename T>
-vector<T>::~vector() {
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>::~vector() {
     clear();
-    free(data_);
+    Allocator::deallocate(data_);
 }
 
-template <typename T>
-vector<T>& vector<T>::operator=(const vector& rhs) {
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>& vector<T, Allocator, SizeType>::operator=(const vector& rhs) {
     if (this != &rhs) {
         clear();
-        free(data_);
+        Allocator::deallocate(data_);
 
         length_ = rhs.length_;
         capacity_ = rhs.capacity_;
-        data_ = (T*)malloc(sizeof(T) * capacity_);
+        data_ = (T*)Allocator::allocate(sizeof(T) * capacity_);
 
-        for (size_t i = 0; i < length_; i++) {
-            data_[i] = rhs.data_[i];
-        }
+        construct_range(data_, rhs.data_, length_, is_memcpy_range<T*>());
+    }
+
+    return *this;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+vector<T, Allocator, SizeType>& vector<T, Allocator, SizeType>::operator=(vector&& rhs) {
+    if (this != &rhs) {
+        clear();
+        Allocator::deallocate(data_);
 
-        begin_ = &data_[0];
-        end_ = &data_[length_];
+        data_ = rhs.data_;
+        length_ = rhs.length_;
+        capacity_ = rhs.capacity_;
+
+        rhs.data_ = nullptr;
+        rhs.length_ = 0;
+        rhs.capacity_ = 0;
     }
 
     return *this;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::begin() {
-    return begin_;
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::begin() {
+    return iterator(data_);
 }
 
-template <typename T>
-typename const vector<T>::const_iterator vector<T>::begin() const {
-    return begin_;
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::const_iterator vector<T, Allocator, SizeType>::begin() const {
+    return iterator(data_);
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::end() {
-    return end_;
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::end() {
+    return iterator(data_ + length_);
 }
 
-template <typename T>
-typename const vector<T>::const_iterator vector<T>::end() const {
-    return end_;
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::const_iterator vector<T, Allocator, SizeType>::end() const {
+    return iterator(data_ + length_);
 }
 
-template <typename T>
-T& vector<T>::front() {
+template <typename T, typename Allocator, typename SizeType>
+T& vector<T, Allocator, SizeType>::front() {
     return data_[0];
 }
 
-template <typename T>
-const T& vector<T>::front() const {
+template <typename T, typename Allocator, typename SizeType>
+const T& vector<T, Allocator, SizeType>::front() const {
     return data_[0];
 }
 
-template <typename T>
-T& vector<T>::back() {
+template <typename T, typename Allocator, typename SizeType>
+T& vector<T, Allocator, SizeType>::back() {
     return data_[length_ - 1];
 }
 
-template <typename T>
-const T& vector<T>::back() const {
+template <typename T, typename Allocator, typename SizeType>
+const T& vector<T, Allocator, SizeType>::back() const {
     return data_[length_ - 1];
 }
 
-template <typename T>
-void vector<T>::resize(size_t n, T val) {
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::resize(size_t n, T val) {
     if (n < length_) {
-        capacity_ = n * 2;
-
-        T* newData = (T*)malloc(sizeof(T) * capacity_);
-        for (size_t i = 0; i < n; i++) {
-            newData[i] = data_[i];
-        }
-
         for (size_t i = n; i < length_; i++) {
             data_[i].~T();
         }
-
-        free(data_);
-        data_ = newData;
     } else if (n > length_) {
         if (n > capacity_) {
-            capacity_ = n * 2;
-
-            T* newData = (T*)malloc(sizeof(T) * capacity_);
-            for (size_t i = 0; i < length_; i++) {
-                newData[i] = data_[i];
-            }
-
-            free(data_);
-            data_ = newData;
+            reallocate(clamped_capacity(n, n * 2));
         }
 
         for (size_t i = length_; i < n; i++) {
-            data_[i] = val;
+            new (&data_[i]) T(val);
         }
     }
 
     length_ = n;
-    begin_ = &data_[0];
-    end_ = &data_[length_];
 }
 
-template <typename T>
-void vector<T>::reserve(size_t n) {
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::reserve(size_t n) {
     if (n > capacity_) {
-        capacity_ = n;
-
-        T* newData = (T*)malloc(sizeof(T) * capacity_);
-        for (size_t i = 0; i < length_; i++) {
-            newData[i] = data_[i];
-        }
-
-        free(data_);
-        data_ = newData;
-
-        begin_ = &data_[0];
-        end_ = &data_[length_];
+        reallocate(n);
     }
 }
 
-template <typename T>
-T& vector<T>::operator[](size_t n) {
+template <typename T, typename Allocator, typename SizeType>
+T& vector<T, Allocator, SizeType>::operator[](size_t n) {
     assert(n < length_);
     return data_[n];
 }
 
-template <typename T>
-const T& vector<T>::operator[](size_t n) const {
+template <typename T, typename Allocator, typename SizeType>
+const T& vector<T, Allocator, SizeType>::operator[](size_t n) const {
     assert(n < length_);
     return data_[n];
 }
 
-template <typename T>
-T& vector<T>::at(size_t n) {
+template <typename T, typename Allocator, typename SizeType>
+T& vector<T, Allocator, SizeType>::at(size_t n) {
     assert(n < length_);
     return data_[n];
 }
 
-template <typename T>
-const T& vector<T>::at(size_t n) const {
+template <typename T, typename Allocator, typename SizeType>
+const T& vector<T, Allocator, SizeType>::at(size_t n) const {
     assert(n < length_);
     return data_[n];
 }
 
-template <typename T>
-void vector<T>::assign(iterator first, iterator last) {
-    clear();
-
-    length_ = ((size_t)&(*last) - (size_t)&(*first)) / sizeof(T);
-    reserve(length_ * 2);
-
-    for (size_t i = 0; first != last; ++first, i++) {
-        data_[i] = *first;
-    }
-
-    begin_ = &data_[0];
-    end_ = &data_[length_];
+template <typename T, typename Allocator, typename SizeType>
+template <typename InputIt, typename>
+void vector<T, Allocator, SizeType>::assign(InputIt first, InputIt last) {
+    assign_range(first, last, typename std::iterator_traits<InputIt>::iterator_category());
 }
 
-template <typename T>
-void vector<T>::assign(size_t n, const T& val) {
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::assign(size_t n, const T& val) {
     clear();
-    reserve(n * 2);
+    reserve(clamped_capacity(n, n * 2));
 
     for (size_t i = 0; i < n; i++) {
-        data_[i] = val;
+        new (&data_[i]) T(val);
     }
 
     length_ = n;
-    end_ = &data_[length_];
 }
 
-template <typename T>
-void vector<T>::push_back(const T& val) {
-    if (length_ + 1 >= capacity_) {
-        capacity_ *= 2;
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::push_back(const T& val) {
+    if (length_ == capacity_) {
+        // val may be an element of this vector, so it is taken out before the array is freed
+        T copy(val);
+        reallocate(capacity_ > 0 ? clamped_capacity((size_t)length_ + 1, (size_t)capacity_ * 2) : 4);
+        new (&data_[length_]) T(std::move(copy));
+        length_ += 1;
+        return;
+    }
 
-        T* newData = (T*)malloc(sizeof(T) * capacity_);
-        for (size_t i = 0; i < length_; i++) {
-            newData[i] = data_[i];
-        }
+    new (&data_[length_]) T(val);
+    length_ += 1;
+}
 
-        free(data_);
-        data_ = newData;
-        begin_ = &data_[0];
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::push_back(T&& val) {
+    if (length_ == capacity_) {
+        // val may be an element of this vector, so it is taken out before the array is freed
+        T copy(std::move(val));
+        reallocate(capacity_ > 0 ? clamped_capacity((size_t)length_ + 1, (size_t)capacity_ * 2) : 4);
+        new (&data_[length_]) T(std::move(copy));
+        length_ += 1;
+        return;
     }
 
-    data_[length_++] = val;
-    end_ = &data_[length_];
+    new (&data_[length_]) T(std::move(val));
+    length_ += 1;
 }
 
-template <typename T>
-void vector<T>::pop_back() {
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::pop_back() {
     data_[length_-1].~T();
     length_ -= 1;
-    end_ = &data_[length_];
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(iterator position, const T& val) {
-    size_t pos = ((size_t)&(*position) - (size_t)&(*begin_)) / sizeof(T);
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::insert(iterator position, const T& val) {
+    size_t pos = position - begin();
 
-    if (length_ + 1 > capacity_) {
-        capacity_ *= 2;
-        T* newData = (T*)malloc(capacity_ * sizeof(T));
+    // val may refer to an element of this vector, so it is copied before the elements move
+    T copy(val);
+    grow_for(1);
+    open_gap(pos, 1);
 
-        for (size_t i = 0; i < length_; i++) {
-            newData[i] = data_[i];
-        }
+    new (&data_[pos]) T(std::move(copy));
+    length_ += 1;
 
-        free(data_);
-        data_ = newData;
-        
-        begin_ = &data_[0];
+    return begin() + pos;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::insert(iterator position, size_t n, const T& val) {
+    size_t pos = position - begin();
+
+    T copy(val);
+    grow_for(n);
+    open_gap(pos, n);
+
+    for (size_t i = pos; i < pos + n; i++) {
+        new (&data_[i]) T(copy);
     }
+    length_ += n;
+
+    return begin() + pos;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+template <typename InputIt, typename>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::insert(iterator position, InputIt first, InputIt last) {
+    size_t pos = position - begin();
+    insert_range(pos, first, last, typename std::iterator_traits<InputIt>::iterator_category());
+
+    return begin() + pos;
+}
 
-    T nextVal = val;
-    T curVal;
-    for (size_t i = pos; i < length_; i++) {
-        curVal = data_[i];
-        data_[i] = nextVal;
-        nextVal = curVal;
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::append(const T* ptr, size_t n) {
+    insert_range(length_, ptr, ptr + n, std::random_access_iterator_tag());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::erase(iterator position) {
+    size_t pos = position - begin();
+    for (size_t i = pos + 1; i < length_; i++) {
+        data_[i - 1] = std::move(data_[i]);
     }
 
-    data_[length_] = nextVal;
-    length_ += 1;
+    length_ -= 1;
+    data_[length_].~T();
+
+    return begin() + pos;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::erase(iterator first, iterator last) {
+    size_t pos = first - begin();
+    size_t endPos = last - begin();
 
-    end_ = &data_[length_];
+    size_t diff = endPos - pos;
+    for (size_t i = endPos; i < length_; i++) {
+        data_[i - diff] = std::move(data_[i]);
+    }
 
-    return begin_ + pos;
+    for (size_t i = length_ - diff; i < length_; i++) {
+        data_[i].~T();
+    }
+    length_ -= diff;
+
+    return begin() + pos;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(iterator position, size_t n, const T& val) {
-    size_t pos = ((size_t)&(*position) - (size_t)&(*begin_)) / sizeof(T);
+template <typename T, typename Allocator, typename SizeType>
+typename vector<T, Allocator, SizeType>::iterator vector<T, Allocator, SizeType>::unordered_erase(iterator position) {
+    size_t pos = position - begin();
+    if (pos != length_ - 1) {
+        data_[pos] = std::move(data_[length_ - 1]);
+    }
 
-    if (length_ + n > capacity_) {
-        capacity_ += n;
-        T* newData = (T*)malloc(capacity_ * sizeof(T));
+    length_ -= 1;
+    data_[length_].~T();
 
-        for (size_t i = 0; i < length_; i++) {
-            newData[i] = data_[i];
+    return begin() + pos;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+template <typename Predicate>
+size_t vector<T, Allocator, SizeType>::erase_if(Predicate pred) {
+    size_t kept = 0;
+    for (size_t i = 0; i < length_; i++) {
+        if (pred(data_[i])) {
+            continue;
         }
 
-        free(data_);
-        data_ = newData;
-        
-        begin_ = &data_[0];
+        if (kept != i) {
+            data_[kept] = std::move(data_[i]);
+        }
+        kept += 1;
     }
 
-    T* rightData = (T*)malloc((length_ - pos) * sizeof(T));
-    for (size_t i = pos, idx = 0; i < length_; i++, idx++) {
-        rightData[idx] = data_[i];
+    size_t erased = length_ - kept;
+    for (size_t i = kept; i < length_; i++) {
+        data_[i].~T();
     }
+    length_ = kept;
+
+    return erased;
+}
 
-    for (size_t i = pos; i < (pos + n); i++) {
-        data_[i] = val;
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::clear() {
+    for (size_t i = 0; i < length_; i++) {
+        data_[i].~T();
     }
+    length_ = 0;
+}
 
-    for (size_t i = (pos + n), idx = 0; i < (n + length_); i++, idx++) {
-        data_[i] = rightData[idx];
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::adopt(T* ptr, size_t len, size_t cap) {
+    assert(len <= cap);
+    assert(cap <= (size_t)(SizeType)-1);
+    assert(((size_t)ptr % Allocator::alignment) == 0);
+
+    if (ptr != data_) {
+        clear();
+        Allocator::deallocate(data_);
     }
 
-    free(rightData);
-    length_ += n;
+    data_ = ptr;
+    length_ = len;
+    capacity_ = cap;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+T* vector<T, Allocator, SizeType>::release() {
+    T* array = data_;
 
-    end_ = &data_[length_];
+    data_ = nullptr;
+    length_ = 0;
+    capacity_ = 0;
 
-    return begin_ + pos;
+    return array;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(iterator position, iterator first, iterator last) {
-    size_t pos = ((size_t)&(*position) - (size_t)&(*begin_)) / sizeof(T);
-    size_t size = ((size_t)&(*last) - (size_t)&(*first)) / sizeof(T);
+template <typename T, typename Allocator, typename SizeType>
+template <typename InputIt>
+void vector<T, Allocator, SizeType>::assign_range(InputIt first, InputIt last, std::input_iterator_tag) {
+    clear();
 
-    if (length_ + size > capacity_) {
-        capacity_ += size;
-        T* newData = (T*)malloc(capacity_ * sizeof(T));
+    for (; first != last; ++first) {
+        push_back(*first);
+    }
+}
 
-        for (size_t i = 0; i < length_; i++) {
-            newData[i] = data_[i];
-        }
+template <typename T, typename Allocator, typename SizeType>
+template <typename ForwardIt>
+void vector<T, Allocator, SizeType>::assign_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    clear();
 
-        free(data_);
-        data_ = newData;
-        
-        begin_ = &data_[0];
+    size_t n = std::distance(first, last);
+    if (n > capacity_) {
+        reallocate(n);
     }
 
-    T* rightData = (T*)malloc((length_ - pos) * sizeof(T));
-    for (size_t i = pos, idx = 0; i < length_; i++, idx++) {
-        rightData[idx] = data_[i];
+    construct_range(data_, first, n, is_memcpy_range<ForwardIt>());
+    length_ = n;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+template <typename InputIt>
+void vector<T, Allocator, SizeType>::insert_range(size_t pos, InputIt first, InputIt last, std::input_iterator_tag) {
+    // The length of a single-pass range is unknown until it has been read, so it is buffered first
+    vector<T, Allocator, SizeType> buffer(first, last);
+    insert_range(pos, buffer.data_, buffer.data_ + buffer.length_, std::random_access_iterator_tag());
+}
+
+template <typename T, typename Allocator, typename SizeType>
+template <typename ForwardIt>
+void vector<T, Allocator, SizeType>::insert_range(size_t pos, ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+    size_t n = std::distance(first, last);
+
+    // A range of this vector would move with the gap, or be freed by the reallocation, so it is copied first
+    if (points_into(first, n, is_array_range<ForwardIt>())) {
+        vector<T, Allocator, SizeType> buffer(first, last);
+        insert_range(pos, buffer.data_, buffer.data_ + buffer.length_, std::random_access_iterator_tag());
+        return;
     }
 
-    for (size_t i = pos; i < (pos + size); i++, ++first) {
-        data_[i] = *first;
+    grow_for(n);
+    open_gap(pos, n);
+
+    construct_range(&data_[pos], first, n, is_memcpy_range<ForwardIt>());
+    length_ += n;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+template <typename It>
+bool vector<T, Allocator, SizeType>::points_into(It first, size_t n, std::true_type) const {
+    if (n == 0) {
+        return false;
     }
 
-    for (size_t i = (pos + size), idx = 0; i < (size + length_); i++, idx++) {
-        data_[i] = rightData[idx];
+    const T* ptr = &(*first);
+    std::less<const T*> less;
+    return !less(ptr, data_) && less(ptr, data_ + capacity_);
+}
+
+template <typename T, typename Allocator, typename SizeType>
+template <typename ForwardIt>
+void vector<T, Allocator, SizeType>::construct_range(T* dst, ForwardIt first, size_t n, std::true_type) {
+    if (n > 0) {
+        memcpy(dst, &(*first), n * sizeof(T));
     }
+}
 
-    free(rightData);
-    length_ += size;
+template <typename T, typename Allocator, typename SizeType>
+template <typename ForwardIt>
+void vector<T, Allocator, SizeType>::construct_range(T* dst, ForwardIt first, size_t n, std::false_type) {
+    for (size_t i = 0; i < n; i++, ++first) {
+        new (&dst[i]) T(*first);
+    }
+}
 
-    end_ = &data_[length_];
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::open_gap(size_t pos, size_t n) {
+    // Moving the elements onto themselves would leave them moved-from
+    if (n == 0) {
+        return;
+    }
 
-    return begin_ + pos;
+    open_gap(pos, n, std::is_trivially_copyable<T>());
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::erase(iterator position) {
-    size_t pos = ((size_t)&(*position) - (size_t)&(*begin_)) / sizeof(T);
-    data_[length_ - 1].~T();
-    length_ -= 1;
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::open_gap(size_t pos, size_t n, std::true_type) {
+    memmove(&data_[pos + n], &data_[pos], (length_ - pos) * sizeof(T));
+}
 
-    for (size_t i = pos; i < length_; i++) {
-        data_[i] = data_[i + 1];
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::open_gap(size_t pos, size_t n, std::false_type) {
+    for (size_t i = length_; i > pos; i--) {
+        new (&data_[i - 1 + n]) T(std::move(data_[i - 1]));
+        data_[i - 1].~T();
     }
+}
 
-    end_ = &data_[length_];
-
-    return begin_ + pos;
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::grow_for(size_t n) {
+    if (length_ + n > capacity_) {
+        size_t doubled = (size_t)capacity_ * 2;
+        reallocate(clamped_capacity(length_ + n, length_ + n > doubled ? length_ + n : doubled));
+    }
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::erase(iterator first, iterator last) {
-    size_t pos = ((size_t)&(*first) - (size_t)&(*begin_)) / sizeof(T);
-    size_t endPos = ((size_t)&(*last) - (size_t)&(*begin_)) / sizeof(T);
+template <typename T, typename Allocator, typename SizeType>
+void vector<T, Allocator, SizeType>::reallocate(size_t n) {
+    capacity_ = padded_capacity(n);
 
-    for (size_t i = pos; i < endPos; i++) {
+    T* newData = (T*)Allocator::allocate(sizeof(T) * capacity_);
+    for (size_t i = 0; i < length_; i++) {
+        new (&newData[i]) T(std::move(data_[i]));
         data_[i].~T();
     }
 
-    size_t diff = endPos - pos;
-    length_ -= diff;
-    for (size_t i = pos; i < length_; i++) {
-        data_[i] = data_[i + diff];
+    Allocator::deallocate(data_);
+    data_ = newData;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+size_t vector<T, Allocator, SizeType>::padded_capacity(size_t n) {
+    // A capacity SizeType cannot count would be truncated, and the array under-allocated
+    if (n > max_capacity()) {
+        abort();
     }
 
-    end_ = &data_[length_];
+    // Only over-aligned storage is padded: a kernel walking the array by whole alignment blocks
+    // then never needs a scalar tail to stay inside the allocation
+    if (Allocator::alignment > alignof(max_align_t) && Allocator::alignment % sizeof(T) == 0) {
+        const size_t lanes = Allocator::alignment / sizeof(T);
+        n = (n + lanes - 1) / lanes * lanes;
+    }
 
-    return begin_ + pos;
+    return n;
 }
 
-template <typename T>
-void vector<T>::clear() {
-    for (size_t i = 0; i < length_; i++) {
-        data_[i].~T();
+template <typename T, typename Allocator, typename SizeType>
+size_t vector<T, Allocator, SizeType>::clamped_capacity(size_t n, size_t wanted) {
+    const size_t limit = max_capacity();
+    if (n > limit) {
+        abort();
     }
-    end_ = begin_;
-    length_ = 0;
+
+    return wanted < limit ? wanted : limit;
+}
+
+template <typename T, typename Allocator, typename SizeType>
+size_t vector<T, Allocator, SizeType>::max_capacity() {
+    size_t limit = (size_t)(SizeType)-1;
+    if (Allocator::alignment > alignof(max_align_t) && Allocator::alignment % sizeof(T) == 0) {
+        const size_t lanes = Allocator::alignment / sizeof(T);
+        limit = limit / lanes * lanes;
+    }
+
+    return limit;
 }
 
 }
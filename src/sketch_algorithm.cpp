@@ -0,0 +1,444 @@
+#include "sketch_algorithm.h"
+#include "sketch_bit.h"
+#include "sketch_cpu.h"
+
+#include <string.h>
+
+#if defined(SKETCH_STL_X86)
+#include <immintrin.h>
+#endif
+
+namespace SketchStl {
+
+namespace {
+
+/**
+ * Copy values, leaving the pointers alone when there are none, since empty vectors have no buffer
+ */
+void copy_values(uint32_t* dst, const uint32_t* src, size_t n) {
+    if (n > 0) {
+        memcpy(dst, src, n * sizeof(uint32_t));
+    }
+}
+
+/**
+ * Look up every value of a short list in a long one. Store tells whether the common values are written to out
+ * or only counted
+ */
+template <bool Store>
+size_t intersect_gallop(const uint32_t* small, size_t ns, const uint32_t* large, size_t nl, uint32_t* out) {
+    const uint32_t* pos = large;
+    const uint32_t* end = large + nl;
+
+    size_t k = 0;
+    for (size_t i = 0; i < ns; i++) {
+        pos = gallop_lower_bound(pos, end, small[i], std::less<uint32_t>());
+        if (pos == end) {
+            break;
+        }
+
+        if (*pos == small[i]) {
+            if (Store) {
+                out[k] = small[i];
+            }
+            k += 1;
+        }
+    }
+
+    return k;
+}
+
+/**
+ * Merge the rest of two lists without branching on their values. The common value, if any, is written on every
+ * step, and kept only when both heads are equal
+ */
+template <bool Store>
+size_t intersect_merge(const uint32_t* a, size_t i, size_t na, const uint32_t* b, size_t j, size_t nb, uint32_t* out, size_t k) {
+    while (i < na && j < nb) {
+        uint32_t x = a[i];
+        uint32_t y = b[j];
+        if (Store) {
+            out[k] = x;
+        }
+
+        k += x == y ? 1 : 0;
+        i += x <= y ? 1 : 0;
+        j += y <= x ? 1 : 0;
+    }
+
+    return k;
+}
+
+#if defined(SKETCH_STL_X86)
+/**
+ * Compare every element of a block of eight of the first list with every element of a block of eight of the second
+ * one, by rotating the second block seven times
+ * @return The mask of the elements of the first block found in the second one
+ */
+SKETCH_STL_TARGET("avx2") unsigned match_blocks_avx2(const uint32_t* a, const uint32_t* b) {
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i vb = _mm256_loadu_si256((const __m256i*)b);
+    __m256i eq = _mm256_cmpeq_epi32(va, vb);
+    for (int r = 1; r < 8; r++) {
+        vb = _mm256_permutevar8x32_epi32(vb, rotate);
+        eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(va, vb));
+    }
+
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(eq));
+}
+
+/**
+ * Intersect the lists block by block, advancing the block that ends first, or both. Since the values are unique,
+ * every common value is found once, when the two blocks holding it meet
+ * @return The number of common values. i and j receive the positions the caller finishes from
+ */
+template <bool Store>
+SKETCH_STL_TARGET("avx2") size_t intersect_avx2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out, size_t& i, size_t& j) {
+    size_t k = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        unsigned mask = match_blocks_avx2(a + i, b + j);
+        if (Store) {
+            for (; mask != 0; mask &= mask - 1) {
+                out[k++] = a[i + count_trailing_zeros(mask)];
+            }
+        } else {
+            k += popcount(mask);
+        }
+
+        uint32_t lastA = a[i + 7];
+        uint32_t lastB = b[j + 7];
+        i += lastA <= lastB ? 8 : 0;
+        j += lastB <= lastA ? 8 : 0;
+    }
+
+    return k;
+}
+
+/**
+ * Subtract the lists block by block. The matches of a block of the first list are gathered over every block of the
+ * second list it meets, and the values left are written when it is done
+ * @return The number of values written. i and j receive the positions the caller finishes from, and pending the
+ * matches already found in the block at i
+ */
+SKETCH_STL_TARGET("avx2") size_t subtract_avx2(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out, size_t& i, size_t& j, unsigned& pending) {
+    size_t k = 0;
+    unsigned found = 0;
+    while (i + 8 <= na && j + 8 <= nb) {
+        found |= match_blocks_avx2(a + i, b + j);
+
+        uint32_t lastA = a[i + 7];
+        uint32_t lastB = b[j + 7];
+        if (lastA <= lastB) {
+            for (unsigned keep = ~found & 0xFF; keep != 0; keep &= keep - 1) {
+                out[k++] = a[i + count_trailing_zeros(keep)];
+            }
+            found = 0;
+            i += 8;
+        }
+        j += lastB <= lastA ? 8 : 0;
+    }
+
+    pending = found;
+    return k;
+}
+#endif
+
+template <bool Store>
+size_t intersect(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    if (nb / set_gallop_ratio > na) {
+        return intersect_gallop<Store>(a, na, b, nb, out);
+    }
+    if (na / set_gallop_ratio > nb) {
+        return intersect_gallop<Store>(b, nb, a, na, out);
+    }
+
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+#if defined(SKETCH_STL_X86)
+    static const bool avx2 = cpu_has_avx2();
+    if (avx2) {
+        k = intersect_avx2<Store>(a, na, b, nb, out, i, j);
+    }
+#endif
+
+    return intersect_merge<Store>(a, i, na, b, j, nb, out, k);
+}
+
+/**
+ * Write a short list merged into a long one, copying the runs of the long list between the values of the short one
+ */
+size_t unite_gallop(const uint32_t* small, size_t ns, const uint32_t* large, size_t nl, uint32_t* out) {
+    const uint32_t* pos = large;
+    const uint32_t* end = large + nl;
+
+    size_t k = 0;
+    for (size_t i = 0; i < ns; i++) {
+        const uint32_t* found = gallop_lower_bound(pos, end, small[i], std::less<uint32_t>());
+        copy_values(out + k, pos, found - pos);
+        k += found - pos;
+
+        out[k++] = small[i];
+        pos = found != end && *found == small[i] ? found + 1 : found;
+    }
+
+    copy_values(out + k, pos, end - pos);
+    return k + (end - pos);
+}
+
+static const size_t string_key_bytes = 7;
+static const uint64_t string_key_more = 8;
+
+/**
+ * @struct string_record
+ * A string being sorted. All the strings of a group share their bytes before the depth of the group, and the key
+ * holds the next ones
+ */
+struct string_record {
+    uint64_t                key;        /**< The bytes from the depth, big-endian, then the number of bytes left, capped at string_key_more */
+    const unsigned char*    data;       /**< The bytes of the string */
+    uint32_t                length;     /**< The length of the string */
+    uint32_t                index;      /**< The position of the string in the array */
+};
+
+/**
+ * Return the key of a string at a depth: its string_key_bytes bytes from the depth, padded with zeros, in the high
+ * bytes, and the number of bytes it has left in the low one. Two keys compare like the strings they come from,
+ * unless both strings have more than string_key_bytes bytes left
+ * @param data The bytes of the string
+ * @param length The length of the string
+ * @param depth The position of the first byte, not past the end
+ */
+uint64_t string_key(const unsigned char* data, size_t length, size_t depth) {
+    size_t left = length - depth;
+    const unsigned char* bytes = data + depth;
+
+    uint64_t key = 0;
+    if (left > string_key_bytes) {
+        // Written as shifts so that the compiler reads the eight bytes at once and swaps them
+        for (size_t i = 0; i < 8; i++) {
+            key = (key << 8) | bytes[i];
+        }
+        return (key & ~(uint64_t)0xFF) | string_key_more;
+    }
+
+    for (size_t i = 0; i < string_key_bytes; i++) {
+        key = (key << 8) | (i < left ? bytes[i] : 0);
+    }
+    return (key << 8) | left;
+}
+
+/**
+ * Tell whether the string of a key ends within the bytes of the key
+ */
+inline bool string_key_ends(uint64_t key) {
+    return (key & 0xFF) != string_key_more;
+}
+
+/**
+ * Comparison of the records of a group, used on the groups too small or too unbalanced for the quicksort. It
+ * compares the keys and only reads the strings past them when they are equal
+ */
+struct string_record_less {
+    size_t depth;   /**< The depth of the keys */
+
+    bool operator()(const string_record& a, const string_record& b) const {
+        if (a.key != b.key) {
+            return a.key < b.key;
+        }
+        if (string_key_ends(a.key)) {
+            return false;
+        }
+
+        size_t from = depth + string_key_bytes;
+        size_t len = a.length < b.length ? a.length : b.length;
+        int comp = memcmp(a.data + from, b.data + from, len - from);
+        return comp != 0 ? comp < 0 : a.length < b.length;
+    }
+};
+
+static const size_t string_sort_insertion_threshold = 16;
+
+/**
+ * Sort a group of records by multikey quicksort: a three-way partition on the keys, then the same on the records
+ * less than the pivot and the ones greater, at the same depth, and on the ones equal to it at the next depth. Like
+ * nth_element, a group that has been partitioned more than 2 log2(n) times at the same depth goes to a heap sort
+ * @param records The records, whose keys are loaded at the depth
+ * @param n The number of records
+ * @param depth The number of bytes the strings of the group share
+ * @param budget The number of partitions left before the heap sort
+ */
+void string_quicksort(string_record* records, size_t n, size_t depth, unsigned budget) {
+    using std::swap;
+
+    for (;;) {
+        if (n <= string_sort_insertion_threshold) {
+            SketchStl::insertion_sort(records, records + n, string_record_less{depth});
+            return;
+        }
+        if (budget == 0) {
+            SketchStl::make_heap(records, records + n, string_record_less{depth});
+            SketchStl::sort_heap(records, records + n, string_record_less{depth});
+            return;
+        }
+        budget--;
+
+        uint64_t a = records[0].key;
+        uint64_t b = records[n / 2].key;
+        uint64_t c = records[n - 1].key;
+        uint64_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) : (a < c ? a : (b < c ? c : b));
+
+        // [0, lt) is less than the pivot, [lt, i) equal to it and [gt, n) greater
+        size_t lt = 0;
+        size_t i = 0;
+        size_t gt = n;
+        while (i < gt) {
+            uint64_t key = records[i].key;
+            if (key < pivot) {
+                swap(records[lt++], records[i++]);
+            } else if (key > pivot) {
+                swap(records[i], records[--gt]);
+            } else {
+                i++;
+            }
+        }
+
+        string_quicksort(records, lt, depth, budget);
+        string_quicksort(records + gt, n - gt, depth, budget);
+
+        // The strings equal to the pivot are equal altogether when they end within the key
+        if (string_key_ends(pivot)) {
+            return;
+        }
+
+        records += lt;
+        n = gt - lt;
+        depth += string_key_bytes;
+        for (size_t r = 0; r < n; r++) {
+            records[r].key = string_key(records[r].data, records[r].length, depth);
+        }
+        budget = 2 * floor_log2(n);
+    }
+}
+
+}
+
+size_t set_intersection(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    return intersect<true>(a, na, b, nb, out);
+}
+
+size_t set_intersection_size(const uint32_t* a, size_t na, const uint32_t* b, size_t nb) {
+    return intersect<false>(a, na, b, nb, nullptr);
+}
+
+size_t set_union(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    if (nb / set_gallop_ratio > na) {
+        return unite_gallop(a, na, b, nb, out);
+    }
+    if (na / set_gallop_ratio > nb) {
+        return unite_gallop(b, nb, a, na, out);
+    }
+
+    // The merge writes the smaller head on every step, and advances both lists when the heads are equal
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+    while (i < na && j < nb) {
+        uint32_t x = a[i];
+        uint32_t y = b[j];
+        out[k++] = x <= y ? x : y;
+        i += x <= y ? 1 : 0;
+        j += y <= x ? 1 : 0;
+    }
+
+    copy_values(out + k, a + i, na - i);
+    k += na - i;
+    copy_values(out + k, b + j, nb - j);
+
+    return k + (nb - j);
+}
+
+size_t set_difference(const uint32_t* a, size_t na, const uint32_t* b, size_t nb, uint32_t* out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+
+    if (nb / set_gallop_ratio > na) {
+        const uint32_t* pos = b;
+        for (; i < na; i++) {
+            pos = gallop_lower_bound(pos, b + nb, a[i], std::less<uint32_t>());
+            out[k] = a[i];
+            k += pos != b + nb && *pos == a[i] ? 0 : 1;
+        }
+
+        return k;
+    }
+
+    if (na / set_gallop_ratio > nb) {
+        for (; j < nb; j++) {
+            const uint32_t* found = gallop_lower_bound(a + i, a + na, b[j], std::less<uint32_t>());
+            size_t run = found - (a + i);
+            copy_values(out + k, a + i, run);
+            k += run;
+            i += run + (found != a + na && *found == b[j] ? 1 : 0);
+        }
+    } else {
+        // The values of the first list already matched by the vector loop, starting with the one at i
+        unsigned skip = 0;
+#if defined(SKETCH_STL_X86)
+        static const bool avx2 = cpu_has_avx2();
+        if (avx2) {
+            k = subtract_avx2(a, na, b, nb, out, i, j, skip);
+        }
+#endif
+
+        while (i < na && j < nb) {
+            uint32_t x = a[i];
+            uint32_t y = b[j];
+            unsigned stepA = x <= y ? 1 : 0;
+
+            out[k] = x;
+            k += (x < y ? 1 : 0) & ~skip & 1;
+            i += stepA;
+            skip >>= stepA;
+            j += y <= x ? 1 : 0;
+        }
+
+        for (; i < na; i++) {
+            out[k] = a[i];
+            k += ~skip & 1;
+            skip >>= 1;
+        }
+
+        return k;
+    }
+
+    copy_values(out + k, a + i, na - i);
+    return k + (na - i);
+}
+
+void string_sort_indices(const string* strings, size_t n, uint32_t* order) {
+    assert(n <= UINT32_MAX);
+
+    vector<string_record> records(n);
+    for (size_t i = 0; i < n; i++) {
+        assert(strings[i].length() <= UINT32_MAX);
+        string_record& record = records[i];
+        record.data = (const unsigned char*)strings[i].data();
+        record.length = (uint32_t)strings[i].length();
+        record.index = (uint32_t)i;
+        record.key = string_key(record.data, record.length, 0);
+    }
+
+    if (n > 1) {
+        string_quicksort(records.data(), n, 0, 2 * floor_log2(n));
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        order[i] = records[i].index;
+    }
+}
+
+}
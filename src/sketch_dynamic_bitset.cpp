@@ -0,0 +1,387 @@
+#include "sketch_dynamic_bitset.h"
+#include "sketch_bit.h"
+#include "sketch_cpu.h"
+
+#if defined(SKETCH_STL_X86)
+#include <immintrin.h>
+#endif
+
+namespace SketchStl {
+
+namespace {
+
+struct and_op {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a & b; }
+#if defined(SKETCH_STL_X86)
+    SKETCH_STL_TARGET("avx2") static __m256i apply_avx2(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+#endif
+};
+
+struct or_op {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a | b; }
+#if defined(SKETCH_STL_X86)
+    SKETCH_STL_TARGET("avx2") static __m256i apply_avx2(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+#endif
+};
+
+struct xor_op {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a ^ b; }
+#if defined(SKETCH_STL_X86)
+    SKETCH_STL_TARGET("avx2") static __m256i apply_avx2(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+#endif
+};
+
+struct and_not_op {
+    static uint64_t apply(uint64_t a, uint64_t b) { return a & ~b; }
+#if defined(SKETCH_STL_X86)
+    SKETCH_STL_TARGET("avx2") static __m256i apply_avx2(__m256i a, __m256i b) { return _mm256_andnot_si256(b, a); }
+#endif
+};
+
+template <typename Op>
+void combine_words(uint64_t* dst, const uint64_t* src, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        dst[i] = Op::apply(dst[i], src[i]);
+    }
+}
+
+#if defined(SKETCH_STL_X86)
+template <typename Op>
+SKETCH_STL_TARGET("avx2") void combine_words_avx2(uint64_t* dst, const uint64_t* src, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256i a = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), Op::apply_avx2(a, b));
+    }
+
+    for (; i < n; i++) {
+        dst[i] = Op::apply(dst[i], src[i]);
+    }
+}
+#endif
+
+/**
+ * Combine two arrays of words in place, with the widest instructions the processor supports
+ * @param dst The left operand, which receives the result
+ * @param src The right operand
+ * @param n The number of words
+ */
+template <typename Op>
+void combine(uint64_t* dst, const uint64_t* src, size_t n) {
+#if defined(SKETCH_STL_X86)
+    static const bool avx2 = cpu_has_avx2();
+    if (avx2) {
+        combine_words_avx2<Op>(dst, src, n);
+        return;
+    }
+#endif
+
+    combine_words<Op>(dst, src, n);
+}
+
+size_t popcount_words_generic(const uint64_t* words, size_t n) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += popcount(words[i]);
+    }
+
+    return total;
+}
+
+#if defined(__GNUC__) && defined(SKETCH_STL_X86)
+SKETCH_STL_TARGET("popcnt") size_t popcount_words_popcnt(const uint64_t* words, size_t n) {
+    size_t total = 0;
+    for (size_t i = 0; i < n; i++) {
+        total += (size_t)__builtin_popcountll(words[i]);
+    }
+
+    return total;
+}
+#endif
+
+/**
+ * Return the number of set bits of an array of words
+ * @param words The words
+ * @param n The number of words
+ */
+size_t popcount_words(const uint64_t* words, size_t n) {
+#if defined(__GNUC__) && defined(SKETCH_STL_X86)
+    static const bool hardware = cpu_has_popcnt();
+    if (hardware) {
+        return popcount_words_popcnt(words, n);
+    }
+#endif
+
+    return popcount_words_generic(words, n);
+}
+
+size_t word_count(size_t bits) {
+    return (bits + dynamic_bitset::bits_per_word - 1) / dynamic_bitset::bits_per_word;
+}
+
+}
+
+/////////////////////////////////////////////////////////////////////////
+dynamic_bitset::dynamic_bitset() : words_(), length_(0) {
+}
+
+dynamic_bitset::dynamic_bitset(size_t n, bool value) : words_(), length_(0) {
+    resize(n, value);
+}
+
+bool dynamic_bitset::test(size_t pos) const {
+    assert(pos < length_);
+    return ((words_[pos / bits_per_word] >> (pos % bits_per_word)) & 1) != 0;
+}
+
+void dynamic_bitset::set(size_t pos) {
+    assert(pos < length_);
+    words_[pos / bits_per_word] |= 1ULL << (pos % bits_per_word);
+}
+
+void dynamic_bitset::set(size_t pos, bool value) {
+    if (value) {
+        set(pos);
+    } else {
+        reset(pos);
+    }
+}
+
+void dynamic_bitset::reset(size_t pos) {
+    assert(pos < length_);
+    words_[pos / bits_per_word] &= ~(1ULL << (pos % bits_per_word));
+}
+
+void dynamic_bitset::flip(size_t pos) {
+    assert(pos < length_);
+    words_[pos / bits_per_word] ^= 1ULL << (pos % bits_per_word);
+}
+
+void dynamic_bitset::set() {
+    for (size_t i = 0; i < words_.size(); i++) {
+        words_[i] = ~0ULL;
+    }
+    trim();
+}
+
+void dynamic_bitset::reset() {
+    for (size_t i = 0; i < words_.size(); i++) {
+        words_[i] = 0;
+    }
+}
+
+void dynamic_bitset::resize(size_t n, bool value) {
+    // The bits past the size in the last word are 0, so only they need to be filled when growing with ones
+    if (value && n > length_ && (length_ % bits_per_word) != 0) {
+        words_[length_ / bits_per_word] |= ~0ULL << (length_ % bits_per_word);
+    }
+
+    words_.resize(word_count(n), value ? ~0ULL : 0);
+    length_ = n;
+    trim();
+}
+
+void dynamic_bitset::push_back(bool value) {
+    if ((length_ % bits_per_word) == 0) {
+        words_.push_back(0);
+    }
+
+    length_ += 1;
+    set(length_ - 1, value);
+}
+
+void dynamic_bitset::clear() {
+    words_.clear();
+    length_ = 0;
+}
+
+size_t dynamic_bitset::count() const {
+    return popcount_words(words_.data(), words_.size());
+}
+
+dynamic_bitset& dynamic_bitset::operator&=(const dynamic_bitset& rhs) {
+    assert(length_ == rhs.length_);
+    combine<and_op>(words_.data(), rhs.words_.data(), words_.size());
+    return *this;
+}
+
+dynamic_bitset& dynamic_bitset::operator|=(const dynamic_bitset& rhs) {
+    assert(length_ == rhs.length_);
+    combine<or_op>(words_.data(), rhs.words_.data(), words_.size());
+    return *this;
+}
+
+dynamic_bitset& dynamic_bitset::operator^=(const dynamic_bitset& rhs) {
+    assert(length_ == rhs.length_);
+    combine<xor_op>(words_.data(), rhs.words_.data(), words_.size());
+    return *this;
+}
+
+dynamic_bitset& dynamic_bitset::and_not(const dynamic_bitset& rhs) {
+    assert(length_ == rhs.length_);
+    combine<and_not_op>(words_.data(), rhs.words_.data(), words_.size());
+    return *this;
+}
+
+size_t dynamic_bitset::find_first() const {
+    for (size_t i = 0; i < words_.size(); i++) {
+        if (words_[i] != 0) {
+            return i * bits_per_word + count_trailing_zeros(words_[i]);
+        }
+    }
+
+    return npos;
+}
+
+size_t dynamic_bitset::find_next(size_t pos) const {
+    // Compared before adding one, which would wrap npos around to 0
+    if (length_ == 0 || pos >= length_ - 1) {
+        return npos;
+    }
+    size_t start = pos + 1;
+
+    size_t i = start / bits_per_word;
+    uint64_t word = words_[i] & (~0ULL << (start % bits_per_word));
+    for (;;) {
+        if (word != 0) {
+            return i * bits_per_word + count_trailing_zeros(word);
+        }
+
+        i += 1;
+        if (i == words_.size()) {
+            return npos;
+        }
+        word = words_[i];
+    }
+}
+
+size_t dynamic_bitset::rank(size_t pos) const {
+    assert(pos <= length_);
+
+    size_t full = pos / bits_per_word;
+    size_t total = popcount_words(words_.data(), full);
+    if ((pos % bits_per_word) != 0) {
+        total += popcount(words_[full] & ((1ULL << (pos % bits_per_word)) - 1));
+    }
+
+    return total;
+}
+
+size_t dynamic_bitset::select(size_t k) const {
+    for (size_t i = 0; i < words_.size(); i++) {
+        size_t bits = popcount(words_[i]);
+        if (k < bits) {
+            return i * bits_per_word + select_in_word(words_[i], (unsigned)k);
+        }
+        k -= bits;
+    }
+
+    return npos;
+}
+
+void dynamic_bitset::trim() {
+    if ((length_ % bits_per_word) != 0) {
+        words_.back() &= (1ULL << (length_ % bits_per_word)) - 1;
+    }
+}
+
+bool operator==(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+    if (lhs.length_ != rhs.length_) {
+        return false;
+    }
+
+    for (size_t i = 0; i < lhs.words_.size(); i++) {
+        if (lhs.words_[i] != rhs.words_[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool operator!=(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+    return !(lhs == rhs);
+}
+
+dynamic_bitset operator&(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+    dynamic_bitset result(lhs);
+    result &= rhs;
+    return result;
+}
+
+dynamic_bitset operator|(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+    dynamic_bitset result(lhs);
+    result |= rhs;
+    return result;
+}
+
+dynamic_bitset operator^(const dynamic_bitset& lhs, const dynamic_bitset& rhs) {
+    dynamic_bitset result(lhs);
+    result ^= rhs;
+    return result;
+}
+
+/////////////////////////////////////////////////////////////////////////
+bitset_rank_index::bitset_rank_index(const dynamic_bitset& bits) : bits_(&bits), blocks_() {
+    const uint64_t* words = bits.data();
+    size_t numWords = bits.num_words();
+
+    uint64_t total = 0;
+    for (size_t i = 0; i < numWords; i += words_per_block) {
+        blocks_.push_back(total);
+
+        size_t n = numWords - i < words_per_block ? numWords - i : words_per_block;
+        total += popcount_words(words + i, n);
+    }
+    blocks_.push_back(total);
+}
+
+size_t bitset_rank_index::rank(size_t pos) const {
+    assert(pos <= bits_->size());
+
+    const uint64_t* words = bits_->data();
+    size_t word = pos / dynamic_bitset::bits_per_word;
+    size_t block = word / words_per_block;
+
+    size_t total = blocks_[block];
+    for (size_t i = block * words_per_block; i < word; i++) {
+        total += popcount(words[i]);
+    }
+
+    if ((pos % dynamic_bitset::bits_per_word) != 0) {
+        total += popcount(words[word] & ((1ULL << (pos % dynamic_bitset::bits_per_word)) - 1));
+    }
+
+    return total;
+}
+
+size_t bitset_rank_index::select(size_t k) const {
+    if (k >= blocks_.back()) {
+        return dynamic_bitset::npos;
+    }
+
+    // Find the last block that starts with at most k set bits before it
+    size_t low = 0;
+    size_t high = blocks_.size() - 1;
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (blocks_[middle] <= k) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    const uint64_t* words = bits_->data();
+    k -= blocks_[low];
+    for (size_t i = low * words_per_block;; i++) {
+        size_t bits = popcount(words[i]);
+        if (k < bits) {
+            return i * dynamic_bitset::bits_per_word + select_in_word(words[i], (unsigned)k);
+        }
+        k -= bits;
+    }
+}
+
+}
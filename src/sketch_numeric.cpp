@@ -0,0 +1,915 @@
+#include "sketch_numeric.h"
+#include "sketch_bit.h"
+#include "sketch_cpu.h"
+#include "sketch_parallel.h"
+
+#include <string.h>
+
+#include <atomic>
+
+#if defined(SKETCH_STL_X86)
+#include <immintrin.h>
+#endif
+
+namespace SketchStl {
+
+namespace {
+
+simd_level detect_simd_level() {
+    if (cpu_has_avx512f()) {
+        return simd_avx512;
+    }
+    if (cpu_has_avx2()) {
+        return simd_avx2;
+    }
+
+    return simd_scalar;
+}
+
+std::atomic<int>& active_level() {
+    static std::atomic<int> level(simd_supported());
+    return level;
+}
+
+#if defined(SKETCH_STL_X86)
+bool is_aligned(const void* ptr, size_t alignment) {
+    return ((uintptr_t)ptr & (alignment - 1)) == 0;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// AVX2
+//
+// The operations on a register of each element type, for the kernels below. Sums of 32-bit integers are widened
+// into four 64-bit lanes
+
+struct avx2_i32 {
+    typedef int32_t value_type;
+    typedef int64_t sum_type;
+    typedef __m256i reg;
+    typedef __m256i acc;
+
+    static const size_t width = 8;
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx2") static reg load(const int32_t* p) {
+        return Aligned ? _mm256_load_si256((const __m256i*)p) : _mm256_loadu_si256((const __m256i*)p);
+    }
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx2") static void store(int32_t* p, reg x) {
+        if (Aligned) {
+            _mm256_store_si256((__m256i*)p, x);
+        } else {
+            _mm256_storeu_si256((__m256i*)p, x);
+        }
+    }
+
+    SKETCH_STL_TARGET("avx2") static reg set1(int32_t v) { return _mm256_set1_epi32(v); }
+    SKETCH_STL_TARGET("avx2") static acc zero() { return _mm256_setzero_si256(); }
+    SKETCH_STL_TARGET("avx2") static acc combine(acc a, acc b) { return _mm256_add_epi64(a, b); }
+
+    SKETCH_STL_TARGET("avx2") static acc add(acc a, reg x) {
+        __m256i lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x));
+        __m256i hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1));
+        return _mm256_add_epi64(a, _mm256_add_epi64(lo, hi));
+    }
+
+    SKETCH_STL_TARGET("avx2") static acc multiply_add(acc a, reg x, reg y) {
+        // The even and the odd lanes are multiplied into 64-bit products separately
+        __m256i even = _mm256_mul_epi32(x, y);
+        __m256i odd = _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32));
+        return _mm256_add_epi64(a, _mm256_add_epi64(even, odd));
+    }
+
+    SKETCH_STL_TARGET("avx2") static int64_t reduce(acc a) {
+        int64_t lanes[4];
+        _mm256_storeu_si256((__m256i*)lanes, a);
+        return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    }
+
+    SKETCH_STL_TARGET("avx2") static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+    SKETCH_STL_TARGET("avx2") static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+
+    SKETCH_STL_TARGET("avx2") static int32_t reduce_min(reg x) {
+        int32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, x);
+        return SketchStl::min<int32_t>(lanes, 8);
+    }
+
+    SKETCH_STL_TARGET("avx2") static int32_t reduce_max(reg x) {
+        int32_t lanes[8];
+        _mm256_storeu_si256((__m256i*)lanes, x);
+        return SketchStl::max<int32_t>(lanes, 8);
+    }
+
+    SKETCH_STL_TARGET("avx2") static unsigned count_equal(reg x, reg v) {
+        return popcount((unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, v))));
+    }
+
+    SKETCH_STL_TARGET("avx2") static reg scale(reg x, reg factor, reg offset) {
+        return _mm256_add_epi32(_mm256_mullo_epi32(x, factor), offset);
+    }
+};
+
+struct avx2_f32 {
+    typedef float value_type;
+    typedef float sum_type;
+    typedef __m256 reg;
+    typedef __m256 acc;
+
+    static const size_t width = 8;
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx2") static reg load(const float* p) {
+        return Aligned ? _mm256_load_ps(p) : _mm256_loadu_ps(p);
+    }
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx2") static void store(float* p, reg x) {
+        if (Aligned) {
+            _mm256_store_ps(p, x);
+        } else {
+            _mm256_storeu_ps(p, x);
+        }
+    }
+
+    SKETCH_STL_TARGET("avx2") static reg set1(float v) { return _mm256_set1_ps(v); }
+    SKETCH_STL_TARGET("avx2") static acc zero() { return _mm256_setzero_ps(); }
+    SKETCH_STL_TARGET("avx2") static acc combine(acc a, acc b) { return _mm256_add_ps(a, b); }
+    SKETCH_STL_TARGET("avx2") static acc add(acc a, reg x) { return _mm256_add_ps(a, x); }
+    SKETCH_STL_TARGET("avx2") static acc multiply_add(acc a, reg x, reg y) { return _mm256_add_ps(a, _mm256_mul_ps(x, y)); }
+
+    SKETCH_STL_TARGET("avx2") static float reduce(acc a) {
+        float lanes[8];
+        _mm256_storeu_ps(lanes, a);
+        return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+    }
+
+    SKETCH_STL_TARGET("avx2") static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+    SKETCH_STL_TARGET("avx2") static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+
+    SKETCH_STL_TARGET("avx2") static float reduce_min(reg x) {
+        float lanes[8];
+        _mm256_storeu_ps(lanes, x);
+        return SketchStl::min<float>(lanes, 8);
+    }
+
+    SKETCH_STL_TARGET("avx2") static float reduce_max(reg x) {
+        float lanes[8];
+        _mm256_storeu_ps(lanes, x);
+        return SketchStl::max<float>(lanes, 8);
+    }
+
+    SKETCH_STL_TARGET("avx2") static unsigned count_equal(reg x, reg v) {
+        return popcount((unsigned)_mm256_movemask_ps(_mm256_cmp_ps(x, v, _CMP_EQ_OQ)));
+    }
+
+    SKETCH_STL_TARGET("avx2") static reg scale(reg x, reg factor, reg offset) {
+        return _mm256_add_ps(_mm256_mul_ps(x, factor), offset);
+    }
+};
+
+/**
+ * The kernels. Sums and dot products go through four accumulators, minimums and maximums through two pairs. Aligned
+ * tells whether every array is aligned on a register
+ */
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx2") typename V::sum_type sum_avx2(const typename V::value_type* data, size_t n) {
+    const size_t w = V::width;
+    typename V::acc acc0 = V::zero();
+    typename V::acc acc1 = V::zero();
+    typename V::acc acc2 = V::zero();
+    typename V::acc acc3 = V::zero();
+
+    size_t i = 0;
+    for (; i + 4 * w <= n; i += 4 * w) {
+        acc0 = V::add(acc0, V::template load<Aligned>(data + i));
+        acc1 = V::add(acc1, V::template load<Aligned>(data + i + w));
+        acc2 = V::add(acc2, V::template load<Aligned>(data + i + 2 * w));
+        acc3 = V::add(acc3, V::template load<Aligned>(data + i + 3 * w));
+    }
+    for (; i + w <= n; i += w) {
+        acc0 = V::add(acc0, V::template load<Aligned>(data + i));
+    }
+
+    typename V::sum_type total = V::reduce(V::combine(V::combine(acc0, acc1), V::combine(acc2, acc3)));
+    for (; i < n; i++) {
+        total += data[i];
+    }
+
+    return total;
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx2") std::pair<typename V::value_type, typename V::value_type> minmax_avx2(const typename V::value_type* data, size_t n) {
+    typedef typename V::value_type T;
+    const size_t w = V::width;
+    assert(n >= w);
+
+    typename V::reg lo0 = V::template load<Aligned>(data);
+    typename V::reg hi0 = lo0;
+    typename V::reg lo1 = lo0;
+    typename V::reg hi1 = lo0;
+
+    size_t i = w;
+    for (; i + 2 * w <= n; i += 2 * w) {
+        typename V::reg x = V::template load<Aligned>(data + i);
+        typename V::reg y = V::template load<Aligned>(data + i + w);
+        lo0 = V::min(lo0, x);
+        hi0 = V::max(hi0, x);
+        lo1 = V::min(lo1, y);
+        hi1 = V::max(hi1, y);
+    }
+    for (; i + w <= n; i += w) {
+        typename V::reg x = V::template load<Aligned>(data + i);
+        lo0 = V::min(lo0, x);
+        hi0 = V::max(hi0, x);
+    }
+
+    T lo = V::reduce_min(V::min(lo0, lo1));
+    T hi = V::reduce_max(V::max(hi0, hi1));
+    for (; i < n; i++) {
+        lo = data[i] < lo ? data[i] : lo;
+        hi = data[i] > hi ? data[i] : hi;
+    }
+
+    return std::pair<T, T>(lo, hi);
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx2") typename V::sum_type dot_avx2(const typename V::value_type* a, const typename V::value_type* b, size_t n) {
+    const size_t w = V::width;
+    typename V::acc acc0 = V::zero();
+    typename V::acc acc1 = V::zero();
+    typename V::acc acc2 = V::zero();
+    typename V::acc acc3 = V::zero();
+
+    size_t i = 0;
+    for (; i + 4 * w <= n; i += 4 * w) {
+        acc0 = V::multiply_add(acc0, V::template load<Aligned>(a + i), V::template load<Aligned>(b + i));
+        acc1 = V::multiply_add(acc1, V::template load<Aligned>(a + i + w), V::template load<Aligned>(b + i + w));
+        acc2 = V::multiply_add(acc2, V::template load<Aligned>(a + i + 2 * w), V::template load<Aligned>(b + i + 2 * w));
+        acc3 = V::multiply_add(acc3, V::template load<Aligned>(a + i + 3 * w), V::template load<Aligned>(b + i + 3 * w));
+    }
+    for (; i + w <= n; i += w) {
+        acc0 = V::multiply_add(acc0, V::template load<Aligned>(a + i), V::template load<Aligned>(b + i));
+    }
+
+    typename V::sum_type total = V::reduce(V::combine(V::combine(acc0, acc1), V::combine(acc2, acc3)));
+    for (; i < n; i++) {
+        total += (typename V::sum_type)a[i] * b[i];
+    }
+
+    return total;
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx2") size_t count_avx2(const typename V::value_type* data, size_t n, typename V::value_type value) {
+    const size_t w = V::width;
+    typename V::reg v = V::set1(value);
+
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        found += V::count_equal(V::template load<Aligned>(data + i), v);
+    }
+    for (; i < n; i++) {
+        found += data[i] == value ? 1 : 0;
+    }
+
+    return found;
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx2") void fill_avx2(typename V::value_type* data, size_t n, typename V::value_type value) {
+    const size_t w = V::width;
+    typename V::reg v = V::set1(value);
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        V::template store<Aligned>(data + i, v);
+    }
+    for (; i < n; i++) {
+        data[i] = value;
+    }
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx2") void transform_avx2(const typename V::value_type* src, typename V::value_type* dst, size_t n, typename V::value_type factor, typename V::value_type offset) {
+    typedef typename V::value_type T;
+    const size_t w = V::width;
+    typename V::reg f = V::set1(factor);
+    typename V::reg o = V::set1(offset);
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        V::template store<Aligned>(dst + i, V::scale(V::template load<Aligned>(src + i), f, o));
+    }
+    for (; i < n; i++) {
+        dst[i] = multiply_add<T>::apply(src[i], factor, offset);
+    }
+}
+
+/**
+ * Scan the lanes of a register: every lane receives the sum of itself and of the lanes before it. Each half is
+ * scanned with two shifts, then the last lane of the low half is added to the high half
+ */
+SKETCH_STL_TARGET("avx2") __m256i scan_register_avx2(__m256i x) {
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+    x = _mm256_add_epi32(x, _mm256_slli_si256(x, 8));
+
+    __m256i low = _mm256_permute2x128_si256(x, x, 0x08);
+    return _mm256_add_epi32(x, _mm256_shuffle_epi32(low, 0xFF));
+}
+
+template <bool Exclusive>
+SKETCH_STL_TARGET("avx2") uint32_t scan_avx2(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init) {
+    // The running total is kept in every lane, and the next one is taken from the last lane of the sums
+    const __m256i last = _mm256_set1_epi32(7);
+    __m256i carry = _mm256_set1_epi32((int)init);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i sums = _mm256_add_epi32(carry, scan_register_avx2(x));
+        _mm256_storeu_si256((__m256i*)(dst + i), Exclusive ? _mm256_sub_epi32(sums, x) : sums);
+        carry = _mm256_permutevar8x32_epi32(sums, last);
+    }
+
+    uint32_t total = (uint32_t)_mm256_cvtsi256_si32(carry);
+    for (; i < n; i++) {
+        uint32_t value = src[i];
+        total += value;
+        dst[i] = Exclusive ? total - value : total;
+    }
+
+    return total;
+}
+
+/////////////////////////////////////////////////////////////////////////
+// AVX-512
+//
+// The same operations and kernels on registers twice as wide. GCC builds the narrower results of several AVX-512
+// intrinsics on top of an undefined register, and warns that it may be used uninitialized once they are inlined
+// into the kernels, although no undefined lane is ever read
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+
+struct avx512_i32 {
+    typedef int32_t value_type;
+    typedef int64_t sum_type;
+    typedef __m512i reg;
+    typedef __m512i acc;
+
+    static const size_t width = 16;
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx512f") static reg load(const int32_t* p) {
+        return Aligned ? _mm512_load_si512((const void*)p) : _mm512_loadu_si512((const void*)p);
+    }
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx512f") static void store(int32_t* p, reg x) {
+        if (Aligned) {
+            _mm512_store_si512((void*)p, x);
+        } else {
+            _mm512_storeu_si512((void*)p, x);
+        }
+    }
+
+    SKETCH_STL_TARGET("avx512f") static reg set1(int32_t v) { return _mm512_set1_epi32(v); }
+    SKETCH_STL_TARGET("avx512f") static acc zero() { return _mm512_setzero_si512(); }
+    SKETCH_STL_TARGET("avx512f") static acc combine(acc a, acc b) { return _mm512_add_epi64(a, b); }
+
+    SKETCH_STL_TARGET("avx512f") static acc add(acc a, reg x) {
+        __m512i lo = _mm512_cvtepi32_epi64(_mm512_castsi512_si256(x));
+        __m512i hi = _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(x, 1));
+        return _mm512_add_epi64(a, _mm512_add_epi64(lo, hi));
+    }
+
+    SKETCH_STL_TARGET("avx512f") static acc multiply_add(acc a, reg x, reg y) {
+        __m512i even = _mm512_mul_epi32(x, y);
+        __m512i odd = _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32));
+        return _mm512_add_epi64(a, _mm512_add_epi64(even, odd));
+    }
+
+    SKETCH_STL_TARGET("avx512f") static int64_t reduce(acc a) { return _mm512_reduce_add_epi64(a); }
+    SKETCH_STL_TARGET("avx512f") static reg min(reg a, reg b) { return _mm512_min_epi32(a, b); }
+    SKETCH_STL_TARGET("avx512f") static reg max(reg a, reg b) { return _mm512_max_epi32(a, b); }
+    SKETCH_STL_TARGET("avx512f") static int32_t reduce_min(reg x) { return _mm512_reduce_min_epi32(x); }
+    SKETCH_STL_TARGET("avx512f") static int32_t reduce_max(reg x) { return _mm512_reduce_max_epi32(x); }
+
+    SKETCH_STL_TARGET("avx512f") static unsigned count_equal(reg x, reg v) {
+        return popcount((unsigned)_mm512_cmpeq_epi32_mask(x, v));
+    }
+
+    SKETCH_STL_TARGET("avx512f") static reg scale(reg x, reg factor, reg offset) {
+        return _mm512_add_epi32(_mm512_mullo_epi32(x, factor), offset);
+    }
+};
+
+struct avx512_f32 {
+    typedef float value_type;
+    typedef float sum_type;
+    typedef __m512 reg;
+    typedef __m512 acc;
+
+    static const size_t width = 16;
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx512f") static reg load(const float* p) {
+        return Aligned ? _mm512_load_ps(p) : _mm512_loadu_ps(p);
+    }
+
+    template <bool Aligned>
+    SKETCH_STL_TARGET("avx512f") static void store(float* p, reg x) {
+        if (Aligned) {
+            _mm512_store_ps(p, x);
+        } else {
+            _mm512_storeu_ps(p, x);
+        }
+    }
+
+    SKETCH_STL_TARGET("avx512f") static reg set1(float v) { return _mm512_set1_ps(v); }
+    SKETCH_STL_TARGET("avx512f") static acc zero() { return _mm512_setzero_ps(); }
+    SKETCH_STL_TARGET("avx512f") static acc combine(acc a, acc b) { return _mm512_add_ps(a, b); }
+    SKETCH_STL_TARGET("avx512f") static acc add(acc a, reg x) { return _mm512_add_ps(a, x); }
+    SKETCH_STL_TARGET("avx512f") static acc multiply_add(acc a, reg x, reg y) { return _mm512_add_ps(a, _mm512_mul_ps(x, y)); }
+    SKETCH_STL_TARGET("avx512f") static float reduce(acc a) { return _mm512_reduce_add_ps(a); }
+    SKETCH_STL_TARGET("avx512f") static reg min(reg a, reg b) { return _mm512_min_ps(a, b); }
+    SKETCH_STL_TARGET("avx512f") static reg max(reg a, reg b) { return _mm512_max_ps(a, b); }
+    SKETCH_STL_TARGET("avx512f") static float reduce_min(reg x) { return _mm512_reduce_min_ps(x); }
+    SKETCH_STL_TARGET("avx512f") static float reduce_max(reg x) { return _mm512_reduce_max_ps(x); }
+
+    SKETCH_STL_TARGET("avx512f") static unsigned count_equal(reg x, reg v) {
+        return popcount((unsigned)_mm512_cmp_ps_mask(x, v, _CMP_EQ_OQ));
+    }
+
+    SKETCH_STL_TARGET("avx512f") static reg scale(reg x, reg factor, reg offset) {
+        return _mm512_add_ps(_mm512_mul_ps(x, factor), offset);
+    }
+};
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx512f") typename V::sum_type sum_avx512(const typename V::value_type* data, size_t n) {
+    const size_t w = V::width;
+    typename V::acc acc0 = V::zero();
+    typename V::acc acc1 = V::zero();
+    typename V::acc acc2 = V::zero();
+    typename V::acc acc3 = V::zero();
+
+    size_t i = 0;
+    for (; i + 4 * w <= n; i += 4 * w) {
+        acc0 = V::add(acc0, V::template load<Aligned>(data + i));
+        acc1 = V::add(acc1, V::template load<Aligned>(data + i + w));
+        acc2 = V::add(acc2, V::template load<Aligned>(data + i + 2 * w));
+        acc3 = V::add(acc3, V::template load<Aligned>(data + i + 3 * w));
+    }
+    for (; i + w <= n; i += w) {
+        acc0 = V::add(acc0, V::template load<Aligned>(data + i));
+    }
+
+    typename V::sum_type total = V::reduce(V::combine(V::combine(acc0, acc1), V::combine(acc2, acc3)));
+    for (; i < n; i++) {
+        total += data[i];
+    }
+
+    return total;
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx512f") std::pair<typename V::value_type, typename V::value_type> minmax_avx512(const typename V::value_type* data, size_t n) {
+    typedef typename V::value_type T;
+    const size_t w = V::width;
+    assert(n >= w);
+
+    typename V::reg lo0 = V::template load<Aligned>(data);
+    typename V::reg hi0 = lo0;
+    typename V::reg lo1 = lo0;
+    typename V::reg hi1 = lo0;
+
+    size_t i = w;
+    for (; i + 2 * w <= n; i += 2 * w) {
+        typename V::reg x = V::template load<Aligned>(data + i);
+        typename V::reg y = V::template load<Aligned>(data + i + w);
+        lo0 = V::min(lo0, x);
+        hi0 = V::max(hi0, x);
+        lo1 = V::min(lo1, y);
+        hi1 = V::max(hi1, y);
+    }
+    for (; i + w <= n; i += w) {
+        typename V::reg x = V::template load<Aligned>(data + i);
+        lo0 = V::min(lo0, x);
+        hi0 = V::max(hi0, x);
+    }
+
+    T lo = V::reduce_min(V::min(lo0, lo1));
+    T hi = V::reduce_max(V::max(hi0, hi1));
+    for (; i < n; i++) {
+        lo = data[i] < lo ? data[i] : lo;
+        hi = data[i] > hi ? data[i] : hi;
+    }
+
+    return std::pair<T, T>(lo, hi);
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx512f") typename V::sum_type dot_avx512(const typename V::value_type* a, const typename V::value_type* b, size_t n) {
+    const size_t w = V::width;
+    typename V::acc acc0 = V::zero();
+    typename V::acc acc1 = V::zero();
+    typename V::acc acc2 = V::zero();
+    typename V::acc acc3 = V::zero();
+
+    size_t i = 0;
+    for (; i + 4 * w <= n; i += 4 * w) {
+        acc0 = V::multiply_add(acc0, V::template load<Aligned>(a + i), V::template load<Aligned>(b + i));
+        acc1 = V::multiply_add(acc1, V::template load<Aligned>(a + i + w), V::template load<Aligned>(b + i + w));
+        acc2 = V::multiply_add(acc2, V::template load<Aligned>(a + i + 2 * w), V::template load<Aligned>(b + i + 2 * w));
+        acc3 = V::multiply_add(acc3, V::template load<Aligned>(a + i + 3 * w), V::template load<Aligned>(b + i + 3 * w));
+    }
+    for (; i + w <= n; i += w) {
+        acc0 = V::multiply_add(acc0, V::template load<Aligned>(a + i), V::template load<Aligned>(b + i));
+    }
+
+    typename V::sum_type total = V::reduce(V::combine(V::combine(acc0, acc1), V::combine(acc2, acc3)));
+    for (; i < n; i++) {
+        total += (typename V::sum_type)a[i] * b[i];
+    }
+
+    return total;
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx512f") size_t count_avx512(const typename V::value_type* data, size_t n, typename V::value_type value) {
+    const size_t w = V::width;
+    typename V::reg v = V::set1(value);
+
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        found += V::count_equal(V::template load<Aligned>(data + i), v);
+    }
+    for (; i < n; i++) {
+        found += data[i] == value ? 1 : 0;
+    }
+
+    return found;
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx512f") void fill_avx512(typename V::value_type* data, size_t n, typename V::value_type value) {
+    const size_t w = V::width;
+    typename V::reg v = V::set1(value);
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        V::template store<Aligned>(data + i, v);
+    }
+    for (; i < n; i++) {
+        data[i] = value;
+    }
+}
+
+template <typename V, bool Aligned>
+SKETCH_STL_TARGET("avx512f") void transform_avx512(const typename V::value_type* src, typename V::value_type* dst, size_t n, typename V::value_type factor, typename V::value_type offset) {
+    typedef typename V::value_type T;
+    const size_t w = V::width;
+    typename V::reg f = V::set1(factor);
+    typename V::reg o = V::set1(offset);
+
+    size_t i = 0;
+    for (; i + w <= n; i += w) {
+        V::template store<Aligned>(dst + i, V::scale(V::template load<Aligned>(src + i), f, o));
+    }
+    for (; i < n; i++) {
+        dst[i] = multiply_add<T>::apply(src[i], factor, offset);
+    }
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+/////////////////////////////////////////////////////////////////////////
+// DISPATCH
+
+template <typename T>
+struct simd_traits;
+
+template <>
+struct simd_traits<int32_t> {
+    typedef avx2_i32 avx2;
+    typedef avx512_i32 avx512;
+};
+
+template <>
+struct simd_traits<float> {
+    typedef avx2_f32 avx2;
+    typedef avx512_f32 avx512;
+};
+#endif
+
+template <typename T>
+typename accumulator_type<T>::type dispatch_sum(const T* data, size_t n) {
+#if defined(SKETCH_STL_X86)
+    typedef typename simd_traits<T>::avx2 avx2;
+    typedef typename simd_traits<T>::avx512 avx512;
+
+    switch (simd_active()) {
+        case simd_avx512:
+            return is_aligned(data, 64) ? sum_avx512<avx512, true>(data, n) : sum_avx512<avx512, false>(data, n);
+        case simd_avx2:
+            return is_aligned(data, 32) ? sum_avx2<avx2, true>(data, n) : sum_avx2<avx2, false>(data, n);
+        default:
+            break;
+    }
+#endif
+
+    return SketchStl::sum<T>(data, n);
+}
+
+template <typename T>
+std::pair<T, T> dispatch_minmax(const T* data, size_t n) {
+    assert(n > 0);
+
+#if defined(SKETCH_STL_X86)
+    typedef typename simd_traits<T>::avx2 avx2;
+    typedef typename simd_traits<T>::avx512 avx512;
+
+    simd_level level = simd_active();
+    if (level == simd_avx512 && n >= avx512::width) {
+        return is_aligned(data, 64) ? minmax_avx512<avx512, true>(data, n) : minmax_avx512<avx512, false>(data, n);
+    }
+    if (level >= simd_avx2 && n >= avx2::width) {
+        return is_aligned(data, 32) ? minmax_avx2<avx2, true>(data, n) : minmax_avx2<avx2, false>(data, n);
+    }
+#endif
+
+    return SketchStl::minmax<T>(data, n);
+}
+
+template <typename T>
+typename accumulator_type<T>::type dispatch_dot(const T* a, const T* b, size_t n) {
+#if defined(SKETCH_STL_X86)
+    typedef typename simd_traits<T>::avx2 avx2;
+    typedef typename simd_traits<T>::avx512 avx512;
+
+    switch (simd_active()) {
+        case simd_avx512:
+            return is_aligned(a, 64) && is_aligned(b, 64) ? dot_avx512<avx512, true>(a, b, n) : dot_avx512<avx512, false>(a, b, n);
+        case simd_avx2:
+            return is_aligned(a, 32) && is_aligned(b, 32) ? dot_avx2<avx2, true>(a, b, n) : dot_avx2<avx2, false>(a, b, n);
+        default:
+            break;
+    }
+#endif
+
+    return SketchStl::dot<T>(a, b, n);
+}
+
+template <typename T>
+size_t dispatch_count(const T* data, size_t n, T value) {
+#if defined(SKETCH_STL_X86)
+    typedef typename simd_traits<T>::avx2 avx2;
+    typedef typename simd_traits<T>::avx512 avx512;
+
+    switch (simd_active()) {
+        case simd_avx512:
+            return is_aligned(data, 64) ? count_avx512<avx512, true>(data, n, value) : count_avx512<avx512, false>(data, n, value);
+        case simd_avx2:
+            return is_aligned(data, 32) ? count_avx2<avx2, true>(data, n, value) : count_avx2<avx2, false>(data, n, value);
+        default:
+            break;
+    }
+#endif
+
+    return SketchStl::count<T>(data, n, value);
+}
+
+template <typename T>
+void dispatch_fill(T* data, size_t n, T value) {
+#if defined(SKETCH_STL_X86)
+    typedef typename simd_traits<T>::avx2 avx2;
+    typedef typename simd_traits<T>::avx512 avx512;
+
+    switch (simd_active()) {
+        case simd_avx512:
+            return is_aligned(data, 64) ? fill_avx512<avx512, true>(data, n, value) : fill_avx512<avx512, false>(data, n, value);
+        case simd_avx2:
+            return is_aligned(data, 32) ? fill_avx2<avx2, true>(data, n, value) : fill_avx2<avx2, false>(data, n, value);
+        default:
+            break;
+    }
+#endif
+
+    SketchStl::fill<T>(data, n, value);
+}
+
+template <typename T>
+void dispatch_transform(const T* src, T* dst, size_t n, T factor, T offset) {
+#if defined(SKETCH_STL_X86)
+    typedef typename simd_traits<T>::avx2 avx2;
+    typedef typename simd_traits<T>::avx512 avx512;
+
+    switch (simd_active()) {
+        case simd_avx512:
+            if (is_aligned(src, 64) && is_aligned(dst, 64)) {
+                return transform_avx512<avx512, true>(src, dst, n, factor, offset);
+            }
+            return transform_avx512<avx512, false>(src, dst, n, factor, offset);
+        case simd_avx2:
+            if (is_aligned(src, 32) && is_aligned(dst, 32)) {
+                return transform_avx2<avx2, true>(src, dst, n, factor, offset);
+            }
+            return transform_avx2<avx2, false>(src, dst, n, factor, offset);
+        default:
+            break;
+    }
+#endif
+
+    SketchStl::transform<T>(src, dst, n, factor, offset);
+}
+
+
+/**
+ * Scan an array from a running total, which the parallel scans start every block from
+ * @return The running total after the last element
+ */
+template <bool Exclusive>
+uint32_t scan(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init) {
+#if defined(SKETCH_STL_X86)
+    if (simd_active() >= simd_avx2) {
+        return scan_avx2<Exclusive>(src, dst, n, init);
+    }
+#endif
+
+    uint32_t total = init;
+    for (size_t i = 0; i < n; i++) {
+        uint32_t value = src[i];
+        total += value;
+        dst[i] = Exclusive ? total - value : total;
+    }
+
+    return total;
+}
+
+template <bool Exclusive>
+uint32_t parallel_scan(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init, unsigned threads) {
+    size_t blocks = parallel_block_count(n, parallel_scan_min_block, threads);
+    if (blocks <= 1) {
+        return scan<Exclusive>(src, dst, n, init);
+    }
+
+    vector<uint32_t> starts(blocks);
+
+    // Every block is summed before any is written, since dst can be src
+    parallel_for_blocks(n, blocks, [&](size_t b, size_t first, size_t last) {
+        starts[b] = SketchStl::sum<uint32_t>(src + first, last - first);
+    });
+
+    uint32_t total = scan<true>(starts.data(), starts.data(), blocks, init);
+
+    parallel_for_blocks(n, blocks, [&](size_t b, size_t first, size_t last) {
+        scan<Exclusive>(src + first, dst + first, last - first, starts[b]);
+    });
+
+    return total;
+}
+}
+
+simd_level simd_supported() {
+    static const simd_level level = detect_simd_level();
+    return level;
+}
+
+simd_level simd_active() {
+    return (simd_level)active_level().load(std::memory_order_relaxed);
+}
+
+void set_simd_active(simd_level level) {
+    active_level().store(level < simd_supported() ? level : simd_supported(), std::memory_order_relaxed);
+}
+
+int64_t sum(const int32_t* data, size_t n) {
+    return dispatch_sum(data, n);
+}
+
+float sum(const float* data, size_t n) {
+    return dispatch_sum(data, n);
+}
+
+int32_t min(const int32_t* data, size_t n) {
+    return dispatch_minmax(data, n).first;
+}
+
+float min(const float* data, size_t n) {
+    return dispatch_minmax(data, n).first;
+}
+
+int32_t max(const int32_t* data, size_t n) {
+    return dispatch_minmax(data, n).second;
+}
+
+float max(const float* data, size_t n) {
+    return dispatch_minmax(data, n).second;
+}
+
+std::pair<int32_t, int32_t> minmax(const int32_t* data, size_t n) {
+    return dispatch_minmax(data, n);
+}
+
+std::pair<float, float> minmax(const float* data, size_t n) {
+    return dispatch_minmax(data, n);
+}
+
+int64_t dot(const int32_t* a, const int32_t* b, size_t n) {
+    return dispatch_dot(a, b, n);
+}
+
+float dot(const float* a, const float* b, size_t n) {
+    return dispatch_dot(a, b, n);
+}
+
+size_t count(const int32_t* data, size_t n, int32_t value) {
+    return dispatch_count(data, n, value);
+}
+
+size_t count(const float* data, size_t n, float value) {
+    return dispatch_count(data, n, value);
+}
+
+void fill(int32_t* data, size_t n, int32_t value) {
+    dispatch_fill(data, n, value);
+}
+
+void fill(float* data, size_t n, float value) {
+    dispatch_fill(data, n, value);
+}
+
+void transform(const int32_t* src, int32_t* dst, size_t n, int32_t scale, int32_t offset) {
+    dispatch_transform(src, dst, n, scale, offset);
+}
+
+void transform(const float* src, float* dst, size_t n, float scale, float offset) {
+    dispatch_transform(src, dst, n, scale, offset);
+}
+
+uint32_t inclusive_scan(const uint32_t* src, uint32_t* dst, size_t n) {
+    return scan<false>(src, dst, n, 0);
+}
+
+uint32_t exclusive_scan(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init) {
+    return scan<true>(src, dst, n, init);
+}
+
+uint32_t parallel_inclusive_scan(const uint32_t* src, uint32_t* dst, size_t n, unsigned threads) {
+    return parallel_scan<false>(src, dst, n, 0, threads);
+}
+
+uint32_t parallel_exclusive_scan(const uint32_t* src, uint32_t* dst, size_t n, uint32_t init, unsigned threads) {
+    return parallel_scan<true>(src, dst, n, init, threads);
+}
+
+void histogram(const uint32_t* values, size_t n, uint32_t* counts, size_t buckets) {
+    if (buckets > histogram_lane_buckets) {
+        SketchStl::fill<uint32_t>(counts, buckets, 0);
+        for (size_t i = 0; i < n; i++) {
+            assert(values[i] < buckets);
+            counts[values[i]] += 1;
+        }
+
+        return;
+    }
+
+    // Four tables, one per element of a group of four, summed at the end
+    uint32_t lanes[4 * histogram_lane_buckets];
+    memset(lanes, 0, 4 * buckets * sizeof(uint32_t));
+    uint32_t* lane0 = lanes;
+    uint32_t* lane1 = lanes + buckets;
+    uint32_t* lane2 = lanes + 2 * buckets;
+    uint32_t* lane3 = lanes + 3 * buckets;
+
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        assert(values[i] < buckets && values[i + 1] < buckets && values[i + 2] < buckets && values[i + 3] < buckets);
+        lane0[values[i]] += 1;
+        lane1[values[i + 1]] += 1;
+        lane2[values[i + 2]] += 1;
+        lane3[values[i + 3]] += 1;
+    }
+    for (; i < n; i++) {
+        assert(values[i] < buckets);
+        lane0[values[i]] += 1;
+    }
+
+    for (size_t b = 0; b < buckets; b++) {
+        counts[b] = (lane0[b] + lane1[b]) + (lane2[b] + lane3[b]);
+    }
+}
+
+}
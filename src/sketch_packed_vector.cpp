@@ -0,0 +1,194 @@
+#include "sketch_packed_vector.h"
+#include "sketch_bit.h"
+#include "sketch_cpu.h"
+
+#if defined(SKETCH_STL_X86)
+#include <immintrin.h>
+#endif
+
+namespace SketchStl {
+
+namespace {
+
+void unpack_bits_generic(const uint64_t* words, unsigned bits, size_t first, size_t n, uint32_t* out) {
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (uint32_t)extract_bits(words, (first + i) * bits, bits);
+    }
+}
+
+#if defined(SKETCH_STL_X86)
+/**
+ * Decode groups of eight fields with a 32-bit gather: every lane loads the four bytes that start at the byte
+ * holding the first bit of its field, then shifts and masks it. A field therefore has to fit in 32 bits minus
+ * the 7 bits of misalignment, which limits this path to 25-bit fields
+ * @return The number of fields decoded, a multiple of eight. The caller decodes the rest
+ */
+SKETCH_STL_TARGET("avx2") size_t unpack_bits_avx2(const uint64_t* words, size_t numWords, unsigned bits, size_t first, size_t n, uint32_t* out) {
+    const char* bytes = (const char*)words;
+    const size_t numBytes = numWords * sizeof(uint64_t);
+
+    const __m256i lanes = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(bits));
+    const __m256i mask = _mm256_set1_epi32((int)((1U << bits) - 1));
+    const __m256i seven = _mm256_set1_epi32(7);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        size_t lastBit = (first + i + 7) * bits;
+        if (lastBit / 8 + 4 > numBytes) {
+            break;
+        }
+
+        // Offsets are taken from the byte holding the first field, so that they fit in 32-bit lanes
+        size_t baseBit = (first + i) * bits;
+        __m256i bitOffsets = _mm256_add_epi32(lanes, _mm256_set1_epi32((int)(baseBit % 8)));
+        __m256i byteOffsets = _mm256_srli_epi32(bitOffsets, 3);
+        __m256i shifts = _mm256_and_si256(bitOffsets, seven);
+
+        __m256i raw = _mm256_i32gather_epi32((const int*)(bytes + baseBit / 8), byteOffsets, 1);
+        __m256i values = _mm256_and_si256(_mm256_srlv_epi32(raw, shifts), mask);
+        _mm256_storeu_si256((__m256i*)(out + i), values);
+    }
+
+    return i;
+}
+#endif
+
+unsigned bit_width(uint32_t x) {
+    return x == 0 ? 0 : floor_log2(x) + 1;
+}
+
+}
+
+void unpack_bits(const uint64_t* words, size_t numWords, unsigned bits, size_t first, size_t n, uint32_t* out) {
+    assert(bits <= 32);
+
+    if (bits == 0) {
+        for (size_t i = 0; i < n; i++) {
+            out[i] = 0;
+        }
+        return;
+    }
+
+    size_t done = 0;
+#if defined(SKETCH_STL_X86)
+    static const bool avx2 = cpu_has_avx2();
+    if (avx2 && bits <= 25) {
+        done = unpack_bits_avx2(words, numWords, bits, first, n, out);
+    }
+#else
+    (void)numWords;
+#endif
+
+    unpack_bits_generic(words, bits, first + done, n - done, out + done);
+}
+
+/////////////////////////////////////////////////////////////////////////
+delta_sequence::delta_sequence() : blocks_(), words_(), pending_(), length_(0) {
+}
+
+size_t delta_sequence::memory_bytes() const {
+    return blocks_.size() * sizeof(block) + words_.size() * sizeof(uint64_t) + pending_.size() * sizeof(uint32_t);
+}
+
+uint32_t delta_sequence::operator[](size_t n) const {
+    assert(n < length_);
+
+    size_t index = n / block_size;
+    size_t pos = n % block_size;
+    if (index == blocks_.size()) {
+        return pending_[pos];
+    }
+
+    const block& b = blocks_[index];
+    uint32_t value = b.base + (uint32_t)pos * b.minDelta;
+    if (b.bits > 0) {
+        for (size_t i = 0; i < pos; i++) {
+            value += (uint32_t)extract_bits(&words_[b.offset], i * b.bits, b.bits);
+        }
+    }
+
+    return value;
+}
+
+void delta_sequence::push_back(uint32_t value) {
+    pending_.push_back(value);
+    length_ += 1;
+
+    if (pending_.size() == block_size) {
+        flush();
+    }
+}
+
+size_t delta_sequence::decode_block(size_t n, uint32_t* out) const {
+    assert(n < num_blocks());
+
+    if (n == blocks_.size()) {
+        for (size_t i = 0; i < pending_.size(); i++) {
+            out[i] = pending_[i];
+        }
+        return pending_.size();
+    }
+
+    const block& b = blocks_[n];
+    size_t numWords = (b.bits * (block_size - 1) + 63) / 64;
+
+    // The differences are decoded in place after the first value, then summed up
+    out[0] = b.base;
+    unpack_bits(numWords > 0 ? &words_[b.offset] : nullptr, numWords, b.bits, 0, block_size - 1, out + 1);
+    for (size_t i = 1; i < block_size; i++) {
+        out[i] += out[i - 1] + b.minDelta;
+    }
+
+    return block_size;
+}
+
+void delta_sequence::unpack(vector<uint32_t>& out) const {
+    out.resize(length_);
+    for (size_t i = 0; i < num_blocks(); i++) {
+        decode_block(i, out.data() + i * block_size);
+    }
+}
+
+void delta_sequence::clear() {
+    blocks_.clear();
+    words_.clear();
+    pending_.clear();
+    length_ = 0;
+}
+
+void delta_sequence::flush() {
+    uint32_t deltas[block_size - 1];
+    uint32_t minDelta = 0xFFFFFFFF;
+    for (size_t i = 1; i < block_size; i++) {
+        deltas[i - 1] = pending_[i] - pending_[i - 1];
+        minDelta = deltas[i - 1] < minDelta ? deltas[i - 1] : minDelta;
+    }
+
+    uint32_t maxOffset = 0;
+    for (size_t i = 0; i < block_size - 1; i++) {
+        deltas[i] -= minDelta;
+        maxOffset = deltas[i] > maxOffset ? deltas[i] : maxOffset;
+    }
+
+    block b;
+    b.base = pending_[0];
+    b.minDelta = minDelta;
+    b.offset = words_.size();
+    b.bits = bit_width(maxOffset);
+
+    size_t numWords = (b.bits * (block_size - 1) + 63) / 64;
+    for (size_t i = 0; i < numWords; i++) {
+        words_.push_back(0);
+    }
+
+    if (b.bits > 0) {
+        for (size_t i = 0; i < block_size - 1; i++) {
+            deposit_bits(&words_[b.offset], i * b.bits, b.bits, deltas[i]);
+        }
+    }
+
+    blocks_.push_back(b);
+    pending_.clear();
+}
+
+}
@@ -11,7 +11,7 @@ string::string() : data_(nullptr), length_(0), capacity_(1) {
 
 string::string(const string& str) {
     length_ = str.length_;
-    capacity_ = str.capacity_;
+    capacity_ = str.capacity_ > 0 ? str.capacity_ : 1;
 
     data_ = (char*)malloc(capacity_);
     for (size_t i = 0; i < length_; i++) {
@@ -20,6 +20,12 @@ string::string(const string& str) {
     data_[length_] = '\0';
 }
 
+string::string(string&& str) noexcept : data_(str.data_), length_(str.length_), capacity_(str.capacity_) {
+    str.data_ = nullptr;
+    str.length_ = 0;
+    str.capacity_ = 0;
+}
+
 string::string(const string& str, size_t pos, size_t len) : data_(nullptr), length_(len), capacity_(len) {
     if (len == npos) {
         length_ = str.length_ - pos;
@@ -84,7 +90,7 @@ string& string::operator=(const string& str) {
         free(data_);
 
         length_ = str.length_;
-        capacity_ = str.capacity_;
+        capacity_ = str.capacity_ > 0 ? str.capacity_ : 1;
 
         data_ = (char*)malloc(capacity_);
         for (size_t i = 0; i < length_; i++) {
@@ -96,6 +102,11 @@ string& string::operator=(const string& str) {
     return *this;
 }
 
+string& string::operator=(string&& str) noexcept {
+    swap(str);
+    return *this;
+}
+
 string& string::operator=(const char* s) {
     if (s != nullptr) {
         free(data_);
@@ -192,7 +203,7 @@ size_t string::capacity() const {
 }
 
 void string::reserve(size_t n) {
-    if (n > (capacity_ - 1)) {
+    if (n + 1 > capacity_) {
         char* newData = (char*)malloc(n + 1);
 
         for (size_t i = 0; i < length_; i++) {
@@ -239,7 +250,7 @@ const char& string::at(size_t pos) const {
 
 string& string::operator+=(const string& str) {
     size_t newSize = length_ + str.length_;
-    if (newSize > (capacity_ - 1)) {
+    if (newSize + 1 > capacity_) {
         char* newData = (char*)malloc(newSize + 1);
 
         for (size_t i = 0; i < length_; i++) {
@@ -266,8 +277,8 @@ string& string::operator+=(const char* s) {
 }
 
 string& string::operator+=(char c) {
-    if (length_ + 1 > (capacity_ - 1)) {
-        char* newData = (char*)malloc(capacity_ + 1);
+    if (length_ + 2 > capacity_) {
+        char* newData = (char*)malloc(length_ + 2);
 
         for (size_t i = 0; i < length_; i++) {
             newData[i] = data_[i];
@@ -275,12 +286,12 @@ string& string::operator+=(char c) {
 
         free(data_);
         data_ = newData;
+        capacity_ = length_ + 2;
     }
 
     data_[length_] = c;
     data_[length_ + 1] = '\0';
     length_ += 1;
-    capacity_ += 1;
 
     return *this;
 }
@@ -336,7 +347,7 @@ string& string::assign(size_t n, char c) {
 string& string::insert(size_t pos, const string& str) {
     size_t newLength = length_ + str.length_;
 
-    if (newLength > (capacity_ - 1)) {
+    if (newLength + 1 > capacity_) {
         // Allocate enough space and insert the string
         char* newData = (char*)malloc(newLength + 1);
 
@@ -466,7 +477,7 @@ string& string::replace(size_t pos, size_t len, const string& str) {
     }
 
     size_t newSize = length_ - len + str.length_;
-    if (newSize > (capacity_ - 1)) {
+    if (newSize + 1 > capacity_) {
         char* newData = (char*)malloc(newSize + 1);
 
         for (size_t i = 0; i < pos; i++) {
@@ -535,7 +546,7 @@ string& string::replace(size_t pos, size_t len, size_t n, char c) {
     return replace(pos, len, string(n, c));
 }
 
-void string::swap(string& str) {
+void string::swap(string& str) noexcept {
     char* tmpBuffer = data_;
     size_t tmpLength = length_;
     size_t tmpCapacity = capacity_;
@@ -548,12 +559,36 @@ void string::swap(string& str) {
     str.capacity_ = tmpCapacity;
 }
 
+void string::adopt(char* s, size_t len, size_t cap) {
+    assert(s != nullptr && cap > len);
+
+    if (s != data_) {
+        free(data_);
+    }
+
+    data_ = s;
+    length_ = len;
+    capacity_ = cap;
+    data_[length_] = '\0';
+}
+
+char* string::release() {
+    char* buffer = data_;
+
+    data_ = nullptr;
+    length_ = 0;
+    capacity_ = 0;
+
+    return buffer;
+}
+
 const char* string::c_str() const {
-    return data_;
+    // A string left without a buffer by a move or a release is empty
+    return data_ != nullptr ? data_ : "";
 }
 
 const char* string::data() const {
-    return data_;
+    return data_ != nullptr ? data_ : "";
 }
 
 size_t string::copy(char* s, size_t len, size_t pos) {
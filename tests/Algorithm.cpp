@@ -0,0 +1,566 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_algorithm.h"
+#include "sketch_string.h"
+#include "sketch_vector.h"
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+template <size_t Arity>
+void CheckHeap(size_t n, unsigned int seed) {
+    std::vector<int> expected;
+    SketchStl::vector<int> vec;
+
+    uint32_t state = seed;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1103515245 + 12345;
+        int value = (int)(state >> 16) % 1000;
+        expected.push_back(value);
+        vec.push_back(value);
+    }
+
+    SketchStl::make_heap<Arity>(vec.begin(), vec.end());
+    BOOST_REQUIRE(SketchStl::is_heap<Arity>(vec.begin(), vec.end()));
+
+    // Popping everything sorts the range, largest element last
+    for (size_t len = n; len > 1; len--) {
+        SketchStl::pop_heap<Arity>(vec.begin(), vec.begin() + len);
+        BOOST_REQUIRE(SketchStl::is_heap<Arity>(vec.begin(), vec.begin() + (len - 1)));
+    }
+
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < n; i++) {
+        BOOST_REQUIRE(vec[i] == expected[i]);
+    }
+
+    // Pushing back one element at a time builds the heap too, here a min-heap
+    for (size_t len = 1; len <= n; len++) {
+        SketchStl::push_heap<Arity>(vec.begin(), vec.begin() + len, std::greater<int>());
+        BOOST_REQUIRE(SketchStl::is_heap<Arity>(vec.begin(), vec.begin() + len, std::greater<int>()));
+    }
+    if (n > 0) {
+        BOOST_REQUIRE(vec[0] == expected[0]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(heap_arities)
+{
+    CheckHeap<2>(0, 1);
+    CheckHeap<2>(1, 2);
+    CheckHeap<2>(500, 3);
+    CheckHeap<3>(500, 4);
+    CheckHeap<4>(1000, 5);
+    CheckHeap<8>(1000, 6);
+}
+
+BOOST_AUTO_TEST_CASE(binary_search_against_std)
+{
+    // Every length up to a few hundred, with duplicates, and values around every element
+    for (size_t n = 0; n < 300; n += (n < 20 ? 1 : 17)) {
+        std::vector<uint64_t> expected;
+        SketchStl::vector<uint64_t> vec;
+        for (size_t i = 0; i < n; i++) {
+            expected.push_back(i / 3 * 4);
+            vec.push_back(i / 3 * 4);
+        }
+
+        for (uint64_t value = 0; value < n / 3 * 4 + 6; value++) {
+            size_t lower = std::lower_bound(expected.begin(), expected.end(), value) - expected.begin();
+            size_t upper = std::upper_bound(expected.begin(), expected.end(), value) - expected.begin();
+
+            BOOST_REQUIRE(SketchStl::lower_bound(vec.begin(), vec.end(), value) - vec.begin() == (ptrdiff_t)lower);
+            BOOST_REQUIRE(SketchStl::upper_bound(vec.begin(), vec.end(), value) - vec.begin() == (ptrdiff_t)upper);
+
+            std::pair<uint64_t*, uint64_t*> range = SketchStl::equal_range(vec.data(), vec.data() + n, value);
+            BOOST_REQUIRE(range.first - vec.data() == (ptrdiff_t)lower && range.second - vec.data() == (ptrdiff_t)upper);
+            BOOST_REQUIRE(SketchStl::binary_search(vec.begin(), vec.end(), value) == (lower != upper));
+        }
+    }
+
+    // A custom order
+    int descending[] = { 9, 7, 7, 4, 1 };
+    BOOST_REQUIRE(SketchStl::lower_bound(descending, descending + 5, 7, std::greater<int>()) == descending + 1);
+    BOOST_REQUIRE(SketchStl::upper_bound(descending, descending + 5, 7, std::greater<int>()) == descending + 3);
+}
+
+std::vector<int> RandomSortedInts(size_t n, int range, uint32_t seed) {
+    std::vector<int> values;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        values.push_back((int)(seed >> 16) % range);
+    }
+
+    std::sort(values.begin(), values.end());
+    return values;
+}
+
+BOOST_AUTO_TEST_CASE(set_operations_against_std)
+{
+    // Balanced sizes merge, skewed sizes gallop through the longer range. Both keep the duplicates like std
+    size_t sizes[][2] = { { 0, 0 }, { 0, 50 }, { 50, 0 }, { 100, 120 }, { 5, 1000 }, { 1000, 5 }, { 40, 2000 } };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        std::vector<int> a = RandomSortedInts(sizes[s][0], 300, 1 + (uint32_t)s);
+        std::vector<int> b = RandomSortedInts(sizes[s][1], 300, 100 + (uint32_t)s);
+
+        std::vector<int> expected;
+        std::vector<int> result;
+
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        SketchStl::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        BOOST_REQUIRE(result == expected);
+        BOOST_REQUIRE(SketchStl::set_intersection_size(a.begin(), a.end(), b.begin(), b.end()) == expected.size());
+
+        expected.clear();
+        result.clear();
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        SketchStl::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        BOOST_REQUIRE(result == expected);
+
+        expected.clear();
+        result.clear();
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+        SketchStl::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+        BOOST_REQUIRE(result == expected);
+    }
+}
+
+SketchStl::vector<uint32_t> RandomIds(size_t n, uint32_t maxGap, uint32_t seed) {
+    SketchStl::vector<uint32_t> ids;
+    uint32_t id = 0;
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        id += 1 + (seed >> 16) % maxGap;
+        ids.push_back(id);
+    }
+
+    return ids;
+}
+
+void CheckIdSets(const SketchStl::vector<uint32_t>& a, const SketchStl::vector<uint32_t>& b) {
+    std::vector<uint32_t> expected;
+    SketchStl::vector<uint32_t> result;
+    result.reserve(a.size() + b.size());
+    const uint32_t* buffer = result.data();
+
+    std::set_intersection(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), std::back_inserter(expected));
+    SketchStl::set_intersection(a, b, result);
+    BOOST_REQUIRE(result.size() == expected.size() && std::equal(expected.begin(), expected.end(), result.data()));
+    BOOST_REQUIRE(SketchStl::set_intersection_size(a, b) == expected.size());
+
+    expected.clear();
+    std::set_union(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), std::back_inserter(expected));
+    SketchStl::set_union(a, b, result);
+    BOOST_REQUIRE(result.size() == expected.size() && std::equal(expected.begin(), expected.end(), result.data()));
+
+    expected.clear();
+    std::set_difference(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), std::back_inserter(expected));
+    SketchStl::set_difference(a, b, result);
+    BOOST_REQUIRE(result.size() == expected.size() && std::equal(expected.begin(), expected.end(), result.data()));
+
+    // The reserved output was reused by every operation
+    BOOST_REQUIRE(result.data() == buffer);
+}
+
+BOOST_AUTO_TEST_CASE(set_operations_on_ids)
+{
+    // Dense and sparse overlaps, lengths that are not multiples of the blocks, and skewed lengths
+    CheckIdSets(RandomIds(1000, 3, 1), RandomIds(1000, 3, 2));
+    CheckIdSets(RandomIds(997, 2, 3), RandomIds(1203, 4, 4));
+    CheckIdSets(RandomIds(500, 50, 5), RandomIds(700, 1, 6));
+    CheckIdSets(RandomIds(13, 3, 7), RandomIds(5000, 1, 8));
+    CheckIdSets(RandomIds(5000, 1, 9), RandomIds(13, 400, 10));
+    CheckIdSets(RandomIds(7, 3, 11), RandomIds(0, 3, 12));
+    CheckIdSets(RandomIds(0, 3, 13), RandomIds(0, 3, 14));
+
+    // Identical and disjoint lists
+    SketchStl::vector<uint32_t> ids = RandomIds(333, 5, 15);
+    CheckIdSets(ids, ids);
+
+    SketchStl::vector<uint32_t> evens;
+    SketchStl::vector<uint32_t> odds;
+    for (uint32_t i = 0; i < 400; i++) {
+        evens.push_back(2 * i);
+        odds.push_back(2 * i + 1);
+    }
+    CheckIdSets(evens, odds);
+    BOOST_REQUIRE(SketchStl::set_intersection_size(evens, odds) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(k_way_merge_runs)
+{
+    // Any number of runs, including empty ones and counts that are not powers of two
+    size_t counts[] = { 0, 1, 2, 3, 7, 64 };
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        SketchStl::vector<SketchStl::vector<int> > runs;
+        std::vector<int> expected;
+        for (size_t r = 0; r < counts[c]; r++) {
+            std::vector<int> run = RandomSortedInts(r % 5 == 3 ? 0 : 10 + 7 * r, 500, 31 + (uint32_t)r);
+            runs.push_back(SketchStl::vector<int>(run.begin(), run.end()));
+            expected.insert(expected.end(), run.begin(), run.end());
+        }
+        std::sort(expected.begin(), expected.end());
+
+        SketchStl::vector<int> merged;
+        merged.push_back(-1);
+        SketchStl::k_way_merge(runs, merged);
+        BOOST_REQUIRE(merged.size() == expected.size() + 1 && merged[0] == -1);
+        BOOST_REQUIRE(std::equal(expected.begin(), expected.end(), merged.data() + 1));
+    }
+
+    // The output is reserved once for every element, so the merge never reallocates it
+    SketchStl::vector<SketchStl::vector<int> > runs(2, SketchStl::vector<int>());
+    for (int i = 0; i < 4; i++) {
+        runs[0].push_back(2 * i);
+        runs[1].push_back(2 * i + 1);
+    }
+
+    SketchStl::vector<int> merged;
+    SketchStl::k_way_merge(runs, merged);
+    SketchStl::vector<int> reserved;
+    reserved.reserve(8);
+    BOOST_REQUIRE(merged.size() == 8 && merged.capacity() == reserved.capacity());
+
+    SketchStl::vector<int> exact;
+    exact.reserve(8);
+    const int* data = exact.data();
+    size_t capacity = exact.capacity();
+    SketchStl::k_way_merge(runs, exact);
+    BOOST_REQUIRE(exact.data() == data && exact.capacity() == capacity);
+    for (int i = 0; i < 8; i++) {
+        BOOST_REQUIRE(exact[i] == i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(k_way_merge_is_stable)
+{
+    // Pairs compared on their key only: equal keys come out in the order of their runs
+    typedef std::pair<int, int> entry;
+    struct KeyLess {
+        bool operator()(const entry& a, const entry& b) const { return a.first < b.first; }
+    };
+
+    std::vector<std::vector<entry> > runs(5);
+    for (int r = 0; r < 5; r++) {
+        for (int key = 0; key < 20; key += 1 + r % 2) {
+            runs[r].push_back(entry(key, r));
+        }
+    }
+
+    std::vector<SketchStl::span<const entry> > spans;
+    for (size_t r = 0; r < runs.size(); r++) {
+        spans.push_back(SketchStl::span<const entry>(runs[r].data(), runs[r].size()));
+    }
+
+    std::vector<entry> merged;
+    SketchStl::k_way_merge(spans.data(), spans.size(), [&merged](const entry& e) { merged.push_back(e); }, KeyLess());
+
+    std::vector<entry> expected;
+    for (size_t r = 0; r < runs.size(); r++) {
+        expected.insert(expected.end(), runs[r].begin(), runs[r].end());
+    }
+    std::stable_sort(expected.begin(), expected.end(), KeyLess());
+    BOOST_REQUIRE(merged == expected);
+}
+
+BOOST_AUTO_TEST_CASE(k_way_merge_moves_elements)
+{
+    typedef SketchStl::vector<int> payload;
+    struct FrontLess {
+        bool operator()(const payload& a, const payload& b) const { return a.front() < b.front(); }
+    };
+
+    SketchStl::vector<SketchStl::vector<payload> > runs(3);
+    std::vector<const int*> buffers;
+    for (int i = 0; i < 30; i++) {
+        payload p(4, i);
+        buffers.push_back(p.data());
+        runs[i % 3].push_back(std::move(p));
+    }
+
+    SketchStl::vector<payload> merged;
+    SketchStl::k_way_merge(runs, merged, FrontLess());
+    BOOST_REQUIRE(merged.size() == 30);
+    for (int i = 0; i < 30; i++) {
+        BOOST_REQUIRE(merged[i].front() == i && merged[i].data() == buffers[i]);
+    }
+    BOOST_REQUIRE(runs[0][0].empty());
+
+    // The tree can also be pulled from one element at a time
+    int a[] = { 1, 4, 9 };
+    int b[] = { 2, 3, 10 };
+    SketchStl::span<int> spans[] = { SketchStl::span<int>(a, 3), SketchStl::span<int>(b, 3) };
+    SketchStl::loser_tree<int> tree(spans, 2);
+    BOOST_REQUIRE(tree.top() == 1 && tree.top_run() == 0);
+    tree.pop();
+    BOOST_REQUIRE(tree.top() == 2 && tree.top_run() == 1);
+}
+
+void CheckSelection(std::vector<int> values) {
+    size_t n = values.size();
+    if (n == 0) {
+        return;
+    }
+
+    std::vector<int> sorted(values);
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t positions[] = { 0, n / 3, n / 2, n - 1 };
+    for (size_t p = 0; p < 4; p++) {
+        SketchStl::vector<int> vec(values.begin(), values.end());
+        size_t nth = positions[p];
+        SketchStl::nth_element(vec.begin(), vec.begin() + nth, vec.end());
+
+        BOOST_REQUIRE(vec[nth] == sorted[nth]);
+        for (size_t i = 0; i < n; i++) {
+            BOOST_REQUIRE(i < nth ? vec[i] <= vec[nth] : vec[i] >= vec[nth]);
+        }
+    }
+
+    // Small k goes through the heap, large k through the selection
+    size_t ks[] = { 0, 1, 10, n / 4, n };
+    for (size_t k = 0; k < 5 && ks[k] <= n; k++) {
+        SketchStl::vector<int> vec(values.begin(), values.end());
+        SketchStl::partial_sort(vec.data(), vec.data() + ks[k], vec.data() + n);
+        BOOST_REQUIRE(std::equal(sorted.begin(), sorted.begin() + ks[k], vec.data()));
+
+        std::sort(vec.data(), vec.data() + n);
+        BOOST_REQUIRE(std::equal(sorted.begin(), sorted.end(), vec.data()));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(selection_against_std)
+{
+    CheckSelection(RandomSortedInts(5, 10, 1));
+    CheckSelection(RandomSortedInts(1000, 1000000, 2));
+
+    std::vector<int> shuffled = RandomSortedInts(5000, 1000000, 3);
+    uint32_t state = 4;
+    for (size_t i = shuffled.size() - 1; i > 0; i--) {
+        state = state * 1103515245 + 12345;
+        std::swap(shuffled[i], shuffled[(state >> 8) % (i + 1)]);
+    }
+    CheckSelection(shuffled);
+
+    // Reversed input, few distinct values, and a single value
+    std::vector<int> reversed(shuffled);
+    std::sort(reversed.begin(), reversed.end(), std::greater<int>());
+    CheckSelection(reversed);
+    CheckSelection(RandomSortedInts(3000, 3, 5));
+    CheckSelection(std::vector<int>(777, 42));
+
+    // An organ pipe, a classic bad case for a median of three
+    std::vector<int> pipe;
+    for (int i = 0; i < 2000; i++) {
+        pipe.push_back(i < 1000 ? i : 2000 - i);
+    }
+    CheckSelection(pipe);
+}
+
+BOOST_AUTO_TEST_CASE(sort_heap_and_custom_order)
+{
+    std::vector<int> values = RandomSortedInts(300, 1000, 6);
+    std::vector<int> expected(values);
+    std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+    SketchStl::make_heap<4>(values.begin(), values.end(), std::greater<int>());
+    SketchStl::sort_heap<4>(values.begin(), values.end(), std::greater<int>());
+    BOOST_REQUIRE(values == expected);
+
+    std::vector<int> largest = RandomSortedInts(300, 1000, 7);
+    SketchStl::nth_element(largest.begin(), largest.begin() + 10, largest.end(), std::greater<int>());
+    SketchStl::partial_sort(largest.begin(), largest.begin() + 10, largest.end(), std::greater<int>());
+    std::vector<int> top(largest.begin(), largest.begin() + 10);
+    std::vector<int> allSorted = RandomSortedInts(300, 1000, 7);
+    BOOST_REQUIRE(std::equal(top.begin(), top.end(), allSorted.rbegin()));
+}
+
+BOOST_AUTO_TEST_CASE(gather_scatter_permutation)
+{
+    for (size_t n = 0; n < 300; n += (n < 20 ? 1 : 41)) {
+        // A shuffled permutation, and its inverse
+        std::vector<uint32_t> perm(n);
+        for (size_t i = 0; i < n; i++) {
+            perm[i] = (uint32_t)i;
+        }
+        uint32_t state = (uint32_t)n + 1;
+        for (size_t i = n; i > 1; i--) {
+            state = state * 1103515245 + 12345;
+            std::swap(perm[i - 1], perm[(state >> 8) % i]);
+        }
+
+        SketchStl::vector<uint32_t> indices;
+        SketchStl::vector<int> values;
+        for (size_t i = 0; i < n; i++) {
+            indices.push_back(perm[i]);
+            values.push_back((int)(i * 7));
+        }
+
+        SketchStl::vector<int> gathered;
+        SketchStl::gather(values, indices, gathered);
+        BOOST_REQUIRE(gathered.size() == n);
+        for (size_t i = 0; i < n; i++) {
+            BOOST_REQUIRE(gathered[i] == values[perm[i]]);
+        }
+
+        // Scattering through the same positions undoes the gather
+        SketchStl::vector<int> scattered(n);
+        SketchStl::scatter(gathered, indices, scattered);
+        BOOST_REQUIRE(std::equal(values.data(), values.data() + n, scattered.data()));
+
+        SketchStl::apply_permutation(values, indices);
+        BOOST_REQUIRE(std::equal(gathered.data(), gathered.data() + n, values.data()));
+    }
+
+    // Gathering more positions than there are elements, some of them repeated
+    int table[] = { 10, 20, 30 };
+    uint32_t positions[] = { 2, 2, 0, 1, 2 };
+    int out[5];
+    SketchStl::gather(table, positions, 5, out);
+    int expected[] = { 30, 30, 10, 20, 30 };
+    BOOST_REQUIRE(std::equal(expected, expected + 5, out));
+}
+
+BOOST_AUTO_TEST_CASE(gather_parallel_and_moves)
+{
+    // Enough positions for four blocks, reversed
+    const size_t n = 4 * SketchStl::parallel_gather_min_block + 5;
+    std::vector<uint32_t> indices(n);
+    std::vector<uint64_t> values(n);
+    for (size_t i = 0; i < n; i++) {
+        indices[i] = (uint32_t)(n - 1 - i);
+        values[i] = i * 3;
+    }
+
+    std::vector<uint64_t> gathered(n);
+    SketchStl::parallel_gather(values.data(), indices.data(), n, gathered.data(), 4);
+    for (size_t i = 0; i < n; i++) {
+        BOOST_REQUIRE(gathered[i] == (n - 1 - i) * 3);
+    }
+
+    std::vector<uint64_t> scattered(n);
+    SketchStl::parallel_scatter(gathered.data(), indices.data(), n, scattered.data(), 3);
+    BOOST_REQUIRE(scattered == values);
+
+    // The permutation moves the elements along its cycles, so the buffers of strings change hands
+    SketchStl::vector<SketchStl::string> strings;
+    SketchStl::vector<const char*> buffers;
+    const char* words[] = { "zero", "one", "two", "three", "four", "five" };
+    for (size_t i = 0; i < 6; i++) {
+        strings.push_back(SketchStl::string(words[i]));
+        buffers.push_back(strings[i].c_str());
+    }
+
+    // Two cycles: 0 -> 2 -> 4 -> 0 and 1 -> 5 -> 1, plus a fixed point at 3
+    SketchStl::vector<uint32_t> perm;
+    uint32_t cycles[] = { 2, 5, 4, 3, 0, 1 };
+    for (size_t i = 0; i < 6; i++) {
+        perm.push_back(cycles[i]);
+    }
+
+    SketchStl::apply_permutation(strings, perm);
+    for (size_t i = 0; i < 6; i++) {
+        BOOST_REQUIRE(strcmp(strings[i].c_str(), words[cycles[i]]) == 0);
+        BOOST_REQUIRE(strings[i].c_str() == buffers[cycles[i]]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(string_sort_against_std)
+{
+    // URL-like keys sharing long prefixes, with duplicates, keys that are prefixes of others, empty keys, zeros and
+    // bytes above 0x7F, which must sort after the others
+    const char* hosts[] = { "https://www.example.com/", "https://www.example.com/static/", "https://www.example.org/", "http://" };
+    std::vector<std::string> keys;
+    unsigned int seed = 17;
+    for (size_t i = 0; i < 20000; i++) {
+        seed = seed * 1103515245 + 12345;
+        std::string key = hosts[(seed >> 16) % 4];
+
+        seed = seed * 1103515245 + 12345;
+        size_t extra = (seed >> 16) % 24;
+        for (size_t j = 0; j < extra; j++) {
+            seed = seed * 1103515245 + 12345;
+            unsigned int r = (seed >> 16) % 64;
+            key.push_back(r == 0 ? '\0' : (r == 1 ? (char)0xE9 : (char)('a' + r % 4)));
+        }
+        keys.push_back(key);
+    }
+    keys.push_back("");
+    keys.push_back("");
+    keys.push_back(std::string(hosts[0]).substr(0, 5));
+
+    SketchStl::vector<SketchStl::string> strings;
+    for (size_t i = 0; i < keys.size(); i++) {
+        strings.push_back(SketchStl::string(keys[i].data(), keys[i].size()));
+    }
+
+    SketchStl::vector<uint32_t> order;
+    SketchStl::string_sort_indices(strings, order);
+    BOOST_REQUIRE(order.size() == keys.size());
+
+    // Every position comes out once
+    std::vector<uint32_t> positions(order.begin(), order.end());
+    std::sort(positions.begin(), positions.end());
+    for (size_t i = 0; i < positions.size(); i++) {
+        BOOST_REQUIRE(positions[i] == i);
+    }
+
+    std::vector<std::string> expected = keys;
+    std::sort(expected.begin(), expected.end());
+    for (size_t i = 0; i < order.size(); i++) {
+        BOOST_REQUIRE(keys[order[i]] == expected[i]);
+    }
+
+    SketchStl::string_sort(strings);
+    for (size_t i = 0; i < strings.size(); i++) {
+        BOOST_REQUIRE(std::string(strings[i].data(), strings[i].size()) == expected[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(string_sort_moves_and_equal_keys)
+{
+    // The strings are moved, so their buffers change hands instead of being copied
+    const char* words[] = { "pear", "apple", "fig", "apples", "", "banana", "apple" };
+    SketchStl::vector<SketchStl::string> strings;
+    SketchStl::vector<const char*> buffers;
+    for (size_t i = 0; i < 7; i++) {
+        strings.push_back(SketchStl::string(words[i]));
+        buffers.push_back(strings[i].c_str());
+    }
+
+    SketchStl::string_sort(strings);
+    const char* sorted[] = { "", "apple", "apple", "apples", "banana", "fig", "pear" };
+    uint32_t from[] = { 4, 1, 6, 3, 5, 2, 0 };
+    for (size_t i = 0; i < 7; i++) {
+        BOOST_REQUIRE(strcmp(strings[i].c_str(), sorted[i]) == 0);
+        if (i != 1 && i != 2) {
+            BOOST_REQUIRE(strings[i].c_str() == buffers[from[i]]);
+        }
+    }
+
+    // Long runs of equal keys and many copies of a few strings, which would degrade a two-way quicksort
+    std::vector<std::string> keys;
+    std::string prefix(300, 'x');
+    for (size_t i = 0; i < 5000; i++) {
+        keys.push_back(prefix + (char)('a' + (i * 7) % 3) + std::string(i % 5, 'y'));
+    }
+
+    SketchStl::vector<SketchStl::string> many;
+    for (size_t i = 0; i < keys.size(); i++) {
+        many.push_back(SketchStl::string(keys[i].data(), keys[i].size()));
+    }
+
+    SketchStl::string_sort(many);
+    std::sort(keys.begin(), keys.end());
+    for (size_t i = 0; i < keys.size(); i++) {
+        BOOST_REQUIRE(std::string(many[i].data(), many[i].size()) == keys[i]);
+    }
+
+    SketchStl::vector<SketchStl::string> empty;
+    SketchStl::string_sort(empty);
+    BOOST_REQUIRE(empty.empty());
+}
@@ -0,0 +1,130 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_channel.h"
+#include "sketch_ranges.h"
+#include "sketch_string.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(channel_streams_between_stages)
+{
+    const int numRecords = 2000;
+    SketchStl::channel<SketchStl::string> records(4);
+    BOOST_REQUIRE(records.capacity() == 4);
+
+    // The producer formats records while the consumer parses them, never more than the capacity ahead
+    std::atomic<int> refused(0);
+    std::thread producer([&records, &refused]() {
+        char buffer[32];
+        for (int i = 0; i < numRecords; i++) {
+            snprintf(buffer, sizeof(buffer), "record %d", i);
+            refused += records.push(SketchStl::string(buffer)) ? 0 : 1;
+        }
+        records.close();
+    });
+
+    SketchStl::vector<int> ids = records
+        | SketchStl::views::transform([](const SketchStl::string& s) { return atoi(s.c_str() + 7); })
+        | SketchStl::views::filter([](int id) { return id % 2 == 0; })
+        | SketchStl::views::to_vector();
+    producer.join();
+
+    BOOST_REQUIRE(refused == 0);
+    BOOST_REQUIRE(ids.size() == numRecords / 2);
+    for (size_t i = 0; i < ids.size(); i++) {
+        BOOST_REQUIRE(ids[i] == (int)(i * 2));
+    }
+
+    // A closed channel refuses elements and does not wait
+    BOOST_REQUIRE(!records.push(SketchStl::string("late")));
+    SketchStl::string val;
+    BOOST_REQUIRE(!records.pop(val));
+}
+
+static void stream_through_channel(size_t capacity, int numProducers, int numConsumers)
+{
+    const int numValues = 20000;
+    SketchStl::channel<int> values(capacity);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numProducers; t++) {
+        producers.push_back(std::thread([&values, t]() {
+            for (int i = 0; i < numValues; i++) {
+                values.push(t * numValues + i);
+            }
+        }));
+    }
+
+    std::atomic<long long> total(0);
+    std::atomic<int> received(0);
+    std::vector<std::thread> consumers;
+    for (int t = 0; t < numConsumers; t++) {
+        consumers.push_back(std::thread([&values, &total, &received]() {
+            int v;
+            while (values.pop(v)) {
+                total += v;
+                received++;
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < producers.size(); t++) {
+        producers[t].join();
+    }
+    values.close();
+    for (size_t t = 0; t < consumers.size(); t++) {
+        consumers[t].join();
+    }
+
+    long long n = (long long)numProducers * numValues;
+    BOOST_REQUIRE(received == n);
+    BOOST_REQUIRE(total == n * (n - 1) / 2);
+}
+
+BOOST_AUTO_TEST_CASE(channel_many_producers_and_consumers)
+{
+    stream_through_channel(16, 4, 3);
+}
+
+BOOST_AUTO_TEST_CASE(channel_capacity_one)
+{
+    stream_through_channel(1, 4, 4);
+}
+
+BOOST_AUTO_TEST_CASE(channel_close_wakes_waiters)
+{
+    SketchStl::channel<int> values(2);
+    BOOST_REQUIRE(values.try_push(1) && values.try_push(2));
+    BOOST_REQUIRE(!values.try_push(3));
+
+    // A producer blocked on a full channel gives up when it is closed
+    std::atomic<bool> pushed(true);
+    std::thread producer([&values, &pushed]() {
+        pushed = values.push(3);
+    });
+    values.close();
+    producer.join();
+    BOOST_REQUIRE(!pushed);
+
+    // The elements in the channel are still delivered
+    int v = 0;
+    BOOST_REQUIRE(values.pop(v) && v == 1);
+    BOOST_REQUIRE(values.try_pop(v) && v == 2);
+    BOOST_REQUIRE(!values.pop(v));
+
+    // A consumer blocked on an empty channel too
+    SketchStl::channel<int> empty(2);
+    std::atomic<bool> popped(true);
+    std::thread consumer([&empty, &popped]() {
+        int x;
+        popped = empty.pop(x);
+    });
+    empty.close();
+    consumer.join();
+    BOOST_REQUIRE(!popped);
+}
@@ -0,0 +1,101 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_concurrent_vector.h"
+#include "sketch_string.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(concurrent_vector_push_back)
+{
+    SketchStl::concurrent_vector<int, 4> vec;
+    for (int i = 0; i < 100; i++) {
+        BOOST_REQUIRE(vec.push_back(i) == (size_t)i);
+    }
+
+    BOOST_REQUIRE(vec.size() == 100);
+    for (int i = 0; i < 100; i++) {
+        BOOST_REQUIRE(vec[i] == i);
+    }
+
+    size_t first = vec.grow_by(10, -1);
+    BOOST_REQUIRE(first == 100 && vec.size() == 110);
+    BOOST_REQUIRE(vec[100] == -1 && vec[109] == -1);
+
+    vec.clear();
+    BOOST_REQUIRE(vec.empty());
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_vector_stable_addresses)
+{
+    SketchStl::concurrent_vector<SketchStl::string, 2> vec;
+    vec.push_back("first");
+    SketchStl::string* address = &vec[0];
+
+    for (int i = 0; i < 1000; i++) {
+        vec.push_back("other");
+    }
+
+    BOOST_REQUIRE(address == &vec[0]);
+    BOOST_REQUIRE(vec[0] == "first" && vec[1000] == "other");
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_vector_multiple_producers)
+{
+    const int numThreads = 8;
+    const int numValues = 20000;
+
+    SketchStl::concurrent_vector<int, 16> vec;
+    std::atomic<bool> done(false);
+    std::atomic<bool> readerOk(true);
+
+    // The reader only looks at published elements, which must always be fully constructed
+    std::thread reader([&]() {
+        while (!done.load()) {
+            size_t size = vec.size();
+            for (size_t i = 0; i < size; i += 97) {
+                if (vec[i] < 0 || vec[i] >= numThreads * numValues) {
+                    readerOk.store(false);
+                }
+            }
+        }
+    });
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numThreads; t++) {
+        producers.push_back(std::thread([&vec, t]() {
+            for (int i = 0; i < numValues; i++) {
+                if ((i % 100) == 0) {
+                    size_t first = vec.grow_by(3, t * numValues + i);
+                    (void)first;
+                    i += 2;
+                } else {
+                    vec.push_back(t * numValues + i);
+                }
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < producers.size(); t++) {
+        producers[t].join();
+    }
+    done.store(true);
+    reader.join();
+
+    BOOST_REQUIRE(readerOk.load());
+    BOOST_REQUIRE(vec.size() == (size_t)(numThreads * numValues));
+
+    std::vector<int> seen(numThreads * numValues, 0);
+    for (size_t i = 0; i < vec.size(); i++) {
+        seen[vec[i]] += 1;
+    }
+
+    // Every block written by grow_by stores its first value three times
+    for (int t = 0; t < numThreads; t++) {
+        for (int i = 0; i < numValues; i++) {
+            int expected = ((i % 100) == 0) ? 3 : (((i % 100) == 1 || (i % 100) == 2) ? 0 : 1);
+            BOOST_REQUIRE(seen[t * numValues + i] == expected);
+        }
+    }
+}
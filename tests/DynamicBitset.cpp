@@ -0,0 +1,185 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_bit.h"
+#include "sketch_dynamic_bitset.h"
+#include <vector>
+
+bool CompareBitsets(const std::vector<bool>& stdBits, const SketchStl::dynamic_bitset& bits) {
+    if (stdBits.size() != bits.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < stdBits.size(); i++) {
+        if (stdBits[i] != bits[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FillRandom(std::vector<bool>& stdBits, SketchStl::dynamic_bitset& bits, size_t n, unsigned int seed, unsigned int density) {
+    stdBits.assign(n, false);
+    bits.resize(n);
+    bits.reset();
+
+    for (size_t i = 0; i < n; i++) {
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 100 < density) {
+            stdBits[i] = true;
+            bits.set(i);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(bit_word_helpers)
+{
+    BOOST_REQUIRE(SketchStl::popcount(0) == 0);
+    BOOST_REQUIRE(SketchStl::popcount(0xFFFFFFFFFFFFFFFFULL) == 64);
+    BOOST_REQUIRE(SketchStl::popcount(0x8000000000000101ULL) == 3);
+    BOOST_REQUIRE(SketchStl::count_trailing_zeros(1) == 0);
+    BOOST_REQUIRE(SketchStl::count_trailing_zeros(0x8000000000000000ULL) == 63);
+    BOOST_REQUIRE(SketchStl::select_in_word(0x8000000000000101ULL, 0) == 0);
+    BOOST_REQUIRE(SketchStl::select_in_word(0x8000000000000101ULL, 1) == 8);
+    BOOST_REQUIRE(SketchStl::select_in_word(0x8000000000000101ULL, 2) == 63);
+}
+
+BOOST_AUTO_TEST_CASE(dynamic_bitset_set_and_resize)
+{
+    std::vector<bool> stdBits(70, false);
+    SketchStl::dynamic_bitset bits(70);
+    BOOST_REQUIRE(bits.num_words() == 2);
+    BOOST_REQUIRE(bits.none() && bits.count() == 0);
+
+    bits.set(0);
+    bits.set(65, true);
+    bits.flip(3);
+    bits.flip(0);
+    stdBits[65] = stdBits[3] = true;
+    BOOST_REQUIRE(CompareBitsets(stdBits, bits));
+    BOOST_REQUIRE(bits.count() == 2 && bits.any());
+
+    // Growing with ones fills the rest of the last word too
+    bits.resize(200, true);
+    stdBits.resize(200, true);
+    BOOST_REQUIRE(CompareBitsets(stdBits, bits));
+    BOOST_REQUIRE(bits.count() == 132);
+
+    // Shrinking clears the bits past the new size, so they do not come back when growing again
+    bits.resize(66);
+    bits.resize(128);
+    stdBits.resize(66);
+    stdBits.resize(128, false);
+    BOOST_REQUIRE(CompareBitsets(stdBits, bits));
+    BOOST_REQUIRE(bits.count() == 2);
+
+    bits.set();
+    BOOST_REQUIRE(bits.all() && bits.count() == 128);
+    bits.reset();
+    BOOST_REQUIRE(bits.none());
+
+    SketchStl::dynamic_bitset pushed;
+    for (int i = 0; i < 130; i++) {
+        pushed.push_back((i % 3) == 0);
+    }
+    BOOST_REQUIRE(pushed.size() == 130 && pushed.count() == 44);
+    BOOST_REQUIRE(pushed[129] && !pushed[128]);
+
+    pushed.clear();
+    BOOST_REQUIRE(pushed.empty() && pushed.num_words() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(dynamic_bitset_bitwise_operations)
+{
+    // Sizes around the width of the vector loops check that the tail is handled
+    const size_t sizes[] = { 1, 63, 64, 255, 256, 257, 1000, 4099 };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        size_t n = sizes[s];
+
+        std::vector<bool> stdA, stdB;
+        SketchStl::dynamic_bitset a, b;
+        FillRandom(stdA, a, n, 1, 50);
+        FillRandom(stdB, b, n, 2, 30);
+
+        std::vector<bool> expected(n);
+        for (size_t i = 0; i < n; i++) {
+            expected[i] = stdA[i] && stdB[i];
+        }
+        BOOST_REQUIRE(CompareBitsets(expected, a & b));
+
+        for (size_t i = 0; i < n; i++) {
+            expected[i] = stdA[i] || stdB[i];
+        }
+        BOOST_REQUIRE(CompareBitsets(expected, a | b));
+
+        for (size_t i = 0; i < n; i++) {
+            expected[i] = stdA[i] != stdB[i];
+        }
+        BOOST_REQUIRE(CompareBitsets(expected, a ^ b));
+
+        for (size_t i = 0; i < n; i++) {
+            expected[i] = stdA[i] && !stdB[i];
+        }
+        SketchStl::dynamic_bitset c(a);
+        c.and_not(b);
+        BOOST_REQUIRE(CompareBitsets(expected, c));
+
+        BOOST_REQUIRE(c != a || b.none());
+        c = a;
+        BOOST_REQUIRE(c == a);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(dynamic_bitset_search_rank_select)
+{
+    std::vector<bool> stdBits;
+    SketchStl::dynamic_bitset bits;
+    FillRandom(stdBits, bits, 5000, 7, 5);
+
+    std::vector<size_t> positions;
+    for (size_t i = 0; i < stdBits.size(); i++) {
+        if (stdBits[i]) {
+            positions.push_back(i);
+        }
+    }
+    BOOST_REQUIRE(bits.count() == positions.size());
+
+    // Iterate over the set bits
+    size_t k = 0;
+    for (size_t pos = bits.find_first(); pos != SketchStl::dynamic_bitset::npos; pos = bits.find_next(pos)) {
+        BOOST_REQUIRE(k < positions.size() && positions[k] == pos);
+        k += 1;
+    }
+    BOOST_REQUIRE(k == positions.size());
+
+    SketchStl::bitset_rank_index index(bits);
+    size_t rank = 0;
+    for (size_t i = 0; i <= stdBits.size(); i++) {
+        BOOST_REQUIRE(bits.rank(i) == rank);
+        BOOST_REQUIRE(index.rank(i) == rank);
+        if (i < stdBits.size() && stdBits[i]) {
+            rank += 1;
+        }
+    }
+
+    for (size_t i = 0; i < positions.size(); i++) {
+        BOOST_REQUIRE(bits.select(i) == positions[i]);
+        BOOST_REQUIRE(index.select(i) == positions[i]);
+    }
+    BOOST_REQUIRE(bits.select(positions.size()) == SketchStl::dynamic_bitset::npos);
+    BOOST_REQUIRE(index.select(positions.size()) == SketchStl::dynamic_bitset::npos);
+
+    SketchStl::dynamic_bitset empty(100);
+    BOOST_REQUIRE(empty.find_first() == SketchStl::dynamic_bitset::npos);
+    BOOST_REQUIRE(empty.find_next(50) == SketchStl::dynamic_bitset::npos);
+
+    // npos, as returned by a search that found nothing, ends the walk instead of starting it over
+    SketchStl::dynamic_bitset ends(70);
+    ends.set(0);
+    ends.set(69);
+    BOOST_REQUIRE(ends.find_next(SketchStl::dynamic_bitset::npos) == SketchStl::dynamic_bitset::npos);
+    BOOST_REQUIRE(ends.find_next(68) == 69 && ends.find_next(69) == SketchStl::dynamic_bitset::npos);
+    BOOST_REQUIRE(SketchStl::dynamic_bitset().find_next(0) == SketchStl::dynamic_bitset::npos);
+    BOOST_REQUIRE(SketchStl::bitset_rank_index(empty).select(0) == SketchStl::dynamic_bitset::npos);
+}
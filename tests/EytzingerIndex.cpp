@@ -0,0 +1,65 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_eytzinger_index.h"
+#include <stdint.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(eytzinger_index_against_std)
+{
+    for (size_t n = 0; n < 200; n += (n < 40 ? 1 : 23)) {
+        SketchStl::vector<uint64_t> sorted;
+        for (size_t i = 0; i < n; i++) {
+            sorted.push_back(i / 2 * 10);
+        }
+
+        SketchStl::eytzinger_index<uint64_t> index(sorted);
+        BOOST_REQUIRE(index.size() == n);
+
+        // The payloads follow the keys, so a slot gives back the position in the sorted array
+        std::vector<size_t> positions(n);
+        for (size_t i = 0; i < n; i++) {
+            positions[i] = i;
+        }
+        std::vector<size_t> payloads(n);
+        index.permute(positions.data(), payloads.data());
+
+        const uint64_t* first = sorted.data();
+        const uint64_t* last = sorted.data() + n;
+        for (uint64_t value = 0; value < n / 2 * 10 + 15; value++) {
+            size_t lower = std::lower_bound(first, last, value) - first;
+            size_t upper = std::upper_bound(first, last, value) - first;
+
+            size_t slot = index.lower_bound(value);
+            BOOST_REQUIRE(slot == SketchStl::eytzinger_index<uint64_t>::npos ? lower == n : payloads[slot] == lower);
+            BOOST_REQUIRE(slot == SketchStl::eytzinger_index<uint64_t>::npos || index[slot] == sorted[lower]);
+
+            slot = index.upper_bound(value);
+            BOOST_REQUIRE(slot == SketchStl::eytzinger_index<uint64_t>::npos ? upper == n : payloads[slot] == upper);
+
+            slot = index.find(value);
+            BOOST_REQUIRE((slot != SketchStl::eytzinger_index<uint64_t>::npos) == (lower != upper));
+            BOOST_REQUIRE(slot == SketchStl::eytzinger_index<uint64_t>::npos || index.data()[slot] == value);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(eytzinger_index_layout)
+{
+    // Seven elements make a full tree: the root is the median, then the quartiles
+    int sorted[] = { 1, 2, 3, 4, 5, 6, 7 };
+    SketchStl::eytzinger_index<int> index(sorted, 7);
+    int expected[] = { 4, 2, 6, 1, 3, 5, 7 };
+    BOOST_REQUIRE(std::equal(expected, expected + 7, index.data()));
+
+    int descending[] = { 7, 5, 3, 1 };
+    typedef SketchStl::eytzinger_index<int, std::greater<int> > descending_index;
+    descending_index reversed(descending, 4);
+    BOOST_REQUIRE(reversed[reversed.lower_bound(4)] == 3);
+    BOOST_REQUIRE(reversed.find(4) == descending_index::npos);
+
+    SketchStl::eytzinger_index<int> empty;
+    BOOST_REQUIRE(empty.empty() && empty.lower_bound(3) == SketchStl::eytzinger_index<int>::npos);
+}
@@ -0,0 +1,137 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_generator.h"
+#include "sketch_ranges.h"
+#include "sketch_string.h"
+#include <string.h>
+#include <vector>
+
+namespace {
+
+SketchStl::generator<int> iota(int first, int last) {
+    for (int i = first; i < last; i++) {
+        co_yield i;
+    }
+}
+
+/**
+ * Yield the lines of a buffer, counting how many were cut
+ */
+SketchStl::generator<SketchStl::string> lines(const char* buffer, int& parsed) {
+    const char* start = buffer;
+    for (const char* p = buffer; ; p++) {
+        if (*p == '\n' || *p == '\0') {
+            parsed++;
+            co_yield SketchStl::string(start, p - start);
+            if (*p == '\0') {
+                break;
+            }
+            start = p + 1;
+        }
+    }
+}
+
+SketchStl::generator<const SketchStl::string&> by_reference(const SketchStl::vector<SketchStl::string>& strings) {
+    for (size_t i = 0; i < strings.size(); i++) {
+        co_yield strings[i];
+    }
+}
+
+struct tracked {
+    explicit tracked(int& live) : live_(live) { live_++; }
+    ~tracked() { live_--; }
+
+    int& live_;
+};
+
+SketchStl::generator<int> holding(int& live) {
+    tracked guard(live);
+    for (int i = 0; ; i++) {
+        co_yield i;
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(generator_yields_lazily)
+{
+    std::vector<int> values;
+    for (int v : iota(3, 8)) {
+        values.push_back(v);
+    }
+    BOOST_REQUIRE(values == std::vector<int>({ 3, 4, 5, 6, 7 }));
+
+    SketchStl::generator<int> empty = iota(5, 5);
+    BOOST_REQUIRE(empty.begin() == empty.end());
+
+    // Only the lines the pipeline asks for are cut out of the buffer
+    int parsed = 0;
+    SketchStl::generator<SketchStl::string> records = lines("id=1\nskip\nid=2\nid=3\nid=4", parsed);
+    SketchStl::vector<SketchStl::string> ids = records
+        | SketchStl::views::filter([](const SketchStl::string& s) { return s[0] == 'i'; })
+        | SketchStl::views::take(2)
+        | SketchStl::views::to_vector();
+
+    BOOST_REQUIRE(ids.size() == 2);
+    BOOST_REQUIRE(strcmp(ids[0].c_str(), "id=1") == 0 && strcmp(ids[1].c_str(), "id=2") == 0);
+    BOOST_REQUIRE(parsed == 3);
+}
+
+BOOST_AUTO_TEST_CASE(generator_begin_twice)
+{
+    // Only the first begin() runs the coroutine, later ones pick up where the last walk stopped
+    SketchStl::generator<int> numbers = iota(0, 5);
+    BOOST_REQUIRE(*numbers.begin() == 0);
+    BOOST_REQUIRE(*numbers.begin() == 0);
+
+    SketchStl::generator<int>::iterator it = numbers.begin();
+    ++it;
+    BOOST_REQUIRE(*numbers.begin() == 1);
+
+    // Every walk of a view over the generator starts with begin()
+    std::vector<int> seen;
+    auto view = SketchStl::views::all(numbers);
+    view.for_each([&seen](int v) { seen.push_back(v); });
+    BOOST_REQUIRE(seen == std::vector<int>({ 1, 2, 3, 4 }));
+
+    // A finished coroutine is not resumed again
+    BOOST_REQUIRE(numbers.begin() == numbers.end());
+    BOOST_REQUIRE(SketchStl::views::to_vector(view).size() == 0);
+    for (int v : view) {
+        BOOST_FAIL("unexpected element " << v);
+    }
+
+    SketchStl::generator<int> moved(std::move(numbers));
+    BOOST_REQUIRE(moved.begin() == moved.end());
+}
+
+BOOST_AUTO_TEST_CASE(generator_references_and_lifetime)
+{
+    SketchStl::vector<SketchStl::string> strings;
+    strings.push_back(SketchStl::string("alpha"));
+    strings.push_back(SketchStl::string("beta"));
+
+    // The elements are the ones of the vector, not copies
+    size_t i = 0;
+    for (const SketchStl::string& s : by_reference(strings)) {
+        BOOST_REQUIRE(&s == &strings[i]);
+        i++;
+    }
+    BOOST_REQUIRE(i == 2);
+
+    // Destroying a suspended generator destroys the objects of its frame
+    int live = 0;
+    {
+        SketchStl::generator<int> numbers = holding(live);
+        BOOST_REQUIRE(live == 0);
+
+        SketchStl::generator<int>::iterator it = numbers.begin();
+        ++it;
+        BOOST_REQUIRE(*it == 1 && live == 1);
+
+        SketchStl::generator<int> moved(std::move(numbers));
+        BOOST_REQUIRE(live == 1);
+    }
+    BOOST_REQUIRE(live == 0);
+}
@@ -0,0 +1,176 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_numeric.h"
+#include <math.h>
+#include <stdint.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(numeric_int32_against_std)
+{
+    SketchStl::simd_level supported = SketchStl::simd_supported();
+    for (int level = SketchStl::simd_scalar; level <= supported; level++) {
+        SketchStl::set_simd_active((SketchStl::simd_level)level);
+        BOOST_REQUIRE(SketchStl::simd_active() == level);
+
+        for (size_t n = 1; n < 300; n += (n < 70 ? 1 : 37)) {
+            // One extra element, so that starting from the second one tests the unaligned loads
+            SketchStl::aligned_vector<int32_t, 64> a;
+            SketchStl::aligned_vector<int32_t, 64> b;
+            for (size_t i = 0; i < n + 1; i++) {
+                a.push_back((int32_t)((i * 2654435761u) & 0x3FFFFFFF) - (1 << 29));
+                b.push_back((int32_t)(i % 7) - 3);
+            }
+
+            for (size_t skew = 0; skew < 2; skew++) {
+                const int32_t* x = a.data() + skew;
+                const int32_t* y = b.data() + skew;
+
+                BOOST_REQUIRE(SketchStl::sum(x, n) == std::accumulate(x, x + n, (int64_t)0));
+                BOOST_REQUIRE(SketchStl::min(x, n) == *std::min_element(x, x + n));
+                BOOST_REQUIRE(SketchStl::max(x, n) == *std::max_element(x, x + n));
+
+                int64_t expected = 0;
+                for (size_t i = 0; i < n; i++) {
+                    expected += (int64_t)x[i] * y[i];
+                }
+                BOOST_REQUIRE(SketchStl::dot(x, y, n) == expected);
+                BOOST_REQUIRE(SketchStl::count(y, n, 2) == (size_t)std::count(y, y + n, 2));
+
+                std::vector<int32_t> scaled(n + 1);
+                SketchStl::transform(x, scaled.data() + skew, n, 3, -5);
+                for (size_t i = 0; i < n; i++) {
+                    BOOST_REQUIRE(scaled[i + skew] == (int32_t)((uint32_t)x[i] * 3u - 5u));
+                }
+            }
+
+            SketchStl::fill(a.data() + 1, n, 42);
+            BOOST_REQUIRE(a[0] != 42);
+            BOOST_REQUIRE(SketchStl::count(a, 42) == n);
+        }
+    }
+
+    SketchStl::set_simd_active(supported);
+}
+
+BOOST_AUTO_TEST_CASE(numeric_float_against_std)
+{
+    SketchStl::simd_level supported = SketchStl::simd_supported();
+    for (int level = SketchStl::simd_scalar; level <= supported; level++) {
+        SketchStl::set_simd_active((SketchStl::simd_level)level);
+
+        for (size_t n = 1; n < 300; n += (n < 70 ? 1 : 37)) {
+            SketchStl::aligned_vector<float, 64> a;
+            SketchStl::aligned_vector<float, 64> b;
+            for (size_t i = 0; i < n; i++) {
+                a.push_back((float)((i * 37) % 101) * 0.25f - 12.0f);
+                b.push_back((float)(i % 5) * 0.5f);
+            }
+
+            double sum = 0.0;
+            double dot = 0.0;
+            for (size_t i = 0; i < n; i++) {
+                sum += a[i];
+                dot += (double)a[i] * b[i];
+            }
+
+            // The elements are added in another order, which may round differently
+            BOOST_REQUIRE(fabs(SketchStl::sum(a) - sum) < 1e-3);
+            BOOST_REQUIRE(fabs(SketchStl::dot(a, b) - dot) < 1e-3);
+
+            std::pair<float, float> bounds = SketchStl::minmax(a);
+            BOOST_REQUIRE(bounds.first == *std::min_element(a.data(), a.data() + n));
+            BOOST_REQUIRE(bounds.second == *std::max_element(a.data(), a.data() + n));
+            BOOST_REQUIRE(SketchStl::count(b, 1.0f) == (size_t)std::count(b.data(), b.data() + n, 1.0f));
+
+            SketchStl::aligned_vector<float, 64> scaled;
+            SketchStl::transform(a, scaled, 0.5f, 1.0f);
+            BOOST_REQUIRE(scaled.size() == n);
+            for (size_t i = 0; i < n; i++) {
+                BOOST_REQUIRE(scaled[i] == a[i] * 0.5f + 1.0f);
+            }
+        }
+    }
+
+    SketchStl::set_simd_active(supported);
+}
+
+BOOST_AUTO_TEST_CASE(numeric_scans_against_std)
+{
+    SketchStl::simd_level supported = SketchStl::simd_supported();
+    for (int level = SketchStl::simd_scalar; level <= supported; level++) {
+        SketchStl::set_simd_active((SketchStl::simd_level)level);
+
+        for (size_t n = 0; n < 300; n += (n < 70 ? 1 : 37)) {
+            // Large values make the sums wrap around
+            std::vector<uint32_t> src(n);
+            for (size_t i = 0; i < n; i++) {
+                src[i] = (uint32_t)(i * 2654435761u);
+            }
+
+            std::vector<uint32_t> expected(n);
+            std::partial_sum(src.begin(), src.end(), expected.begin());
+            uint32_t total = n > 0 ? expected[n - 1] : 0;
+
+            std::vector<uint32_t> dst(n);
+            BOOST_REQUIRE(SketchStl::inclusive_scan(src.data(), dst.data(), n) == total);
+            BOOST_REQUIRE(dst == expected);
+
+            BOOST_REQUIRE(SketchStl::exclusive_scan(src.data(), dst.data(), n, 5u) == total + 5);
+            for (size_t i = 0; i < n; i++) {
+                BOOST_REQUIRE(dst[i] == (i > 0 ? expected[i - 1] : 0) + 5);
+            }
+
+            // In place
+            dst = src;
+            SketchStl::inclusive_scan(dst.data(), dst.data(), n);
+            BOOST_REQUIRE(dst == expected);
+        }
+    }
+
+    SketchStl::set_simd_active(supported);
+
+    // Enough elements for four blocks, and an odd number of them
+    const size_t n = 4 * SketchStl::parallel_scan_min_block + 13;
+    SketchStl::vector<uint32_t> src;
+    for (size_t i = 0; i < n; i++) {
+        src.push_back((uint32_t)(i % 1000));
+    }
+
+    SketchStl::vector<uint32_t> expected;
+    uint32_t total = SketchStl::exclusive_scan(src, expected, 7u);
+
+    SketchStl::vector<uint32_t> dst(src);
+    BOOST_REQUIRE(SketchStl::parallel_exclusive_scan(dst.data(), dst.data(), n, 7u, 4) == total);
+    BOOST_REQUIRE(std::equal(dst.data(), dst.data() + n, expected.data()));
+
+    BOOST_REQUIRE(SketchStl::parallel_inclusive_scan(src.data(), dst.data(), n, 3) == total - 7);
+    for (size_t i = 0; i < n; i++) {
+        BOOST_REQUIRE(dst[i] == expected[i] - 7 + src[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(numeric_histogram)
+{
+    // Few buckets go through the four tables, many through a single one
+    size_t bucketCounts[] = { 1, 16, 256, 1024, 1025, 5000 };
+    for (size_t b = 0; b < 6; b++) {
+        size_t buckets = bucketCounts[b];
+        for (size_t n = 0; n < 1000; n += 111) {
+            SketchStl::vector<uint32_t> values;
+            for (size_t i = 0; i < n; i++) {
+                // Runs of equal values, then scattered ones
+                values.push_back((uint32_t)((i < n / 2 ? i / 8 : i * 7919) % buckets));
+            }
+
+            SketchStl::vector<uint32_t> counts;
+            SketchStl::histogram(values, buckets, counts);
+            BOOST_REQUIRE(counts.size() == buckets);
+            for (size_t v = 0; v < buckets; v++) {
+                BOOST_REQUIRE(counts[v] == (uint32_t)std::count(values.data(), values.data() + n, (uint32_t)v));
+            }
+        }
+    }
+}
@@ -0,0 +1,293 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_object_pool.h"
+#include "sketch_string.h"
+#include "sketch_vector.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+struct Particle {
+    Particle(float x, float y) : x_(x), y_(y) {
+        numParticles += 1;
+    }
+
+    ~Particle() {
+        numParticles -= 1;
+    }
+
+    float x_, y_;
+    static int numParticles;
+};
+int Particle::numParticles = 0;
+
+BOOST_AUTO_TEST_CASE(object_pool_create_and_destroy)
+{
+    SketchStl::object_pool<Particle, 16> pool;
+    BOOST_REQUIRE(pool.block_count() == 0);
+
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 40; i++) {
+        particles.push_back(pool.create((float)i, -(float)i));
+        BOOST_REQUIRE(((uintptr_t)particles.back() % alignof(Particle)) == 0);
+    }
+
+    BOOST_REQUIRE(Particle::numParticles == 40);
+    BOOST_REQUIRE(pool.live_count() == 40 && pool.peak_count() == 40);
+    BOOST_REQUIRE(pool.block_count() >= 3);
+
+    std::set<Particle*> unique(particles.begin(), particles.end());
+    BOOST_REQUIRE(unique.size() == 40);
+    for (int i = 0; i < 40; i++) {
+        BOOST_REQUIRE(particles[i]->x_ == (float)i && particles[i]->y_ == -(float)i);
+    }
+
+    for (int i = 0; i < 40; i++) {
+        pool.destroy(particles[i]);
+    }
+    BOOST_REQUIRE(Particle::numParticles == 0);
+    BOOST_REQUIRE(pool.live_count() == 0 && pool.peak_count() == 40);
+
+    // Freed slots are reused before any new block is allocated
+    size_t blocks = pool.block_count();
+    for (int i = 0; i < 40; i++) {
+        particles[i] = pool.create(0.0f, 0.0f);
+        BOOST_REQUIRE(unique.count(particles[i]) == 1);
+    }
+    BOOST_REQUIRE(pool.block_count() == blocks);
+
+    for (int i = 0; i < 40; i++) {
+        pool.destroy(particles[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_release_all)
+{
+    SketchStl::object_pool<uint64_t, 8> pool;
+    for (int i = 0; i < 100; i++) {
+        *(uint64_t*)pool.allocate() = i;
+    }
+    BOOST_REQUIRE(pool.live_count() == 100);
+
+    pool.release_all();
+    BOOST_REQUIRE(pool.live_count() == 0 && pool.block_count() == 0);
+    BOOST_REQUIRE(pool.peak_count() == 100);
+
+    uint64_t* value = (uint64_t*)pool.allocate();
+    *value = 42;
+    BOOST_REQUIRE(pool.live_count() == 1 && pool.block_count() > 0);
+    pool.deallocate(value);
+}
+
+// Allocator that fails once it has handed out a given number of blocks
+struct LimitedAllocator {
+    static const size_t alignment = alignof(max_align_t);
+
+    static void* allocate(size_t size) {
+        if (blocksLeft == 0) {
+            return nullptr;
+        }
+        blocksLeft -= 1;
+        return malloc(size);
+    }
+
+    static void deallocate(void* ptr) {
+        free(ptr);
+    }
+
+    static int blocksLeft;
+};
+int LimitedAllocator::blocksLeft = 0;
+
+BOOST_AUTO_TEST_CASE(object_pool_allocation_failure)
+{
+    LimitedAllocator::blocksLeft = 1;
+    SketchStl::object_pool<Particle, 4, LimitedAllocator> pool;
+
+    // The slots of the only block are handed out, then the pool reports the failure instead of crashing
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 4; i++) {
+        particles.push_back(pool.create(1.0f, 2.0f));
+        BOOST_REQUIRE(particles.back() != nullptr);
+    }
+    BOOST_REQUIRE(pool.allocate() == nullptr);
+    BOOST_REQUIRE(pool.create(3.0f, 4.0f) == nullptr);
+    BOOST_REQUIRE(Particle::numParticles == 4 && pool.live_count() == 4);
+
+    // Freed slots and new blocks are used again once they are available
+    pool.destroy(particles.back());
+    particles.back() = pool.create(5.0f, 6.0f);
+    BOOST_REQUIRE(particles.back() != nullptr && particles.back()->x_ == 5.0f);
+
+    LimitedAllocator::blocksLeft = 1;
+    particles.push_back(pool.create(7.0f, 8.0f));
+    BOOST_REQUIRE(particles.back() != nullptr && pool.block_count() == 2);
+
+    for (size_t i = 0; i < particles.size(); i++) {
+        pool.destroy(particles[i]);
+    }
+    BOOST_REQUIRE(Particle::numParticles == 0);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_threads)
+{
+    const int numThreads = 6;
+    const int numRounds = 200;
+
+    SketchStl::object_pool<SketchStl::string, 64> pool;
+
+    // Objects are created on one thread and destroyed on another, so slots move between the thread caches
+    std::vector<std::vector<SketchStl::string*>> created(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&pool, &created, t]() {
+            for (int i = 0; i < numRounds; i++) {
+                SketchStl::string* str = pool.create("pooled");
+                if ((i % 3) == 0) {
+                    created[t].push_back(str);
+                } else {
+                    pool.destroy(str);
+                }
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    threads.clear();
+
+    size_t kept = 0;
+    for (int t = 0; t < numThreads; t++) {
+        kept += created[t].size();
+    }
+    BOOST_REQUIRE(pool.live_count() == kept);
+
+    std::atomic<bool> intact(true);
+    for (int t = 0; t < numThreads; t++) {
+        threads.push_back(std::thread([&pool, &created, &intact, t]() {
+            std::vector<SketchStl::string*>& strings = created[(t + 1) % numThreads];
+            for (size_t i = 0; i < strings.size(); i++) {
+                if (*strings[i] != "pooled") {
+                    intact.store(false);
+                }
+                pool.destroy(strings[i]);
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    BOOST_REQUIRE(intact.load());
+    BOOST_REQUIRE(pool.live_count() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_peak_across_threads)
+{
+    const int numRounds = 100;
+    const int numSlots = 10;
+
+    // The main thread allocates a few slots per round and a worker frees them, so no more than numSlots are ever
+    // live. Each thread may not have settled a cache of 64 slots with the pool when the peak is recorded
+    SketchStl::object_pool<uint64_t, 256> pool;
+    void* slots[numSlots];
+    std::atomic<int> round(0);
+
+    std::thread worker([&pool, &slots, &round]() {
+        for (int r = 0; r < numRounds; r++) {
+            while (round.load() != 2 * r + 1) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < numSlots; i++) {
+                pool.deallocate(slots[i]);
+            }
+            round.store(2 * r + 2);
+        }
+    });
+
+    for (int r = 0; r < numRounds; r++) {
+        for (int i = 0; i < numSlots; i++) {
+            slots[i] = pool.allocate();
+        }
+        round.store(2 * r + 1);
+        while (round.load() != 2 * r + 2) {
+            std::this_thread::yield();
+        }
+    }
+    worker.join();
+
+    BOOST_REQUIRE(pool.live_count() == 0);
+    BOOST_REQUIRE(pool.peak_count() >= numSlots && pool.peak_count() <= numSlots + 2 * 64);
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_thread_lifetimes)
+{
+    // Each thread gets back the slot it freed last, from its own cache. Many more threads than cores come and go,
+    // and the caches they leave are handed to the next ones
+    SketchStl::object_pool<uint64_t, 32> pool;
+    std::atomic<int> reused(0);
+    for (int round = 0; round < 4; round++) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 12; t++) {
+            threads.push_back(std::thread([&pool, &reused]() {
+                void* first = pool.allocate();
+                pool.deallocate(first);
+                void* second = pool.allocate();
+                reused += first == second ? 1 : 0;
+                pool.deallocate(second);
+            }));
+        }
+        for (size_t t = 0; t < threads.size(); t++) {
+            threads[t].join();
+        }
+    }
+    BOOST_REQUIRE(reused.load() == 48);
+    BOOST_REQUIRE(pool.live_count() == 0 && pool.peak_count() >= 1);
+
+    // A thread can outlive the pools it used, and use new pools after them
+    std::atomic<bool> valid(true);
+    std::thread worker([&valid]() {
+        for (int i = 0; i < 3; i++) {
+            SketchStl::object_pool<uint64_t, 8> local;
+            uint64_t* value = (uint64_t*)local.allocate();
+            *value = i;
+            valid = valid && local.live_count() == 1;
+            local.deallocate(value);
+        }
+    });
+    worker.join();
+    BOOST_REQUIRE(valid.load());
+}
+
+BOOST_AUTO_TEST_CASE(object_pool_vector_storage)
+{
+    typedef SketchStl::pool_allocator<128> PoolAllocator;
+    size_t live = PoolAllocator::pool().live_count();
+
+    {
+        // A small vector lives in a slot of the pool, and leaves it when it outgrows the slot
+        SketchStl::vector<int, PoolAllocator> vec;
+        BOOST_REQUIRE(PoolAllocator::pool().live_count() == live + 1);
+
+        for (int i = 0; i < 100; i++) {
+            vec.push_back(i);
+        }
+        BOOST_REQUIRE(PoolAllocator::pool().live_count() == live);
+
+        for (int i = 0; i < 100; i++) {
+            BOOST_REQUIRE(vec[i] == i);
+        }
+
+        SketchStl::vector<SketchStl::vector<int, PoolAllocator>> many;
+        for (int i = 0; i < 50; i++) {
+            many.push_back(SketchStl::vector<int, PoolAllocator>(3, i));
+        }
+        BOOST_REQUIRE(PoolAllocator::pool().live_count() == live + 50);
+    }
+
+    BOOST_REQUIRE(PoolAllocator::pool().live_count() == live);
+}
@@ -0,0 +1,154 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_packed_vector.h"
+#include <stdint.h>
+#include <vector>
+
+template <unsigned Bits>
+void CheckPackedVector(size_t n, unsigned int seed) {
+    typedef typename SketchStl::packed_vector<Bits>::value_type value_type;
+
+    std::vector<value_type> stdVec;
+    SketchStl::packed_vector<Bits> vec;
+
+    uint64_t state = seed;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        value_type value = (value_type)(state >> 17) & SketchStl::packed_vector<Bits>::max_value;
+        stdVec.push_back(value);
+        vec.push_back(value);
+    }
+
+    BOOST_REQUIRE(vec.size() == n);
+    BOOST_REQUIRE(vec.memory_bytes() == (n * Bits + 63) / 64 * 8);
+    for (size_t i = 0; i < n; i++) {
+        BOOST_REQUIRE(vec[i] == stdVec[i]);
+    }
+
+    SketchStl::vector<value_type> unpacked;
+    vec.unpack(unpacked);
+    BOOST_REQUIRE(unpacked.size() == n);
+    for (size_t i = 0; i < n; i++) {
+        BOOST_REQUIRE(unpacked[i] == stdVec[i]);
+    }
+
+    // Ranges that start and end anywhere, to go through both the vector and the scalar decoders
+    std::vector<value_type> range(n);
+    for (size_t first = 0; first < n; first += 37) {
+        size_t count = n - first < 45 ? n - first : 45;
+        vec.unpack(first, count, range.data());
+        for (size_t i = 0; i < count; i++) {
+            BOOST_REQUIRE(range[i] == stdVec[first + i]);
+        }
+    }
+
+    // Overwriting a value leaves its neighbours alone
+    if (n > 2) {
+        vec.set(1, SketchStl::packed_vector<Bits>::max_value);
+        vec.set(1, 0);
+        BOOST_REQUIRE(vec[0] == stdVec[0] && vec[1] == 0 && vec[2] == stdVec[2]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(packed_vector_widths)
+{
+    CheckPackedVector<1>(300, 1);
+    CheckPackedVector<3>(300, 2);
+    CheckPackedVector<7>(1000, 3);
+    CheckPackedVector<12>(1000, 4);
+    CheckPackedVector<25>(1000, 5);
+    CheckPackedVector<26>(500, 6);
+    CheckPackedVector<32>(500, 7);
+    CheckPackedVector<33>(500, 8);
+    CheckPackedVector<64>(100, 9);
+}
+
+BOOST_AUTO_TEST_CASE(packed_vector_fill_and_clear)
+{
+    SketchStl::packed_vector<5> vec(100, 17);
+    BOOST_REQUIRE(vec.size() == 100 && vec.memory_bytes() == 64);
+    for (size_t i = 0; i < vec.size(); i++) {
+        BOOST_REQUIRE(vec[i] == 17);
+    }
+
+    vec.clear();
+    BOOST_REQUIRE(vec.empty() && vec.num_words() == 0);
+}
+
+void CheckDeltaSequence(const std::vector<uint32_t>& values) {
+    SketchStl::delta_sequence seq;
+    for (size_t i = 0; i < values.size(); i++) {
+        seq.push_back(values[i]);
+    }
+
+    BOOST_REQUIRE(seq.size() == values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        BOOST_REQUIRE(seq[i] == values[i]);
+    }
+
+    uint32_t block[SketchStl::delta_sequence::block_size];
+    size_t pos = 0;
+    for (size_t b = 0; b < seq.num_blocks(); b++) {
+        size_t count = seq.decode_block(b, block);
+        for (size_t i = 0; i < count; i++) {
+            BOOST_REQUIRE(block[i] == values[pos + i]);
+        }
+        pos += count;
+    }
+    BOOST_REQUIRE(pos == values.size());
+
+    SketchStl::vector<uint32_t> unpacked;
+    seq.unpack(unpacked);
+    BOOST_REQUIRE(unpacked.size() == values.size());
+    for (size_t i = 0; i < values.size(); i++) {
+        BOOST_REQUIRE(unpacked[i] == values[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(delta_sequence_posting_list)
+{
+    // A sorted list with small gaps is stored in a few bits per value
+    std::vector<uint32_t> values;
+    uint32_t state = 42;
+    uint32_t id = 1000;
+    for (int i = 0; i < 10000; i++) {
+        state = state * 1103515245 + 12345;
+        id += 1 + (state >> 16) % 20;
+        values.push_back(id);
+    }
+    CheckDeltaSequence(values);
+
+    SketchStl::delta_sequence seq;
+    for (size_t i = 0; i < values.size(); i++) {
+        seq.push_back(values[i]);
+    }
+    BOOST_REQUIRE(seq.memory_bytes() * 4 < values.size() * sizeof(uint32_t));
+}
+
+BOOST_AUTO_TEST_CASE(delta_sequence_special_cases)
+{
+    // Constant steps need no packed bits at all
+    std::vector<uint32_t> values;
+    for (uint32_t i = 0; i < 1000; i++) {
+        values.push_back(i * 3);
+    }
+    CheckDeltaSequence(values);
+
+    // Unsorted values still round-trip, the differences wrap around
+    values.clear();
+    uint32_t state = 7;
+    for (int i = 0; i < 777; i++) {
+        state = state * 1103515245 + 12345;
+        values.push_back(state);
+    }
+    CheckDeltaSequence(values);
+
+    values.clear();
+    CheckDeltaSequence(values);
+
+    SketchStl::delta_sequence seq;
+    seq.push_back(5);
+    seq.clear();
+    BOOST_REQUIRE(seq.empty() && seq.num_blocks() == 0);
+}
@@ -0,0 +1,197 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_priority_queue.h"
+#include "sketch_string.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <functional>
+#include <queue>
+#include <vector>
+
+struct StringLess {
+    bool operator()(const SketchStl::string& a, const SketchStl::string& b) const {
+        return a.compare(b) < 0;
+    }
+};
+
+template <size_t Arity>
+void CheckPriorityQueue(size_t n) {
+    std::priority_queue<int> expected;
+    SketchStl::priority_queue<int, std::less<int>, Arity> queue;
+
+    uint32_t state = 99;
+    for (size_t i = 0; i < n; i++) {
+        state = state * 1103515245 + 12345;
+        int value = (int)(state >> 16) % 500;
+        expected.push(value);
+        queue.push(value);
+
+        // Interleave pops with the pushes
+        if (i % 3 == 2) {
+            BOOST_REQUIRE(queue.top() == expected.top());
+            expected.pop();
+            queue.pop();
+        }
+    }
+
+    BOOST_REQUIRE(queue.size() == expected.size());
+    while (!expected.empty()) {
+        BOOST_REQUIRE(queue.top() == expected.top());
+        expected.pop();
+        queue.pop();
+    }
+    BOOST_REQUIRE(queue.empty());
+}
+
+BOOST_AUTO_TEST_CASE(priority_queue_push_pop)
+{
+    CheckPriorityQueue<2>(1000);
+    CheckPriorityQueue<4>(1000);
+    CheckPriorityQueue<5>(1000);
+}
+
+BOOST_AUTO_TEST_CASE(priority_queue_heapify)
+{
+    SketchStl::vector<int> values;
+    for (int i = 0; i < 1000; i++) {
+        values.push_back((i * 7919) % 1000);
+    }
+
+    SketchStl::priority_queue<int, std::greater<int> > queue(std::move(values));
+    BOOST_REQUIRE(queue.size() == 1000);
+    for (int i = 0; i < 1000; i++) {
+        BOOST_REQUIRE(queue.extract_top() == i);
+    }
+
+    SketchStl::vector<int> more(10, 3);
+    queue.heapify(std::move(more));
+    BOOST_REQUIRE(queue.size() == 10 && queue.top() == 3);
+    queue.clear();
+    BOOST_REQUIRE(queue.empty());
+}
+
+BOOST_AUTO_TEST_CASE(priority_queue_moves_payloads)
+{
+    // Long strings, so that every payload has its own buffer
+    std::vector<const char*> buffers;
+    SketchStl::priority_queue<SketchStl::string, StringLess> queue;
+    for (int i = 0; i < 200; i++) {
+        char text[64];
+        sprintf(text, "job %03d with a payload too long for any small buffer", (i * 37) % 200);
+
+        SketchStl::string payload(text);
+        buffers.push_back(payload.c_str());
+        queue.push(std::move(payload));
+    }
+
+    // The strings that come out own the buffers that went in, none was copied
+    for (int i = 199; i >= 0; i--) {
+        SketchStl::string payload = queue.extract_top();
+
+        char text[64];
+        sprintf(text, "job %03d with a payload too long for any small buffer", i);
+        BOOST_REQUIRE(payload.compare(text) == 0);
+        BOOST_REQUIRE(std::find(buffers.begin(), buffers.end(), payload.c_str()) != buffers.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(top_k_collector)
+{
+    SketchStl::top_k<int, 10> top;
+    std::vector<int> values;
+    uint32_t state = 5;
+    for (int i = 0; i < 10000; i++) {
+        state = state * 1103515245 + 12345;
+        int value = (int)(state >> 8) % 100000;
+        values.push_back(value);
+        top.push(value);
+        BOOST_REQUIRE(top.size() == (size_t)(i < 10 ? i + 1 : 10));
+    }
+
+    std::sort(values.begin(), values.end(), std::greater<int>());
+    BOOST_REQUIRE(top.full() && top.threshold() == values[9]);
+    BOOST_REQUIRE(!top.push(values[9] - 1));
+
+    SketchStl::vector<int> result;
+    top.take_sorted(result);
+    BOOST_REQUIRE(top.empty() && result.size() == 10);
+    BOOST_REQUIRE(std::equal(values.begin(), values.begin() + 10, result.data()));
+
+    // A vector reserved for the elements holds them without reallocating
+    for (int i = 0; i < 10; i++) {
+        top.push(i);
+    }
+    SketchStl::vector<int> exact;
+    exact.reserve(10);
+    const int* data = exact.data();
+    top.take_sorted(exact);
+    BOOST_REQUIRE(exact.size() == 10 && exact.data() == data && exact[0] == 9);
+
+    SketchStl::priority_queue<int> queue;
+    queue.reserve(16);
+    size_t capacity = queue.capacity();
+    for (int i = 0; i < 16; i++) {
+        queue.push(i);
+    }
+    BOOST_REQUIRE(queue.size() == 16 && queue.top() == 15 && queue.capacity() == capacity);
+}
+
+struct CopyCounted {
+    CopyCounted(int v) : value(v) {}
+    CopyCounted(const CopyCounted& src) : value(src.value) { copies++; }
+    CopyCounted(CopyCounted&& src) : value(src.value) {}
+    CopyCounted& operator=(const CopyCounted& rhs) { value = rhs.value; copies++; return *this; }
+    CopyCounted& operator=(CopyCounted&& rhs) { value = rhs.value; return *this; }
+    bool operator<(const CopyCounted& rhs) const { return value < rhs.value; }
+
+    int value;
+    static int copies;
+};
+int CopyCounted::copies = 0;
+
+BOOST_AUTO_TEST_CASE(top_k_rejects_without_copying)
+{
+    SketchStl::top_k<CopyCounted, 4> top;
+    for (int i = 0; i < 4; i++) {
+        top.push(CopyCounted(i + 100));
+    }
+
+    // Elements that do not beat the threshold are turned away before being copied
+    CopyCounted::copies = 0;
+    for (int i = 0; i < 100; i++) {
+        const CopyCounted val(i);
+        BOOST_REQUIRE(!top.push(val));
+    }
+    BOOST_REQUIRE(CopyCounted::copies == 0);
+
+    const CopyCounted best(1000);
+    BOOST_REQUIRE(top.push(best) && CopyCounted::copies == 1);
+}
+
+BOOST_AUTO_TEST_CASE(top_k_smallest_strings)
+{
+    // The smallest elements are the largest for the reversed order. Fewer elements than K are all kept
+    struct StringGreater {
+        bool operator()(const SketchStl::string& a, const SketchStl::string& b) const { return a.compare(b) > 0; }
+    };
+
+    SketchStl::top_k<SketchStl::string, 4, StringGreater> top;
+    const char* words[] = { "pear", "figs", "plum", "kiwi", "apex", "lime", "date" };
+    for (size_t i = 0; i < 7; i++) {
+        top.push(SketchStl::string(words[i]));
+    }
+
+    SketchStl::vector<SketchStl::string> result;
+    top.take_sorted(result);
+    BOOST_REQUIRE(result.size() == 4);
+    BOOST_REQUIRE(result[0].compare("apex") == 0 && result[1].compare("date") == 0);
+    BOOST_REQUIRE(result[2].compare("figs") == 0 && result[3].compare("kiwi") == 0);
+
+    SketchStl::top_k<int, 8> few;
+    few.push(3);
+    few.push(1);
+    SketchStl::vector<int> small;
+    few.take_sorted(small);
+    BOOST_REQUIRE(small.size() == 2 && small[0] == 3 && small[1] == 1);
+}
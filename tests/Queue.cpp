@@ -0,0 +1,216 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_queue.h"
+#include "sketch_string.h"
+#include "sketch_vector.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(spsc_queue_push_pop)
+{
+    SketchStl::spsc_queue<int> queue(5);
+    BOOST_REQUIRE(queue.capacity() == 8);
+    BOOST_REQUIRE(queue.empty());
+
+    // Go around the ring a few times
+    int popped;
+    for (int lap = 0; lap < 3; lap++) {
+        for (int i = 0; i < 8; i++) {
+            BOOST_REQUIRE(queue.try_push(lap * 8 + i));
+        }
+        BOOST_REQUIRE(!queue.try_push(-1));
+        BOOST_REQUIRE(queue.size() == 8);
+
+        for (int i = 0; i < 8; i++) {
+            BOOST_REQUIRE(queue.try_pop(popped) && popped == lap * 8 + i);
+        }
+        BOOST_REQUIRE(!queue.try_pop(popped));
+    }
+
+    int values[10] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    BOOST_REQUIRE(queue.try_push(values, 10) == 8);
+
+    int out[10];
+    BOOST_REQUIRE(queue.try_pop(out, 3) == 3);
+    BOOST_REQUIRE(out[0] == 0 && out[2] == 2);
+    BOOST_REQUIRE(queue.try_push(values + 8, 2) == 2);
+    BOOST_REQUIRE(queue.try_pop(out, 10) == 7);
+    BOOST_REQUIRE(out[0] == 3 && out[4] == 7 && out[5] == 8 && out[6] == 9);
+}
+
+BOOST_AUTO_TEST_CASE(spsc_queue_moves_payloads)
+{
+    SketchStl::spsc_queue<SketchStl::string> queue(4);
+
+    SketchStl::string str("a payload that owns its buffer");
+    const char* buffer = str.c_str();
+    BOOST_REQUIRE(queue.try_push(std::move(str)));
+    BOOST_REQUIRE(str.empty());
+
+    SketchStl::string received;
+    BOOST_REQUIRE(queue.try_pop(received));
+    BOOST_REQUIRE(received == "a payload that owns its buffer");
+    BOOST_REQUIRE(received.c_str() == buffer);
+
+    // Elements left in the queue are destroyed with it
+    queue.try_push(SketchStl::string("left behind"));
+}
+
+BOOST_AUTO_TEST_CASE(spsc_queue_threads)
+{
+    const int numValues = 100000;
+    SketchStl::spsc_queue<SketchStl::vector<int>> queue(64);
+
+    std::thread producer([&queue]() {
+        SketchStl::vector<int> batch[4];
+        for (int i = 0; i < numValues; i += 4) {
+            for (int j = 0; j < 4; j++) {
+                batch[j] = SketchStl::vector<int>(1, i + j);
+            }
+
+            size_t pushed = 0;
+            while (pushed < 4) {
+                pushed += queue.try_push(batch + pushed, 4 - pushed);
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    SketchStl::vector<int> received[8];
+    while (expected < numValues) {
+        size_t count = queue.try_pop(received, 8);
+        for (size_t i = 0; i < count; i++) {
+            BOOST_REQUIRE(received[i].size() == 1 && received[i][0] == expected);
+            expected += 1;
+        }
+
+        if (count == 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    producer.join();
+    BOOST_REQUIRE(queue.empty());
+}
+
+BOOST_AUTO_TEST_CASE(mpmc_queue_push_pop)
+{
+    SketchStl::mpmc_queue<SketchStl::string> queue(4);
+    BOOST_REQUIRE(queue.capacity() == 4);
+
+    SketchStl::string values[6] = { "a", "b", "c", "d", "e", "f" };
+    BOOST_REQUIRE(queue.try_push(values, 6) == 4);
+    BOOST_REQUIRE(!queue.try_push(SketchStl::string("g")));
+    BOOST_REQUIRE(queue.size() == 4);
+
+    SketchStl::string out[4];
+    BOOST_REQUIRE(queue.try_pop(out, 2) == 2);
+    BOOST_REQUIRE(out[0] == "a" && out[1] == "b");
+    BOOST_REQUIRE(queue.try_push(values + 4, 2) == 2);
+
+    SketchStl::string popped;
+    const char* expected[4] = { "c", "d", "e", "f" };
+    for (int i = 0; i < 4; i++) {
+        BOOST_REQUIRE(queue.try_pop(popped) && popped == expected[i]);
+    }
+    BOOST_REQUIRE(!queue.try_pop(popped));
+    BOOST_REQUIRE(queue.empty());
+
+    // Empty batches return at once, whether the queue is empty, partly filled or full
+    BOOST_REQUIRE(queue.try_pop(out, 0) == 0);
+    BOOST_REQUIRE(queue.try_push(values, 0) == 0);
+    BOOST_REQUIRE(queue.try_push(values, 1) == 1);
+    BOOST_REQUIRE(queue.try_push(values, 0) == 0);
+    BOOST_REQUIRE(queue.try_pop(out, 0) == 0);
+    BOOST_REQUIRE(queue.try_push(values, 3) == 3);
+    BOOST_REQUIRE(queue.try_push(values, 0) == 0);
+    BOOST_REQUIRE(queue.size() == 4);
+}
+
+BOOST_AUTO_TEST_CASE(mpmc_queue_capacity_one)
+{
+    // A single slot could not tell a full slot from a free one, so the ring gets two
+    SketchStl::mpmc_queue<SketchStl::string> queue(1);
+    BOOST_REQUIRE(queue.capacity() == 2);
+
+    BOOST_REQUIRE(queue.try_push(SketchStl::string("a")));
+    BOOST_REQUIRE(queue.try_push(SketchStl::string("b")));
+    BOOST_REQUIRE(!queue.try_push(SketchStl::string("c")));
+
+    SketchStl::string popped;
+    BOOST_REQUIRE(queue.try_pop(popped) && popped == "a");
+    BOOST_REQUIRE(queue.try_pop(popped) && popped == "b");
+    BOOST_REQUIRE(!queue.try_pop(popped));
+}
+
+BOOST_AUTO_TEST_CASE(mpmc_queue_threads)
+{
+    const int numProducers = 4;
+    const int numConsumers = 4;
+    const int numValues = 20000;
+
+    SketchStl::mpmc_queue<int> queue(128);
+    std::vector<std::vector<int>> seen(numConsumers);
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numProducers; t++) {
+        threads.push_back(std::thread([&queue, t]() {
+            int values[3];
+            for (int i = 0; i < numValues; i += 3) {
+                size_t n = (numValues - i) < 3 ? numValues - i : 3;
+                for (size_t j = 0; j < n; j++) {
+                    values[j] = t * numValues + i + (int)j;
+                }
+
+                size_t pushed = 0;
+                while (pushed < n) {
+                    pushed += queue.try_push(values + pushed, n - pushed);
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    std::atomic<int> remaining(numProducers * numValues);
+    for (int t = 0; t < numConsumers; t++) {
+        threads.push_back(std::thread([&queue, &seen, &remaining, t]() {
+            int values[5];
+            while (remaining.load() > 0) {
+                size_t count = (t % 2) == 0 ? queue.try_pop(values, 5) : (size_t)queue.try_pop(values[0]);
+                for (size_t i = 0; i < count; i++) {
+                    seen[t].push_back(values[i]);
+                }
+                remaining.fetch_sub((int)count);
+
+                if (count == 0) {
+                    std::this_thread::yield();
+                }
+            }
+        }));
+    }
+
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+
+    // Every value is received exactly once, and each consumer sees the values of a producer in order
+    std::vector<int> counts(numProducers * numValues, 0);
+    for (int t = 0; t < numConsumers; t++) {
+        std::vector<int> last(numProducers, -1);
+        for (size_t i = 0; i < seen[t].size(); i++) {
+            int value = seen[t][i];
+            counts[value] += 1;
+
+            BOOST_REQUIRE(value > last[value / numValues]);
+            last[value / numValues] = value;
+        }
+    }
+
+    for (size_t i = 0; i < counts.size(); i++) {
+        BOOST_REQUIRE(counts[i] == 1);
+    }
+    BOOST_REQUIRE(queue.empty());
+}
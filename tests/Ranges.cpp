@@ -0,0 +1,160 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_ranges.h"
+#include "sketch_string.h"
+#include <string.h>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(ranges_filter_transform_take)
+{
+    SketchStl::vector<int> values;
+    for (int i = 0; i < 100; i++) {
+        values.push_back(i);
+    }
+
+    // Walking stops as soon as take has its elements, so the predicate only sees the values up to the last one
+    int tested = 0;
+    auto pipeline = values
+        | SketchStl::views::filter([&tested](int v) { tested++; return v % 3 == 0; })
+        | SketchStl::views::transform([](int v) { return v * 10; })
+        | SketchStl::views::take(5);
+
+    SketchStl::vector<int> result = SketchStl::views::to_vector(pipeline);
+    int expected[] = { 0, 30, 60, 90, 120 };
+    BOOST_REQUIRE(result.size() == 5);
+    BOOST_REQUIRE(std::equal(expected, expected + 5, result.data()));
+    BOOST_REQUIRE(tested == 13);
+
+    // Range-based for goes through the same pipeline
+    std::vector<int> walked;
+    for (int v : pipeline) {
+        walked.push_back(v);
+    }
+    BOOST_REQUIRE(walked == std::vector<int>(expected, expected + 5));
+
+    // Views that keep the size give access to any element
+    auto sized = values | SketchStl::views::drop(90) | SketchStl::views::transform([](int v) { return v + 1; });
+    BOOST_REQUIRE(sized.size() == 10);
+    BOOST_REQUIRE(sized[0] == 91 && sized[9] == 100);
+    BOOST_REQUIRE((values | SketchStl::views::drop(200)).size() == 0);
+    BOOST_REQUIRE((values | SketchStl::views::take(200)).size() == 100);
+
+    SketchStl::vector<int> tail = sized | SketchStl::views::to_vector();
+    BOOST_REQUIRE(tail.size() == 10 && tail[5] == 96);
+
+    // The vector is reserved once for the size of the view
+    SketchStl::vector<int> reserved;
+    reserved.reserve(10);
+    BOOST_REQUIRE(tail.capacity() == reserved.capacity());
+
+    // Views write through to the vector
+    for (int& v : values | SketchStl::views::take(3)) {
+        v = -1;
+    }
+    BOOST_REQUIRE(values[0] == -1 && values[2] == -1 && values[3] == 3);
+}
+
+BOOST_AUTO_TEST_CASE(ranges_strings_single_pass)
+{
+    const char* words[] = { "ant", "bee", "cat", "dog", "eel", "fox", "gnu" };
+    SketchStl::vector<SketchStl::string> animals;
+    for (size_t i = 0; i < 7; i++) {
+        animals.push_back(SketchStl::string(words[i]));
+    }
+
+    const SketchStl::vector<SketchStl::string>& source = animals;
+    SketchStl::vector<SketchStl::string> upper = source
+        | SketchStl::views::filter([](const SketchStl::string& s) { return s[0] != 'c' && s[0] != 'e'; })
+        | SketchStl::views::transform([](const SketchStl::string& s) {
+            SketchStl::string copy(s);
+            copy[0] = (char)(copy[0] - 'a' + 'A');
+            return copy;
+        })
+        | SketchStl::views::to_vector();
+
+    const char* expected[] = { "Ant", "Bee", "Dog", "Fox", "Gnu" };
+    BOOST_REQUIRE(upper.size() == 5);
+    for (size_t i = 0; i < 5; i++) {
+        BOOST_REQUIRE(strcmp(upper[i].c_str(), expected[i]) == 0);
+    }
+
+    // The source is left alone
+    BOOST_REQUIRE(strcmp(animals[0].c_str(), "ant") == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ranges_zip_enumerate_chunk)
+{
+    SketchStl::vector<int> keys;
+    SketchStl::vector<double> weights;
+    for (int i = 0; i < 10; i++) {
+        keys.push_back(i * i);
+        weights.push_back(i * 0.5);
+    }
+    weights.pop_back();
+
+    auto pairs = SketchStl::views::zip(keys, weights);
+    BOOST_REQUIRE(pairs.size() == 9);
+    BOOST_REQUIRE(pairs[3].first == 9 && pairs[3].second == 1.5);
+
+    size_t n = 0;
+    for (auto pair : pairs) {
+        BOOST_REQUIRE(pair.first == (int)(n * n) && pair.second == n * 0.5);
+        n++;
+    }
+    BOOST_REQUIRE(n == 9);
+
+    pairs[2].first = 5;
+    BOOST_REQUIRE(keys[2] == 5);
+    keys[2] = 4;
+
+    // Positions count the elements that come out of the filter
+    SketchStl::vector<std::pair<size_t, int>> odd = keys
+        | SketchStl::views::filter([](int v) { return v % 2 == 1; })
+        | SketchStl::views::enumerate()
+        | SketchStl::views::to_vector();
+    BOOST_REQUIRE(odd.size() == 5);
+    BOOST_REQUIRE(odd[0].first == 0 && odd[0].second == 1);
+    BOOST_REQUIRE(odd[4].first == 4 && odd[4].second == 81);
+
+    auto chunks = keys | SketchStl::views::chunk(4);
+    BOOST_REQUIRE(chunks.size() == 3);
+    BOOST_REQUIRE(chunks[0].size() == 4 && chunks[2].size() == 2);
+
+    int total = 0;
+    for (auto chunk : chunks) {
+        for (int v : chunk) {
+            total += v;
+        }
+    }
+    BOOST_REQUIRE(total == 285);
+    BOOST_REQUIRE(chunks[2][1] == 81);
+
+    SketchStl::vector<int> empty;
+    BOOST_REQUIRE((empty | SketchStl::views::chunk(3)).size() == 0);
+    BOOST_REQUIRE(SketchStl::views::to_vector(empty | SketchStl::views::enumerate()).size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ranges_iterator_category)
+{
+    SketchStl::vector<int> values;
+    std::vector<int> other;
+    for (int i = 0; i < 10; i++) {
+        values.push_back(i);
+        other.push_back(i);
+    }
+
+    // Views over vectors can be walked again, views over any other range only once
+    auto twice = values | SketchStl::views::transform([](int v) { return v * 2; });
+    auto once = other | SketchStl::views::filter([](int v) { return v % 2 == 0; });
+    static_assert(std::is_same<decltype(twice.begin())::iterator_category, std::forward_iterator_tag>::value, "");
+    static_assert(std::is_same<decltype(once.begin())::iterator_category, std::input_iterator_tag>::value, "");
+    static_assert(std::is_same<decltype(SketchStl::views::zip(values, once).begin())::iterator_category, std::input_iterator_tag>::value, "");
+
+    // take and drop clamp their size to the size of the source
+    auto taken = values | SketchStl::views::drop(7) | SketchStl::views::take(5);
+    BOOST_REQUIRE(taken.size() == 3);
+    BOOST_REQUIRE(taken[0] == 7 && taken[2] == 9);
+}
@@ -0,0 +1,121 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_segmented_vector.h"
+#include "sketch_string.h"
+#include <algorithm>
+#include <vector>
+
+template <size_t ChunkSize>
+bool CompareSegmentedVectors(const std::vector<int>& stdVec, const SketchStl::segmented_vector<int, ChunkSize>& vec) {
+    if (stdVec.size() != vec.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < stdVec.size(); i++) {
+        if (stdVec[i] != vec[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+BOOST_AUTO_TEST_CASE(segmented_vector_push_back)
+{
+    std::vector<int> stdVec;
+    SketchStl::segmented_vector<int, 4> vec;
+
+    for (int i = 0; i < 37; i++) {
+        stdVec.push_back(i);
+        vec.push_back(i);
+    }
+
+    BOOST_REQUIRE(CompareSegmentedVectors(stdVec, vec));
+    BOOST_REQUIRE(vec.front() == 0 && vec.back() == 36);
+    BOOST_REQUIRE(vec.capacity() == 40);
+
+    stdVec.pop_back();
+    vec.pop_back();
+    BOOST_REQUIRE(CompareSegmentedVectors(stdVec, vec));
+}
+
+BOOST_AUTO_TEST_CASE(segmented_vector_stable_addresses)
+{
+    SketchStl::segmented_vector<int, 8> vec;
+    std::vector<int*> addresses;
+
+    for (int i = 0; i < 1000; i++) {
+        vec.push_back(i);
+        addresses.push_back(&vec.back());
+    }
+
+    for (int i = 0; i < 1000; i++) {
+        BOOST_REQUIRE(addresses[i] == &vec[i]);
+        BOOST_REQUIRE(*addresses[i] == i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(segmented_vector_chunks)
+{
+    SketchStl::segmented_vector<int, 16> vec;
+    size_t first = vec.grow_by(40);
+    BOOST_REQUIRE(first == 0 && vec.size() == 40);
+    BOOST_REQUIRE(vec.chunk_count() == 3);
+
+    size_t total = 0;
+    for (size_t c = 0; c < vec.chunk_count(); c++) {
+        int* chunk = vec.chunk(c);
+        for (size_t i = 0; i < vec.chunk_size(c); i++) {
+            chunk[i] = (int)(total + i);
+        }
+        total += vec.chunk_size(c);
+    }
+    BOOST_REQUIRE(total == 40);
+    BOOST_REQUIRE(vec.chunk_size(2) == 8);
+
+    for (size_t i = 0; i < vec.size(); i++) {
+        BOOST_REQUIRE(vec[i] == (int)i);
+    }
+
+    vec.clear();
+    vec.shrink_to_fit();
+    BOOST_REQUIRE(vec.empty() && vec.capacity() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(segmented_vector_iterators)
+{
+    std::vector<int> stdVec;
+    SketchStl::segmented_vector<int, 4> vec;
+
+    for (int i = 0; i < 23; i++) {
+        stdVec.push_back((i * 7) % 23);
+        vec.push_back((i * 7) % 23);
+    }
+
+    std::sort(stdVec.begin(), stdVec.end());
+    std::sort(vec.begin(), vec.end());
+    BOOST_REQUIRE(CompareSegmentedVectors(stdVec, vec));
+    BOOST_REQUIRE(vec.end() - vec.begin() == 23);
+
+    int sum = 0;
+    for (int val : vec) {
+        sum += val;
+    }
+    BOOST_REQUIRE(sum == 22 * 23 / 2);
+}
+
+BOOST_AUTO_TEST_CASE(segmented_vector_class_type)
+{
+    SketchStl::segmented_vector<SketchStl::string, 2> vec(3, "abc");
+    vec.push_back("def");
+
+    SketchStl::segmented_vector<SketchStl::string, 2> copyVec(vec);
+    vec[0] = "xyz";
+
+    BOOST_REQUIRE(copyVec.size() == 4 && copyVec[0] == "abc" && copyVec[3] == "def");
+    BOOST_REQUIRE(vec[0] == "xyz");
+
+    copyVec = vec;
+    BOOST_REQUIRE(copyVec.size() == 4 && copyVec[0] == "xyz");
+}
@@ -0,0 +1,100 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_slot_map.h"
+#include "sketch_string.h"
+#include <iterator>
+#include <map>
+#include <vector>
+
+BOOST_AUTO_TEST_CASE(slot_map_insert_and_find)
+{
+    SketchStl::slot_map<SketchStl::string> map;
+    BOOST_REQUIRE(map.empty());
+
+    SketchStl::slot_handle a = map.insert(SketchStl::string("a"));
+    SketchStl::slot_handle b = map.insert(SketchStl::string("b"));
+    SketchStl::slot_handle c = map.insert(SketchStl::string("c"));
+
+    BOOST_REQUIRE(map.size() == 3);
+    BOOST_REQUIRE(map[a] == "a" && map[b] == "b" && map[c] == "c");
+    BOOST_REQUIRE(map.find(b) != nullptr && *map.find(b) == "b");
+
+    SketchStl::slot_handle invalid;
+    BOOST_REQUIRE(!map.contains(invalid));
+    BOOST_REQUIRE(map.find(invalid) == nullptr);
+
+    map[b] += "!";
+    BOOST_REQUIRE(map[b] == "b!");
+}
+
+BOOST_AUTO_TEST_CASE(slot_map_erase_and_reuse)
+{
+    SketchStl::slot_map<int> map;
+    SketchStl::slot_handle a = map.insert(1);
+    SketchStl::slot_handle b = map.insert(2);
+    SketchStl::slot_handle c = map.insert(3);
+
+    BOOST_REQUIRE(map.erase(a));
+    BOOST_REQUIRE(!map.erase(a));
+    BOOST_REQUIRE(!map.contains(a) && map.find(a) == nullptr);
+    BOOST_REQUIRE(map.size() == 2);
+
+    // The last value was moved into the hole, but the handles still reach it
+    BOOST_REQUIRE(map[b] == 2 && map[c] == 3);
+    BOOST_REQUIRE(map.data()[0] == 3);
+    BOOST_REQUIRE(map.handle_at(0) == c);
+
+    // The freed slot is reused with a new generation, so the old handle stays stale
+    SketchStl::slot_handle d = map.insert(4);
+    BOOST_REQUIRE(d.index == a.index && d.generation != a.generation);
+    BOOST_REQUIRE(!map.contains(a));
+    BOOST_REQUIRE(map[d] == 4);
+
+    int sum = 0;
+    for (SketchStl::slot_map<int>::iterator it = map.begin(); it != map.end(); ++it) {
+        sum += *it;
+    }
+    BOOST_REQUIRE(sum == 9);
+
+    map.clear();
+    BOOST_REQUIRE(map.empty());
+    BOOST_REQUIRE(!map.contains(b) && !map.contains(c) && !map.contains(d));
+
+    SketchStl::slot_handle e = map.insert(5);
+    BOOST_REQUIRE(map.size() == 1 && map[e] == 5);
+}
+
+BOOST_AUTO_TEST_CASE(slot_map_random_operations)
+{
+    SketchStl::slot_map<int> map;
+    std::map<int, SketchStl::slot_handle> expected;
+    std::vector<SketchStl::slot_handle> erased;
+
+    unsigned int seed = 12345;
+    for (int i = 0; i < 5000; i++) {
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 3 != 0 || expected.empty()) {
+            expected[i] = map.insert(i);
+        } else {
+            std::map<int, SketchStl::slot_handle>::iterator it = expected.begin();
+            std::advance(it, (seed >> 8) % expected.size());
+            BOOST_REQUIRE(map.erase(it->second));
+            erased.push_back(it->second);
+            expected.erase(it);
+        }
+    }
+
+    BOOST_REQUIRE(map.size() == expected.size());
+    for (std::map<int, SketchStl::slot_handle>::iterator it = expected.begin(); it != expected.end(); ++it) {
+        BOOST_REQUIRE(map[it->second] == it->first);
+    }
+
+    for (size_t i = 0; i < erased.size(); i++) {
+        BOOST_REQUIRE(!map.contains(erased[i]));
+    }
+
+    for (size_t i = 0; i < map.size(); i++) {
+        BOOST_REQUIRE(map[map.handle_at(i)] == map.data()[i]);
+    }
+}
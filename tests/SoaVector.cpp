@@ -0,0 +1,120 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_soa_vector.h"
+#include "sketch_string.h"
+#include <stdint.h>
+#include <tuple>
+
+BOOST_AUTO_TEST_CASE(soa_vector_push_back)
+{
+    SketchStl::soa_vector<float, int, SketchStl::string> vec;
+    BOOST_REQUIRE(vec.empty());
+
+    for (int i = 0; i < 100; i++) {
+        vec.push_back(i * 0.5f, i, SketchStl::string("row"));
+    }
+
+    BOOST_REQUIRE(vec.size() == 100);
+    BOOST_REQUIRE(vec.get<0>(10) == 5.0f);
+    BOOST_REQUIRE(vec.get<1>(10) == 10);
+    BOOST_REQUIRE(vec.get<2>(99) == "row");
+
+    vec.pop_back();
+    BOOST_REQUIRE(vec.size() == 99);
+
+    vec.clear();
+    BOOST_REQUIRE(vec.empty());
+}
+
+BOOST_AUTO_TEST_CASE(soa_vector_columns)
+{
+    SketchStl::soa_vector<float, double> vec;
+    vec.reserve(50);
+    BOOST_REQUIRE(vec.capacity() >= 50);
+
+    for (int i = 0; i < 50; i++) {
+        vec.push_back((float)i, -i);
+    }
+
+    // Every column is contiguous and aligned for vector loads
+    SketchStl::span<float> xs = vec.column<0>();
+    SketchStl::span<double> ys = vec.column<1>();
+    BOOST_REQUIRE(xs.size() == 50 && ys.size() == 50);
+    BOOST_REQUIRE(((uintptr_t)xs.data() % SketchStl::cache_line_size) == 0);
+    BOOST_REQUIRE(((uintptr_t)ys.data() % SketchStl::cache_line_size) == 0);
+
+    for (size_t i = 0; i < xs.size(); i++) {
+        xs[i] *= 2.0f;
+    }
+
+    float sum = 0.0f;
+    for (float x : xs) {
+        sum += x;
+    }
+    BOOST_REQUIRE(sum == 2450.0f);
+
+    const SketchStl::soa_vector<float, double>& constVec = vec;
+    SketchStl::span<const double> constYs = constVec.column<1>();
+    BOOST_REQUIRE(constYs[49] == -49.0);
+
+    // The capacity holds for every column, although a column of bytes rounds its capacity to more rows than a
+    // column of doubles
+    SketchStl::soa_vector<char, double> mixed;
+    mixed.reserve(10);
+    size_t capacity = mixed.capacity();
+    BOOST_REQUIRE(capacity >= 10);
+    mixed.push_back('a', 0.0);
+    const char* chars = mixed.column<0>().data();
+    const double* doubles = mixed.column<1>().data();
+    for (size_t i = 1; i < capacity; i++) {
+        mixed.push_back('a', (double)i);
+    }
+    BOOST_REQUIRE(mixed.column<0>().data() == chars && mixed.column<1>().data() == doubles);
+    BOOST_REQUIRE(mixed.capacity() == capacity);
+
+    SketchStl::span<const float> tail = SketchStl::span<const float>(xs).subspan(48, 2);
+    BOOST_REQUIRE(tail.size() == 2 && tail[0] == 96.0f && tail[1] == 98.0f);
+}
+
+BOOST_AUTO_TEST_CASE(soa_vector_rows)
+{
+    SketchStl::soa_vector<int, SketchStl::string> vec;
+    vec.push_back(1, SketchStl::string("one"));
+    vec.push_back(2, SketchStl::string("two"));
+    vec.push_back(3, SketchStl::string("three"));
+
+    SketchStl::soa_vector<int, SketchStl::string>::reference row = vec[1];
+    BOOST_REQUIRE(row.get<0>() == 2 && row.get<1>() == "two");
+
+    row.get<0>() = 20;
+    BOOST_REQUIRE(vec.get<0>(1) == 20);
+
+    vec[0] = std::make_tuple(10, SketchStl::string("ten"));
+    BOOST_REQUIRE(vec.get<0>(0) == 10 && vec.get<1>(0) == "ten");
+
+    // Assigning a row copies its fields, it does not rebind the proxy
+    vec[2] = vec[0];
+    BOOST_REQUIRE(vec.get<0>(2) == 10 && vec.get<1>(2) == "ten");
+    BOOST_REQUIRE(vec.get<0>(0) == 10);
+
+    const SketchStl::soa_vector<int, SketchStl::string>& constVec = vec;
+    std::tuple<int, SketchStl::string> copy = constVec[1];
+    BOOST_REQUIRE(std::get<0>(copy) == 20 && std::get<1>(copy) == "two");
+}
+
+BOOST_AUTO_TEST_CASE(soa_vector_resize_and_erase)
+{
+    SketchStl::soa_vector<int, float> vec;
+    vec.resize(4);
+    BOOST_REQUIRE(vec.size() == 4 && vec.get<0>(3) == 0 && vec.get<1>(3) == 0.0f);
+
+    for (int i = 0; i < 4; i++) {
+        vec[i] = std::make_tuple(i, i * 1.5f);
+    }
+
+    vec.unordered_erase(1);
+    BOOST_REQUIRE(vec.size() == 3);
+    BOOST_REQUIRE(vec.get<0>(1) == 3 && vec.get<1>(1) == 4.5f);
+    BOOST_REQUIRE(vec.get<0>(0) == 0 && vec.get<0>(2) == 2);
+}
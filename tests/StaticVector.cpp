@@ -0,0 +1,207 @@
+#define _CRTDBG_MAP_ALLOC
+#include <boost/test/unit_test.hpp>
+
+#include "sketch_static_vector.h"
+#include "sketch_string.h"
+#include <list>
+#include <memory>
+#include <vector>
+
+template <size_t N>
+bool CompareStaticVectors(const std::vector<int>& stdVec, const SketchStl::static_vector<int, N>& vec) {
+    if (stdVec.size() != vec.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < stdVec.size(); i++) {
+        if (stdVec[i] != vec[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+constexpr SketchStl::static_vector<int, 8> MakeSquares() {
+    SketchStl::static_vector<int, 8> vec;
+    for (int i = 0; i < 8; i++) {
+        vec.push_back(i * i);
+    }
+
+    vec.erase(vec.begin() + 1);
+    vec.insert(vec.begin(), -1);
+
+    return vec;
+}
+
+constexpr int Sum(const SketchStl::static_vector<int, 8>& vec) {
+    int sum = 0;
+    for (int val : vec) {
+        sum += val;
+    }
+
+    return sum;
+}
+
+constexpr SketchStl::static_vector<int, 8> squares = MakeSquares();
+static_assert(squares.size() == 8, "The table must be built at compile time");
+static_assert(squares[0] == -1 && squares[1] == 0 && squares[2] == 4 && squares[7] == 49, "Unexpected table content");
+static_assert(Sum(squares) == 138, "Iterators must be usable in constant expressions");
+
+constexpr SketchStl::static_vector<int, 8> partial(3, 5);
+static_assert(partial.size() == 3 && Sum(partial) == 15, "A partly filled table must be usable at compile time");
+
+BOOST_AUTO_TEST_CASE(static_vector_constexpr_table)
+{
+    std::vector<int> stdVec;
+    stdVec.push_back(-1);
+    for (int i = 0; i < 8; i++) {
+        if (i != 1) {
+            stdVec.push_back(i * i);
+        }
+    }
+
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, squares));
+}
+
+BOOST_AUTO_TEST_CASE(static_vector_value_type_modifiers)
+{
+    std::vector<int> stdVec(3, 7);
+    SketchStl::static_vector<int, 16> vec(3, 7);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    int buffer[] = { 1, 2, 3, 4 };
+    std::list<int> list(buffer, buffer + 4);
+
+    stdVec.insert(stdVec.begin() + 1, buffer, buffer + 4);
+    vec.insert(vec.begin() + 1, buffer, buffer + 4);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.insert(stdVec.end(), list.begin(), list.end());
+    vec.insert(vec.end(), list.begin(), list.end());
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.insert(stdVec.begin(), 2, 9);
+    vec.insert(vec.begin(), 2, 9);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    // Inserting an element of the vector into itself, which the gap moves
+    stdVec.insert(stdVec.begin(), stdVec[3]);
+    vec.insert(vec.begin(), vec[3]);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.insert(stdVec.begin() + 1, 2, stdVec[2]);
+    vec.insert(vec.begin() + 1, 2, vec[2]);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.erase(stdVec.begin() + 2, stdVec.begin() + 5);
+    vec.erase(vec.begin() + 2, vec.begin() + 5);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.resize(14, 5);
+    vec.resize(14, 5);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.resize(4);
+    vec.resize(4);
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    stdVec.pop_back();
+    vec.pop_back();
+    BOOST_REQUIRE(CompareStaticVectors(stdVec, vec));
+
+    BOOST_REQUIRE(vec.capacity() == 16);
+    vec.clear();
+    BOOST_REQUIRE(vec.empty());
+}
+
+BOOST_AUTO_TEST_CASE(static_vector_class_type)
+{
+    SketchStl::static_vector<SketchStl::string, 6> vec;
+    vec.push_back("alpha");
+    vec.push_back("beta");
+    vec.push_back("gamma");
+
+    vec.insert(vec.begin() + 1, 2, SketchStl::string("delta"));
+    BOOST_REQUIRE(vec.size() == 5 && vec.full() == false);
+    BOOST_REQUIRE(vec[0] == "alpha" && vec[1] == "delta" && vec[2] == "delta" && vec[3] == "beta" && vec[4] == "gamma");
+
+    SketchStl::static_vector<SketchStl::string, 6> copyVec(vec);
+    vec.erase(vec.begin());
+    vec.unordered_erase(vec.begin());
+    BOOST_REQUIRE(vec.size() == 3 && vec[0] == "gamma" && vec[1] == "delta" && vec[2] == "beta");
+
+    BOOST_REQUIRE(copyVec.size() == 5 && copyVec[4] == "gamma");
+    copyVec = vec;
+    BOOST_REQUIRE(copyVec.size() == 3 && copyVec[2] == "beta");
+
+    copyVec.insert(copyVec.begin(), copyVec[1]);
+    BOOST_REQUIRE(copyVec.size() == 4 && copyVec[0] == "delta" && copyVec[1] == "gamma" && copyVec[2] == "delta");
+}
+
+struct CopyCounter {
+    CopyCounter(int v) : value(v) {}
+    CopyCounter(const CopyCounter& src) : value(src.value) { copies++; }
+    CopyCounter(CopyCounter&& src) noexcept : value(src.value) { moves++; }
+    CopyCounter& operator=(const CopyCounter& rhs) { value = rhs.value; copies++; return *this; }
+    CopyCounter& operator=(CopyCounter&& rhs) noexcept { value = rhs.value; moves++; return *this; }
+
+    int value;
+    static int copies, moves;
+};
+int CopyCounter::copies = 0;
+int CopyCounter::moves = 0;
+
+static_assert(std::is_nothrow_move_constructible<SketchStl::static_vector<CopyCounter, 8>>::value, "Moving must not throw");
+
+BOOST_AUTO_TEST_CASE(static_vector_move)
+{
+    SketchStl::static_vector<CopyCounter, 8> vec;
+    for (int i = 0; i < 4; i++) {
+        vec.push_back(CopyCounter(i));
+    }
+
+    // The elements are moved one by one and the source is left empty
+    CopyCounter::copies = CopyCounter::moves = 0;
+    SketchStl::static_vector<CopyCounter, 8> moved(std::move(vec));
+    BOOST_REQUIRE(CopyCounter::copies == 0 && CopyCounter::moves == 4);
+
+    SketchStl::static_vector<CopyCounter, 8> assigned;
+    assigned.push_back(CopyCounter(-1));
+    CopyCounter::moves = 0;
+    assigned = std::move(moved);
+    BOOST_REQUIRE(CopyCounter::copies == 0 && CopyCounter::moves == 4);
+    BOOST_REQUIRE(vec.empty() && moved.empty());
+    BOOST_REQUIRE(assigned.size() == 4 && assigned[0].value == 0 && assigned[3].value == 3);
+
+    // Move-only elements
+    SketchStl::static_vector<std::unique_ptr<int>, 4> owners;
+    owners.push_back(std::unique_ptr<int>(new int(7)));
+    SketchStl::static_vector<std::unique_ptr<int>, 4> taken(std::move(owners));
+    BOOST_REQUIRE(owners.empty() && taken.size() == 1 && *taken[0] == 7);
+    owners = std::move(taken);
+    BOOST_REQUIRE(taken.empty() && owners.size() == 1 && *owners[0] == 7);
+}
+
+struct DefaultCounter {
+    DefaultCounter() : value(0) { constructions++; }
+    DefaultCounter(int v) : value(v) {}
+
+    int value;
+    static int constructions;
+};
+int DefaultCounter::constructions = 0;
+
+BOOST_AUTO_TEST_CASE(static_vector_no_default_construction)
+{
+    // Only the elements actually added are constructed, even when T has a default constructor
+    DefaultCounter::constructions = 0;
+    SketchStl::static_vector<DefaultCounter, 1000> vec;
+    vec.push_back(DefaultCounter(3));
+    BOOST_REQUIRE(DefaultCounter::constructions == 0);
+
+    // resize copies a single default value
+    vec.resize(4);
+    BOOST_REQUIRE(DefaultCounter::constructions == 1);
+    BOOST_REQUIRE(vec.size() == 4 && vec[0].value == 3 && vec[3].value == 0);
+}
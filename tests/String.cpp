@@ -2,6 +2,7 @@
 
 #include "sketch_string.h"
 #include <string>
+#include <type_traits>
 
 void CompareStr(const std::string& stdString, const SketchStl::string& string, const char* c_string) {
     size_t size = 0;
@@ -756,6 +757,72 @@ BOOST_AUTO_TEST_CASE(string_swap)
     CompareStr(stdStringWorld, stringWorld, "Hello");
 }
 
+BOOST_AUTO_TEST_CASE(string_move)
+{
+    SketchStl::string src = "Hello";
+    const char* buffer = src.c_str();
+
+    SketchStl::string string(std::move(src));
+    CompareStr(std::string("Hello"), string, "Hello");
+    BOOST_REQUIRE(string.c_str() == buffer);
+    CompareStr(std::string(), src, "");
+
+    SketchStl::string other = "World";
+    const char* otherBuffer = other.c_str();
+    string = std::move(other);
+    CompareStr(std::string("World"), string, "World");
+    BOOST_REQUIRE(string.c_str() == otherBuffer);
+
+    other += " reused";
+    BOOST_REQUIRE(strcmp(other.c_str() + other.length() - 6, "reused") == 0);
+
+    // A moved-from string holds no buffer and works like any empty string
+    static_assert(std::is_nothrow_move_constructible<SketchStl::string>::value, "moves never allocate");
+    SketchStl::string taken(std::move(string));
+    BOOST_REQUIRE(string.capacity() == 0 && string.empty() && string.data()[0] == '\0');
+    BOOST_REQUIRE(string == "" && SketchStl::string(string).empty());
+    string.push_back('a');
+    string += "bc";
+    CompareStr(std::string("abc"), string, "abc");
+
+    SketchStl::string inserted(std::move(taken));
+    taken.insert(0, "xy");
+    CompareStr(std::string("xy"), taken, "xy");
+    taken = std::move(inserted);
+    taken.reserve(10);
+    CompareStr(std::string("World"), taken, "World");
+}
+
+BOOST_AUTO_TEST_CASE(string_adopt_and_release)
+{
+    char* buffer = (char*)malloc(16);
+    memcpy(buffer, "Payload", 7);
+
+    std::string stdString = "Payload";
+    SketchStl::string string = "Hello";
+    string.adopt(buffer, 7, 16);
+
+    CompareStr(stdString, string, "Payload");
+    BOOST_REQUIRE(string.c_str() == buffer);
+    BOOST_REQUIRE(string.capacity() == 16);
+
+    string += " appended";
+    stdString += " appended";
+    CompareStr(stdString, string, "Payload appended");
+
+    size_t length = string.length();
+    char* released = string.release();
+    BOOST_REQUIRE(length == 16);
+    BOOST_REQUIRE(strcmp(released, "Payload appended") == 0);
+    free(released);
+
+    CompareStr(std::string(), string, "");
+    BOOST_REQUIRE(string.release() == nullptr);
+
+    string = "Reused";
+    CompareStr(std::string("Reused"), string, "Reused");
+}
+
 BOOST_AUTO_TEST_CASE(string_copy)
 {
     std::string stdString = "Hello world to all";
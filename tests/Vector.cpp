@@ -2,6 +2,10 @@
 #include <boost/test/unit_test.hpp>
 
 #include "sketch_vector.h"
+#include <algorithm>
+#include <list>
+#include <sstream>
+#include <string>
 #include <vector>
 
 struct ConstructorComparison {
@@ -1442,4 +1446,434 @@ BOOST_AUTO_TEST_CASE(vector_class_pointer_clear)
     vec.clear();
 
     BOOST_REQUIRE(CompareVectorsClassPointer(stdVec, vec));
-}
\ No newline at end of file
+}
+/////////////////////////////////////////////////////////////////////////
+// TESTS WITH ALIGNED STORAGE
+BOOST_AUTO_TEST_CASE(vector_aligned_push_back)
+{
+    std::vector<float> stdVec;
+    SketchStl::aligned_vector<float, 64> vec;
+
+    for (size_t i = 0; i < 100; i++) {
+        stdVec.push_back((float)i);
+        vec.push_back((float)i);
+
+        BOOST_REQUIRE(((size_t)vec.data() % 64) == 0);
+        BOOST_REQUIRE((vec.capacity() % 16) == 0);
+    }
+
+    BOOST_REQUIRE(stdVec.size() == vec.size());
+    for (size_t i = 0; i < stdVec.size(); i++) {
+        BOOST_REQUIRE(stdVec[i] == vec[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(vector_aligned_resize_and_reserve)
+{
+    SketchStl::aligned_vector<double, 32> vec(3, 1.0);
+    BOOST_REQUIRE(((size_t)vec.data() % 32) == 0);
+
+    vec.reserve(37);
+    BOOST_REQUIRE(((size_t)vec.data() % 32) == 0);
+    BOOST_REQUIRE(vec.capacity() == 40);
+
+    vec.resize(101, 2.0);
+    BOOST_REQUIRE(((size_t)vec.data() % 32) == 0);
+    BOOST_REQUIRE((vec.capacity() % 4) == 0);
+    BOOST_REQUIRE(vec[0] == 1.0 && vec[2] == 1.0 && vec[3] == 2.0 && vec[100] == 2.0);
+
+    SketchStl::aligned_vector<double, 32> copyVec(vec);
+    BOOST_REQUIRE(((size_t)copyVec.data() % 32) == 0);
+    BOOST_REQUIRE(copyVec.size() == 101 && copyVec[100] == 2.0);
+}
+
+/////////////////////////////////////////////////////////////////////////
+// TESTS WITH FOREIGN RANGES
+BOOST_AUTO_TEST_CASE(vector_append_buffer)
+{
+    int buffer[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    std::vector<int> stdVec;
+    SketchStl::vector<int> vec;
+
+    for (size_t i = 0; i < 3; i++) {
+        stdVec.insert(stdVec.end(), buffer, buffer + 10);
+        vec.append(buffer, 10);
+    }
+
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    vec.append(buffer, 0);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+}
+
+BOOST_AUTO_TEST_CASE(vector_assign_foreign_ranges)
+{
+    int buffer[] = { 4, 3, 2, 1, 0 };
+    std::list<int> list(buffer, buffer + 5);
+    std::vector<int> stdVec(buffer, buffer + 5);
+
+    SketchStl::vector<int> pointerVec(buffer, buffer + 5);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, pointerVec));
+
+    SketchStl::vector<int> listVec;
+    listVec.assign(list.begin(), list.end());
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, listVec));
+
+    std::istringstream stream("4 3 2 1 0");
+    SketchStl::vector<int> streamVec((std::istream_iterator<int>(stream)), std::istream_iterator<int>());
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, streamVec));
+
+    SketchStl::vector<int> stdIteratorVec(stdVec.begin(), stdVec.end());
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, stdIteratorVec));
+}
+
+BOOST_AUTO_TEST_CASE(vector_insert_foreign_ranges)
+{
+    int buffer[] = { 10, 11, 12 };
+    std::list<int> list(buffer, buffer + 3);
+
+    std::vector<int> stdVec;
+    SketchStl::vector<int> vec;
+
+    for (size_t i = 0; i < 5; i++) {
+        stdVec.push_back(i);
+        vec.push_back(i);
+    }
+
+    stdVec.insert(stdVec.begin() + 2, list.begin(), list.end());
+    vec.insert(vec.begin() + 2, list.begin(), list.end());
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    stdVec.insert(stdVec.begin(), buffer, buffer + 3);
+    vec.insert(vec.begin(), buffer, buffer + 3);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    std::istringstream stream("20 21");
+    std::istringstream stdStream("20 21");
+    stdVec.insert(stdVec.end(), std::istream_iterator<int>(stdStream), std::istream_iterator<int>());
+    vec.insert(vec.end(), std::istream_iterator<int>(stream), std::istream_iterator<int>());
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+}
+
+BOOST_AUTO_TEST_CASE(vector_insert_foreign_ranges_class)
+{
+    std::list<StdFoo> stdList;
+    std::list<Foo> list;
+    for (int i = 0; i < 4; i++) {
+        stdList.push_back(StdFoo(i));
+        list.push_back(Foo(i));
+    }
+
+    std::vector<StdFoo> stdVec(3, StdFoo(7));
+    SketchStl::vector<Foo> vec(3, Foo(7));
+
+    stdVec.insert(stdVec.begin() + 1, stdList.begin(), stdList.end());
+    vec.insert(vec.begin() + 1, list.begin(), list.end());
+    BOOST_REQUIRE(CompareVectorsClassType(stdVec, vec));
+
+    stdVec.assign(stdList.begin(), stdList.end());
+    vec.assign(list.begin(), list.end());
+    BOOST_REQUIRE(CompareVectorsClassType(stdVec, vec));
+}
+
+/////////////////////////////////////////////////////////////////////////
+// TESTS WITH ADOPTED BUFFERS
+BOOST_AUTO_TEST_CASE(vector_adopt_and_release)
+{
+    int* buffer = (int*)SketchStl::allocator::allocate(8 * sizeof(int));
+    for (int i = 0; i < 5; i++) {
+        buffer[i] = i;
+    }
+
+    std::vector<int> stdVec;
+    for (int i = 0; i < 5; i++) {
+        stdVec.push_back(i);
+    }
+
+    SketchStl::vector<int> vec(3, 1);
+    vec.adopt(buffer, 5, 8);
+
+    BOOST_REQUIRE(vec.data() == buffer);
+    BOOST_REQUIRE(vec.capacity() == 8);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    for (int i = 5; i < 20; i++) {
+        stdVec.push_back(i);
+        vec.push_back(i);
+    }
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    size_t size = vec.size();
+    int* released = vec.release();
+    BOOST_REQUIRE(size == 20);
+    BOOST_REQUIRE(released[0] == 0 && released[19] == 19);
+    SketchStl::allocator::deallocate(released);
+
+    BOOST_REQUIRE(vec.empty() && vec.capacity() == 0);
+
+    vec.push_back(42);
+    BOOST_REQUIRE(vec.size() == 1 && vec[0] == 42);
+}
+
+BOOST_AUTO_TEST_CASE(vector_adopt_aligned)
+{
+    typedef SketchStl::aligned_vector<float, 64> FloatVector;
+
+    float* buffer = (float*)FloatVector::allocator_type::allocate(32 * sizeof(float));
+    for (int i = 0; i < 32; i++) {
+        buffer[i] = (float)i;
+    }
+
+    FloatVector vec;
+    vec.adopt(buffer, 32, 32);
+    BOOST_REQUIRE(vec.size() == 32 && vec[31] == 31.0f);
+
+    vec.push_back(32.0f);
+    BOOST_REQUIRE(((size_t)vec.data() % 64) == 0);
+    BOOST_REQUIRE(vec.size() == 33 && vec[32] == 32.0f);
+}
+
+/////////////////////////////////////////////////////////////////////////
+// TESTS WITH COMPACT HEADERS
+BOOST_AUTO_TEST_CASE(vector_compact_layout)
+{
+    BOOST_REQUIRE(sizeof(SketchStl::compact_vector<int>) == sizeof(int*) + 2 * sizeof(uint32_t));
+    BOOST_REQUIRE(sizeof(SketchStl::vector<int>) == sizeof(int*) + 2 * sizeof(size_t));
+
+    std::vector<int> stdVec;
+    SketchStl::compact_vector<int> vec;
+
+    for (int i = 0; i < 100; i++) {
+        stdVec.push_back(i);
+        vec.push_back(i);
+    }
+
+    stdVec.insert(stdVec.begin() + 10, 3, -1);
+    vec.insert(vec.begin() + 10, 3, -1);
+    stdVec.erase(stdVec.begin() + 50, stdVec.begin() + 60);
+    vec.erase(vec.begin() + 50, vec.begin() + 60);
+
+    BOOST_REQUIRE(stdVec.size() == vec.size());
+    size_t i = 0;
+    for (SketchStl::compact_vector<int>::iterator it = vec.begin(); it != vec.end(); ++it, i++) {
+        BOOST_REQUIRE(stdVec[i] == *it);
+    }
+    BOOST_REQUIRE(i == stdVec.size());
+}
+
+BOOST_AUTO_TEST_CASE(vector_compact_capacity_limit)
+{
+    // Doubling the capacity past what SizeType can count stops at its largest value instead of wrapping around
+    SketchStl::vector<int, SketchStl::allocator, uint8_t> vec;
+    for (int i = 0; i < 255; i++) {
+        vec.push_back(i);
+    }
+    BOOST_REQUIRE(vec.size() == 255 && vec.capacity() == 255);
+
+    for (int i = 0; i < 255; i++) {
+        BOOST_REQUIRE(vec[i] == i);
+    }
+
+    SketchStl::vector<int, SketchStl::allocator, uint8_t> filled(200, 7);
+    BOOST_REQUIRE(filled.size() == 200 && filled.capacity() == 255);
+    filled.resize(250, 8);
+    filled.assign(130, 9);
+    BOOST_REQUIRE(filled.size() == 130 && filled.capacity() == 255 && filled[129] == 9);
+}
+
+/////////////////////////////////////////////////////////////////////////
+// TESTS WITH UNORDERED AND PREDICATE ERASURE
+bool IsOdd(int val) {
+    return (val % 2) != 0;
+}
+
+bool IsMultipleOfThree(const Foo& foo) {
+    return (foo.val_ % 3) == 0;
+}
+
+BOOST_AUTO_TEST_CASE(vector_unordered_erase)
+{
+    SketchStl::vector<int> vec;
+    for (int i = 0; i < 5; i++) {
+        vec.push_back(i);
+    }
+
+    SketchStl::vector<int>::iterator it = vec.unordered_erase(vec.begin() + 1);
+    BOOST_REQUIRE(*it == 4);
+    BOOST_REQUIRE(vec.size() == 4);
+    BOOST_REQUIRE(vec[0] == 0 && vec[1] == 4 && vec[2] == 2 && vec[3] == 3);
+
+    vec.unordered_erase(vec.end() - 1);
+    BOOST_REQUIRE(vec.size() == 3);
+    BOOST_REQUIRE(vec[0] == 0 && vec[1] == 4 && vec[2] == 2);
+}
+
+BOOST_AUTO_TEST_CASE(vector_value_type_erase_if)
+{
+    std::vector<int> stdVec;
+    SketchStl::vector<int> vec;
+
+    for (int i = 0; i < 20; i++) {
+        stdVec.push_back(i);
+        vec.push_back(i);
+    }
+
+    stdVec.erase(std::remove_if(stdVec.begin(), stdVec.end(), IsOdd), stdVec.end());
+    size_t erased = vec.erase_if(IsOdd);
+
+    BOOST_REQUIRE(erased == 10);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    BOOST_REQUIRE(vec.erase_if(IsOdd) == 0);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+}
+
+BOOST_AUTO_TEST_CASE(vector_value_class_erase_if)
+{
+    std::vector<StdFoo> stdVec;
+    SketchStl::vector<Foo> vec;
+
+    for (int i = 0; i < 10; i++) {
+        stdVec.push_back(StdFoo(i));
+        vec.push_back(Foo(i));
+    }
+
+    for (std::vector<StdFoo>::iterator it = stdVec.begin(); it != stdVec.end();) {
+        it = (it->val_ % 3) == 0 ? stdVec.erase(it) : it + 1;
+    }
+    vec.erase_if(IsMultipleOfThree);
+
+    BOOST_REQUIRE(CompareVectorsClassType(stdVec, vec));
+}
+
+/////////////////////////////////////////////////////////////////////////
+// TESTS WITH MOVED VECTORS
+BOOST_AUTO_TEST_CASE(vector_move_constructor)
+{
+    SketchStl::vector<int> src;
+    for (int i = 0; i < 10; i++) {
+        src.push_back(i);
+    }
+    const int* data = src.data();
+
+    SketchStl::vector<int> vec(std::move(src));
+    BOOST_REQUIRE(vec.data() == data);
+    BOOST_REQUIRE(vec.size() == 10 && vec[9] == 9);
+    BOOST_REQUIRE(src.empty() && src.capacity() == 0);
+
+    // A moved-from vector can be reused
+    src.push_back(42);
+    BOOST_REQUIRE(src.size() == 1 && src[0] == 42);
+}
+
+BOOST_AUTO_TEST_CASE(vector_move_assignment)
+{
+    std::vector<StdFoo> stdVec;
+    SketchStl::vector<Foo> vec;
+    SketchStl::vector<Foo> src;
+
+    for (int i = 0; i < 5; i++) {
+        stdVec.push_back(StdFoo(i));
+        vec.push_back(Foo(-i));
+        src.push_back(Foo(i));
+    }
+    const Foo* data = src.data();
+
+    vec = std::move(src);
+    BOOST_REQUIRE(vec.data() == data);
+    BOOST_REQUIRE(CompareVectorsClassType(stdVec, vec));
+    BOOST_REQUIRE(src.empty());
+}
+
+BOOST_AUTO_TEST_CASE(vector_of_vectors)
+{
+    // Growing the outer vector moves the inner arrays instead of copying them
+    SketchStl::vector<SketchStl::vector<int>> vec;
+    SketchStl::vector<const int*> buffers;
+
+    for (int i = 0; i < 20; i++) {
+        vec.push_back(SketchStl::vector<int>(3, i));
+        buffers.push_back(vec.back().data());
+    }
+    vec.insert(vec.begin(), SketchStl::vector<int>(1, -1));
+
+    BOOST_REQUIRE(vec.size() == 21 && vec[0][0] == -1);
+    for (int i = 0; i < 20; i++) {
+        BOOST_REQUIRE(vec[i + 1].data() == buffers[i]);
+        BOOST_REQUIRE(vec[i + 1].size() == 3 && vec[i + 1][2] == i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(vector_insert_own_range)
+{
+    // The range comes from the vector itself, which reallocates or moves it while inserting
+    std::vector<int> stdVec;
+    SketchStl::vector<int> vec;
+    for (int i = 0; i < 4; i++) {
+        stdVec.push_back(i);
+        vec.push_back(i);
+    }
+
+    stdVec.insert(stdVec.end(), stdVec.begin(), stdVec.end());
+    vec.append(vec.data(), vec.size());
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    vec.reserve(64);
+    stdVec.insert(stdVec.begin() + 1, stdVec.begin() + 2, stdVec.begin() + 6);
+    vec.insert(vec.begin() + 1, vec.begin() + 2, vec.begin() + 6);
+    BOOST_REQUIRE(CompareVectorsValueType(stdVec, vec));
+
+    std::vector<StdFoo> stdFoos;
+    SketchStl::vector<Foo> foos;
+    for (int i = 0; i < 3; i++) {
+        stdFoos.push_back(i);
+        foos.push_back(i);
+    }
+
+    stdFoos.insert(stdFoos.begin(), stdFoos.begin(), stdFoos.end());
+    foos.insert(foos.begin(), foos.begin(), foos.end());
+    BOOST_REQUIRE(CompareVectorsClassType(stdFoos, foos));
+}
+
+BOOST_AUTO_TEST_CASE(vector_push_back_own_element)
+{
+    // Every push lands on a full array, so the element is read after the old array would have been freed
+    SketchStl::vector<std::string> vec;
+    vec.push_back("first element, long enough to live on the heap");
+    for (size_t i = 0; i < 6; i++) {
+        while (vec.size() < vec.capacity()) {
+            vec.push_back(vec.back());
+        }
+        if (i % 2 == 0) {
+            vec.push_back(vec[0]);
+        } else {
+            vec.push_back(std::move(vec[0]));
+            vec[0] = vec[1];
+        }
+    }
+
+    for (size_t i = 0; i < vec.size(); i++) {
+        BOOST_REQUIRE(vec[i] == "first element, long enough to live on the heap");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(vector_insert_nothing)
+{
+    // Inserting no element leaves every element where it is
+    SketchStl::vector<std::string> vec;
+    for (int i = 0; i < 3; i++) {
+        vec.push_back(std::string(40, (char)('a' + i)));
+    }
+
+    std::list<std::string> empty;
+    vec.insert(vec.begin(), (size_t)0, std::string("x"));
+    vec.insert(vec.begin() + 1, empty.begin(), empty.end());
+    vec.insert(vec.end(), vec.begin(), vec.begin());
+    vec.append(vec.data(), 0);
+
+    BOOST_REQUIRE(vec.size() == 3);
+    for (int i = 0; i < 3; i++) {
+        BOOST_REQUIRE(vec[i] == std::string(40, (char)('a' + i)));
+    }
+}